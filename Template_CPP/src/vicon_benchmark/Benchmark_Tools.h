@@ -0,0 +1,94 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Shared helpers for the benchmarks in this folder
+		Synthetic frames, so that benchmarks can run without a Vicon system
+		Timing
+
+*/
+#pragma once
+
+// Standard library
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+// Brandon's VDS Interface
+#include "VDS_Interface.h"
+
+
+namespace bench
+{
+	using Clock = std::chrono::steady_clock;
+
+	// OUTPUT: Nanoseconds elapsed since t0
+	inline double ElapsedNs(Clock::time_point t0)
+	{
+		return std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+	}
+
+	// OUTPUT: The p'th percentile of samples (p in [0,100]). Reorders samples
+	inline double Percentile(std::vector<double>& samples, double p)
+	{
+		if(samples.empty()) { return vdsi::NaN; }
+		size_t idx = std::min(samples.size() - 1, size_t(p / 100.0 * double(samples.size())));
+		std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+		return samples[idx];
+	}
+
+	// Prevent the optimiser from discarding a result
+	//	GCC / Clang: an empty asm that may read the value (no pointer is kept)
+	//	Otherwise: a volatile write of its address, cleared again so that no pointer to a local outlives the call
+#if defined(__GNUC__) || defined(__clang__)
+	template<class T>
+	inline void DoNotOptimise(const T& value)
+	{
+		asm volatile("" : : "g"(&value) : "memory");
+	}
+#else
+	inline const volatile void* volatile Sink = nullptr;
+	template<class T>
+	inline void DoNotOptimise(const T& value)
+	{
+		Sink = &value;
+		Sink = nullptr;
+	}
+#endif
+
+	// PURPOSE:
+	//	Build a frame of the same shape as DecodeFrame() produces
+	//	Names are long enough to defeat small string optimisation, like real Tracker names often are
+	// INPUT:
+	//	numSubjects = number of objects
+	//	numMarkers = number of markers per object
+	inline vdsi::Points MakeSyntheticFrame(unsigned int numSubjects, unsigned int numMarkers, unsigned int frameNumber = 1)
+	{
+		vdsi::Points frame;
+		frame.BeginRefill(frameNumber);
+		for(unsigned int idxS = 0; idxS < numSubjects; ++idxS)
+		{
+			double offset = 1000.0 * idxS;
+			vdsi::RotationMatrix R = { 1,0,0, 0,1,0, 0,0,1 };
+			vdsi::Translation P = { offset + 1, offset + 2, offset + 3 };
+
+			// Handle ids match the subject index, as if interned in this order
+			vdsi::Point_Object& point = frame.RefillNext();
+			point.Reset("synthetic_subject_" + std::to_string(idxS), R, P, false, vdsi::SubjectHandle{idxS});
+			for(unsigned int idxM = 0; idxM < numMarkers; ++idxM)
+			{
+				vdsi::Translation PM = { P[0] + idxM, P[1], P[2] };
+				point.AddMarker(vdsi::Point_Marker("synthetic_marker_" + std::to_string(idxM), PM, false));
+			}
+		}
+		frame.EndRefill();
+		return frame;
+	}
+}
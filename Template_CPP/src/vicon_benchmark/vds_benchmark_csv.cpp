@@ -0,0 +1,144 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Benchmark the number formatting of ExportCSV::PrintAll()
+		Rows of 12 columns (one object pose) to 600 columns (e.g. 50 objects, or fewer objects with markers)
+		Output goes to a stream that discards it, so disk speed is not measured
+
+	Methods compared:
+		iostream_6 = the previous PrintAll: outStream << value << "," and std::endl per row (6 significant digits, lossy)
+		iostream_17 = as above, with 17 significant digits (lossless)
+		to_chars_6 = ExportCSV with SetPrecision(6)
+		to_chars_rt = ExportCSV default: shortest round-trip (lossless)
+
+Sample call:
+	./vds_benchmark_csv
+	./vds_benchmark_csv 5000000
+
+Inputs:
+	arg1 = number of values printed per measurement (default 2000000)
+
+*/
+// Program output
+#include <iostream>
+#include <iomanip>
+
+// Other
+#include <random>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// Brandon's VDS Interface
+#include "CSV_Exporter.h"
+#include "Benchmark_Tools.h"
+
+
+namespace
+{
+	// Output stream that counts and discards everything
+	class NullBuffer : public std::streambuf
+	{
+	public:
+		uint64_t numBytes = 0;
+	protected:
+		int overflow(int c) override { this->numBytes++; return c; }
+		std::streamsize xsputn(const char*, std::streamsize n) override { this->numBytes += n; return n; }
+	};
+
+	// Rows with the value ranges of real data: rotation matrix elements in [-1,1], positions in mm across a large room
+	std::vector< std::vector<double> > MakeRows(size_t numColumns, size_t numRows)
+	{
+		std::mt19937 rng(42);
+		std::uniform_real_distribution<double> rotation(-1.0, 1.0);
+		std::uniform_real_distribution<double> position(-5000.0, 5000.0);
+
+		std::vector< std::vector<double> > rows(numRows, std::vector<double>(numColumns));
+		for(auto& row : rows)
+		{
+			for(size_t idx = 0; idx < numColumns; ++idx)
+			{
+				row[idx] = (idx % 12 < 9) ? rotation(rng) : position(rng);
+			}
+		}
+		return rows;
+	}
+
+	void Report(const std::string& label, size_t numColumns, size_t numRows, double ns, uint64_t numBytes)
+	{
+		std::cout << std::fixed << std::setprecision(1)
+			<< std::setw(8) << numColumns
+			<< std::setw(10) << numRows
+			<< "  " << std::left << std::setw(14) << label << std::right
+			<< std::setw(12) << double(numRows) / (ns / 1e9) / 1e3
+			<< std::setw(12) << double(numBytes) / (ns / 1e9) / 1e6
+			<< std::setw(12) << ns / double(numRows * numColumns)
+			<< std::endl;
+	}
+
+	void Measure_iostream(const std::string& label, int precision, const std::vector< std::vector<double> >& rows)
+	{
+		NullBuffer buffer;
+		std::ostream outStream(&buffer);
+		outStream << std::setprecision(precision);
+
+		auto t0 = bench::Clock::now();
+		for (auto& row : rows)
+		{
+			for (auto& value : row)
+			{
+				outStream << value << ",";
+			}
+			outStream << std::endl;
+		}
+		double ns = bench::ElapsedNs(t0);
+		Report(label, rows.front().size(), rows.size(), ns, buffer.numBytes);
+	}
+
+	void Measure_ExportCSV(const std::string& label, int precision, const std::vector< std::vector<double> >& rows)
+	{
+		csv_exporter::ExportCSV ExportCSV(rows.size());
+		ExportCSV.SetPrecision(precision);
+		for (auto& row : rows) { ExportCSV.AddRow(row); }
+
+		// Warm up the reused buffer, as in a recording loop
+		NullBuffer warmUp;
+		std::ostream warmUpStream(&warmUp);
+		ExportCSV.PrintAll(warmUpStream);
+
+		NullBuffer buffer;
+		std::ostream outStream(&buffer);
+		auto t0 = bench::Clock::now();
+		ExportCSV.PrintAll(outStream);
+		double ns = bench::ElapsedNs(t0);
+		Report(label, rows.front().size(), rows.size(), ns, buffer.numBytes);
+	}
+}
+
+
+int main( int argc, char* argv[] )
+{
+	size_t numValues = (argc > 1) ? std::stoul(argv[1]) : 2000000;
+
+	std::cout
+		<< std::setw(8) << "columns" << std::setw(10) << "rows" << "  " << std::left << std::setw(14) << "method" << std::right
+		<< std::setw(12) << "krows/s" << std::setw(12) << "MB/s" << std::setw(12) << "ns/value"
+		<< std::endl;
+
+	for(size_t numColumns : {12, 60, 120, 300, 600})
+	{
+		auto rows = MakeRows(numColumns, std::max<size_t>(1, numValues / numColumns));
+		Measure_iostream("iostream_6", 6, rows);
+		Measure_iostream("iostream_17", 17, rows);
+		Measure_ExportCSV("to_chars_6", 6, rows);
+		Measure_ExportCSV("to_chars_rt", csv_exporter::Precision_ShortestRoundTrip, rows);
+	}
+
+	return 0;
+}
@@ -0,0 +1,207 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Benchmark the handoff of the latest frame from the update thread to the readers
+		Mutex: the previous handoff (update thread and readers share one mutex)
+		TripleBuffer: the current handoff used by VDS_Interface
+
+	The producer publishes a synthetic frame at a fixed rate
+	The readers copy the latest frame in a tight loop (worst case contention)
+
+	Measured:
+		Producer stall = time the producer spends on one frame: decoding it (stood in by a copy of the frame), then handing it over
+			Both handoffs do the same work: the mutex one decodes into its own frame and copies it under the lock,
+			the triple buffer one decodes into the back buffer (as VDS_Interface does without an object filter)
+		Reader latency = time from the start of the decode to a reader holding a copy of that frame
+
+Sample call:
+	./vds_benchmark_handoff
+	./vds_benchmark_handoff 200 10 1000 2 1
+
+Inputs:
+	arg1 = number of subjects (default 200)
+	arg2 = number of markers per subject (default 10)
+	arg3 = producer rate [Hz] (default 1000)
+	arg4 = duration [s] (default 2)
+	arg5 = number of reader threads (default 1)
+
+*/
+// Program output
+#include <iostream>
+#include <iomanip>
+
+// Other
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Brandon's VDS Interface
+#include "VDS_Interface.h"
+#include "Benchmark_Tools.h"
+
+
+namespace
+{
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Handoff implementations under test
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Previous implementation of VDS_Interface
+	class Handoff_Mutex
+	{
+	private:
+		vdsi::Points DecodedFrame;
+		vdsi::Points LatestFrame;
+		std::mutex mtx_LatestFrame;
+	public:
+		// Stands in for DecodeFrame()
+		void Prepare(const vdsi::Points& frame) { this->DecodedFrame = frame; }
+
+		void Publish()
+		{
+			std::lock_guard<std::mutex> lock(this->mtx_LatestFrame);
+			this->LatestFrame = this->DecodedFrame;
+		}
+		void Read(vdsi::Points& frame)
+		{
+			std::lock_guard<std::mutex> lock(this->mtx_LatestFrame);
+			frame = this->LatestFrame;
+		}
+	};
+
+	// Current implementation of VDS_Interface
+	class Handoff_TripleBuffer
+	{
+	private:
+		vdsi::TripleBuffer<vdsi::Points> LatestFrame;
+		std::mutex mtx_Readers;
+	public:
+		// Stands in for DecodeFrame(), which writes straight into the back buffer
+		void Prepare(const vdsi::Points& frame) { this->LatestFrame.Back() = frame; }
+
+		void Publish() { this->LatestFrame.Publish(); }
+		void Read(vdsi::Points& frame)
+		{
+			std::lock_guard<std::mutex> lock(this->mtx_Readers);
+			this->LatestFrame.Update();
+			frame = this->LatestFrame.Front();
+		}
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Measurement
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	struct Settings
+	{
+		unsigned int numSubjects = 200;
+		unsigned int numMarkers = 10;
+		double rateHz = 1000;
+		double durationSeconds = 2;
+		unsigned int numReaders = 1;
+	};
+
+	template<class Handoff>
+	void Measure(const std::string& label, const Settings& settings)
+	{
+		Handoff handoff;
+		vdsi::Points source = bench::MakeSyntheticFrame(settings.numSubjects, settings.numMarkers);
+		handoff.Prepare(source);
+		handoff.Publish();
+
+		// Start time of the handoff of each frame, indexed by frame number
+		unsigned int numFrames = (unsigned int)(settings.rateHz * settings.durationSeconds);
+		std::vector<bench::Clock::time_point> handoffStart(numFrames + 2);
+		std::vector<double> producerStallNs;
+		producerStallNs.reserve(numFrames);
+
+		std::atomic<bool> IsKillRequest = false;
+		std::vector<std::vector<double>> readerLatencyNs(settings.numReaders);
+
+		// Readers: copy continuously, record latency of each newly seen frame
+		std::vector<std::thread> readers;
+		for(unsigned int idxR = 0; idxR < settings.numReaders; ++idxR)
+		{
+			readers.emplace_back([&, idxR] {
+				vdsi::Points frame;
+				unsigned int lastFrameNumber = source.frameNumber;
+				auto& latencies = readerLatencyNs[idxR];
+				latencies.reserve(numFrames);
+				while( ! IsKillRequest )
+				{
+					handoff.Read(frame);
+					if(frame.frameNumber != lastFrameNumber)
+					{
+						lastFrameNumber = frame.frameNumber;
+						latencies.push_back(bench::ElapsedNs(handoffStart[frame.frameNumber]));
+					}
+				}
+			});
+		}
+
+		// Producer: fixed rate
+		auto period = std::chrono::duration_cast<bench::Clock::duration>(std::chrono::duration<double>(1.0 / settings.rateHz));
+		auto nextPublish = bench::Clock::now();
+		for(unsigned int frameNumber = 2; frameNumber < numFrames + 2; ++frameNumber)
+		{
+			nextPublish += period;
+			while(bench::Clock::now() < nextPublish) { std::this_thread::yield(); }
+
+			source.frameNumber = frameNumber;
+			auto t0 = bench::Clock::now();
+			handoffStart[frameNumber] = t0;
+			handoff.Prepare(source);
+			handoff.Publish();
+			producerStallNs.push_back(bench::ElapsedNs(t0));
+		}
+
+		IsKillRequest = true;
+		for(auto& reader : readers) { reader.join(); }
+
+		// Merge readers
+		std::vector<double> latencies;
+		for(auto& samples : readerLatencyNs) { latencies.insert(latencies.end(), samples.begin(), samples.end()); }
+
+		std::cout << std::fixed << std::setprecision(1)
+			<< std::left << std::setw(14) << label << std::right
+			<< std::setw(12) << bench::Percentile(producerStallNs, 50) / 1000
+			<< std::setw(12) << bench::Percentile(producerStallNs, 99) / 1000
+			<< std::setw(12) << bench::Percentile(producerStallNs, 100) / 1000
+			<< std::setw(12) << bench::Percentile(latencies, 50) / 1000
+			<< std::setw(12) << bench::Percentile(latencies, 99) / 1000
+			<< std::setw(12) << bench::Percentile(latencies, 100) / 1000
+			<< std::endl;
+	}
+}
+
+
+int main( int argc, char* argv[] )
+{
+	Settings settings;
+	if(argc > 1) { settings.numSubjects = std::stoul(argv[1]); }
+	if(argc > 2) { settings.numMarkers = std::stoul(argv[2]); }
+	if(argc > 3) { settings.rateHz = std::stod(argv[3]); }
+	if(argc > 4) { settings.durationSeconds = std::stod(argv[4]); }
+	if(argc > 5) { settings.numReaders = std::stoul(argv[5]); }
+
+	std::cout
+		<< "Frame: " << settings.numSubjects << " subjects x " << settings.numMarkers << " markers, "
+		<< settings.rateHz << " Hz, " << settings.durationSeconds << " s, " << settings.numReaders << " reader(s)" << std::endl
+		<< "All times in microseconds" << std::endl;
+	std::cout
+		<< std::left << std::setw(14) << "Handoff" << std::right
+		<< std::setw(12) << "stall p50" << std::setw(12) << "stall p99" << std::setw(12) << "stall max"
+		<< std::setw(12) << "latency p50" << std::setw(12) << "latency p99" << std::setw(12) << "latency max"
+		<< std::endl;
+
+	Measure<Handoff_Mutex>("Mutex", settings);
+	Measure<Handoff_TripleBuffer>("TripleBuffer", settings);
+
+	return 0;
+}
@@ -0,0 +1,237 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Benchmark the storage of vdsi::Points
+		Heap allocations and time to copy one frame
+		Compares the old std::vector based pose storage against the current fixed size storage
+		Lookup of the last object in the frame: by name (Get) against by handle (Find)
+
+Sample call:
+	./vds_benchmark_points
+	./vds_benchmark_points 40 20
+
+Inputs:
+	arg1 = number of subjects (default 40)
+	arg2 = number of markers per subject (default 20)
+
+*/
+// Program output
+#include <iostream>
+#include <iomanip>
+
+// Other
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+// Brandon's VDS Interface
+#include "VDS_Interface.h"
+#include "Benchmark_Tools.h"
+
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Count heap allocations made by this program
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Every replaceable (throwing) new and delete is replaced, so that all of them go through the same malloc / free
+//	The nothrow forms call these by default
+namespace
+{
+	std::atomic<uint64_t> AllocationCount = 0;
+
+	void* CountedAlloc(std::size_t size)
+	{
+		AllocationCount.fetch_add(1, std::memory_order_relaxed);
+		if(void* ptr = std::malloc(size ? size : 1)) { return ptr; }
+		throw std::bad_alloc();
+	}
+
+	void* CountedAlloc(std::size_t size, std::align_val_t align)
+	{
+		AllocationCount.fetch_add(1, std::memory_order_relaxed);
+		std::size_t alignment = static_cast<std::size_t>(align);
+		std::size_t sizeRounded = (size + alignment - 1) / alignment * alignment; // aligned_alloc needs a multiple of the alignment
+#ifdef _WIN32
+		void* ptr = _aligned_malloc(sizeRounded ? sizeRounded : alignment, alignment);
+#else
+		void* ptr = std::aligned_alloc(alignment, sizeRounded ? sizeRounded : alignment);
+#endif
+		if(ptr) { return ptr; }
+		throw std::bad_alloc();
+	}
+
+	void CountedFree(void* ptr) noexcept { std::free(ptr); }
+
+	void CountedFree(void* ptr, std::align_val_t) noexcept
+	{
+#ifdef _WIN32
+		_aligned_free(ptr);
+#else
+		std::free(ptr);
+#endif
+	}
+}
+
+void* operator new(std::size_t size) { return CountedAlloc(size); }
+void* operator new[](std::size_t size) { return CountedAlloc(size); }
+void* operator new(std::size_t size, std::align_val_t align) { return CountedAlloc(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return CountedAlloc(size, align); }
+
+void operator delete(void* ptr) noexcept { CountedFree(ptr); }
+void operator delete[](void* ptr) noexcept { CountedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { CountedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { CountedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t align) noexcept { CountedFree(ptr, align); }
+void operator delete[](void* ptr, std::align_val_t align) noexcept { CountedFree(ptr, align); }
+void operator delete(void* ptr, std::size_t, std::align_val_t align) noexcept { CountedFree(ptr, align); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t align) noexcept { CountedFree(ptr, align); }
+
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// The previous layout of vdsi::Points (pose stored in std::vector)
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+namespace legacy
+{
+	struct Point
+	{
+		std::string viconObjectName;
+		std::vector<double> R_rowMajor = std::vector<double>(9, vdsi::NaN);
+		std::vector<double> P = std::vector<double>(3, vdsi::NaN);
+		bool IsOccluded = true;
+	};
+	struct Point_Marker : Point { };
+	struct Point_Object : Point { std::vector<Point_Marker> markers; };
+	struct Points
+	{
+		std::vector<Point_Object> all;
+		unsigned int frameNumber = 0;
+	};
+
+	Points FromCurrent(const vdsi::Points& current)
+	{
+		Points frame;
+		frame.frameNumber = current.frameNumber;
+		for(auto& point : current.all)
+		{
+			Point_Object object;
+			object.viconObjectName = point.viconObjectName;
+			object.R_rowMajor.assign(point.R_rowMajor.begin(), point.R_rowMajor.end());
+			object.P.assign(point.P.begin(), point.P.end());
+			object.IsOccluded = point.IsOccluded;
+			for(auto& marker : point.markers)
+			{
+				Point_Marker legacyMarker;
+				legacyMarker.viconObjectName = marker.viconObjectName;
+				legacyMarker.P.assign(marker.P.begin(), marker.P.end());
+				legacyMarker.IsOccluded = marker.IsOccluded;
+				object.markers.push_back(legacyMarker);
+			}
+			frame.all.push_back(object);
+		}
+		return frame;
+	}
+}
+
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Measurement
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+namespace
+{
+	constexpr int NumIterations = 2000;
+
+	// PURPOSE: Run copyOnce repeatedly and print the mean allocations and time per frame
+	template<typename Function>
+	void Measure(const std::string& label, Function copyOnce)
+	{
+		// Warm up (also lets reused storage reach its steady state size)
+		for(int idx = 0; idx < 10; ++idx) { copyOnce(); }
+
+		uint64_t allocations0 = AllocationCount.load();
+		auto t0 = bench::Clock::now();
+		for(int idx = 0; idx < NumIterations; ++idx) { copyOnce(); }
+		double ns = bench::ElapsedNs(t0);
+		uint64_t allocations = AllocationCount.load() - allocations0;
+
+		std::cout
+			<< std::left << std::setw(44) << label
+			<< std::right << std::setw(14) << std::fixed << std::setprecision(1) << double(allocations) / NumIterations
+			<< std::setw(16) << std::setprecision(0) << ns / NumIterations
+			<< std::endl;
+	}
+}
+
+
+int main( int argc, char* argv[] )
+{
+	unsigned int numSubjects = (argc > 1) ? std::stoul(argv[1]) : 40;
+	unsigned int numMarkers = (argc > 2) ? std::stoul(argv[2]) : 20;
+
+	if(numSubjects == 0) { std::cout << "ERROR: (Bad Input) need at least 1 subject" << std::endl; return 1; }
+	std::cout << "Frame: " << numSubjects << " subjects x " << numMarkers << " markers" << std::endl;
+	std::cout
+		<< std::left << std::setw(44) << "Case"
+		<< std::right << std::setw(14) << "allocs/frame"
+		<< std::setw(16) << "ns/frame"
+		<< std::endl;
+
+	vdsi::Points current = bench::MakeSyntheticFrame(numSubjects, numMarkers);
+	legacy::Points old = legacy::FromCurrent(current);
+
+	// Before: GetFrame() returned a new copy every call
+	Measure("legacy: copy construct (old GetFrame)", [&] {
+		legacy::Points copy(old);
+		bench::DoNotOptimise(copy);
+	});
+	legacy::Points oldReused;
+	Measure("legacy: copy assign (old LatestFrame update)", [&] {
+		oldReused = old;
+		bench::DoNotOptimise(oldReused);
+	});
+
+	// After
+	Measure("current: copy construct (GetFrame())", [&] {
+		vdsi::Points copy(current);
+		bench::DoNotOptimise(copy);
+	});
+	vdsi::Points currentReused;
+	Measure("current: copy assign (GetFrame(frame))", [&] {
+		currentReused = current;
+		bench::DoNotOptimise(currentReused);
+	});
+
+	// Refill as done by DecodeFrame()
+	vdsi::Points refilled;
+	Measure("current: refill in place (DecodeFrame)", [&] {
+		refilled.BeginRefill(current.frameNumber);
+		for(auto& point : current.all)
+		{
+			auto& slot = refilled.RefillNext();
+			slot.Reset(point.viconObjectName, point.R_rowMajor, point.P, point.IsOccluded);
+			for(auto& marker : point.markers) { slot.AddMarker(marker); }
+		}
+		refilled.EndRefill();
+		bench::DoNotOptimise(refilled);
+	});
+
+	// Lookup of one object (worst case for the linear search: last in the frame)
+	std::string lastName = current.all.back().viconObjectName;
+	vdsi::SubjectHandle lastHandle = current.all.back().handle;
+	Measure("lookup: Get(name) copy", [&] {
+		auto point = current.Get(lastName);
+		bench::DoNotOptimise(point);
+	});
+	Measure("lookup: Find(handle)", [&] {
+		auto point = current.Find(lastHandle);
+		bench::DoNotOptimise(point);
+	});
+
+	return 0;
+}
@@ -0,0 +1,169 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Benchmark many threads reading the latest frame of one VDS_Interface at once (e.g. controller, logger, visualiser)
+		Copy: TryGetFrame(frame) - readers take turns to copy the frame into their own Points
+		Shared: GetFrameShared() - readers take a reference to the same immutable snapshot
+
+	Frames come from FrameSource_Synthetic at a fixed rate
+	Each reader reads the latest frame in a tight loop (worst case contention), for 1 to N readers
+
+	Measured:
+		Reads per second, summed over the readers
+		Time per read
+		Update rate = frames decoded per second by the update thread (should stay at the source rate: readers must not slow it)
+			With fewer hardware threads than readers + 1, spinning readers also take CPU time from the update thread
+			(Copy readers sleep while waiting for the mutex, which hides this)
+
+Sample call:
+	./vds_benchmark_readers
+	./vds_benchmark_readers 50 5 1000 1 16
+
+Inputs:
+	arg1 = number of subjects (default 50)
+	arg2 = number of markers per subject (default 5)
+	arg3 = source rate [Hz] (default 1000)
+	arg4 = duration per case [s] (default 1)
+	arg5 = most reader threads (default 16)
+
+*/
+// Program output
+#include <iostream>
+#include <iomanip>
+
+// Other
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Brandon's VDS Interface
+#include "VDS_Interface.h"
+#include "Benchmark_Tools.h"
+
+
+namespace
+{
+	struct Settings
+	{
+		unsigned int numSubjects = 50;
+		unsigned int numMarkers = 5;
+		double rateHz = 1000;
+		double durationSeconds = 1;
+		unsigned int maxReaders = 16;
+	};
+
+	enum class Mode { Copy, Shared };
+
+	void Measure(Mode mode, unsigned int numReaders, const Settings& settings)
+	{
+		vdsi::SyntheticSettings source;
+		source.numSubjects = settings.numSubjects;
+		source.numMarkers = settings.numMarkers;
+		source.frameRateHz = settings.rateHz;
+
+		vdsi::VDS_Interface VDS;
+		VDS.Connect(std::make_unique<vdsi::FrameSource_Synthetic>(source));
+		if(mode == Mode::Shared) { VDS.GetFrameShared(); }
+
+		// Readers: read continuously, time a sample of the reads
+		constexpr size_t MaxSamples = 1 << 18;
+		std::atomic<bool> IsStart = false;
+		std::atomic<bool> IsKillRequest = false;
+		std::vector<uint64_t> numReads(numReaders, 0);
+		std::vector<std::vector<double>> readNs(numReaders);
+		std::vector<std::thread> readers;
+		for(unsigned int idxR = 0; idxR < numReaders; ++idxR)
+		{
+			readers.emplace_back([&, idxR] {
+				vdsi::Points frame;
+				auto& samples = readNs[idxR];
+				samples.reserve(MaxSamples);
+				uint64_t reads = 0;
+				while( ! IsStart ) { std::this_thread::yield(); }
+				while( ! IsKillRequest )
+				{
+					auto t0 = bench::Clock::now();
+					if(mode == Mode::Copy)
+					{
+						VDS.TryGetFrame(frame);
+						bench::DoNotOptimise(frame);
+					}
+					else
+					{
+						auto shared = VDS.GetFrameShared();
+						bench::DoNotOptimise(shared->all.size());
+					}
+					if(samples.size() < MaxSamples) { samples.push_back(bench::ElapsedNs(t0)); }
+					++reads;
+				}
+				numReads[idxR] = reads;
+			});
+		}
+
+		uint64_t framesDecoded0 = VDS.GetDecodeStats().framesDecoded;
+		auto t0 = bench::Clock::now();
+		IsStart = true;
+		std::this_thread::sleep_for(std::chrono::duration<double>(settings.durationSeconds));
+		IsKillRequest = true;
+		double seconds = bench::ElapsedNs(t0) * 1e-9;
+		uint64_t framesDecoded = VDS.GetDecodeStats().framesDecoded - framesDecoded0;
+		for(auto& reader : readers) { reader.join(); }
+		VDS.Disconnect();
+
+		// Merge readers
+		uint64_t totalReads = 0;
+		std::vector<double> samples;
+		for(unsigned int idxR = 0; idxR < numReaders; ++idxR)
+		{
+			totalReads += numReads[idxR];
+			samples.insert(samples.end(), readNs[idxR].begin(), readNs[idxR].end());
+		}
+
+		std::cout << std::fixed << std::setprecision(1)
+			<< std::left << std::setw(8) << (mode == Mode::Copy ? "Copy" : "Shared") << std::right
+			<< std::setw(8) << numReaders
+			<< std::setw(14) << double(totalReads) / seconds / 1e6
+			<< std::setw(12) << bench::Percentile(samples, 50)
+			<< std::setw(12) << bench::Percentile(samples, 99)
+			<< std::setw(14) << double(framesDecoded) / seconds
+			<< std::endl;
+	}
+}
+
+
+int main( int argc, char* argv[] )
+{
+	Settings settings;
+	if(argc > 1) { settings.numSubjects = std::stoul(argv[1]); }
+	if(argc > 2) { settings.numMarkers = std::stoul(argv[2]); }
+	if(argc > 3) { settings.rateHz = std::stod(argv[3]); }
+	if(argc > 4) { settings.durationSeconds = std::stod(argv[4]); }
+	if(argc > 5) { settings.maxReaders = std::stoul(argv[5]); }
+
+	std::cout
+		<< "Frame: " << settings.numSubjects << " subjects x " << settings.numMarkers << " markers, "
+		<< settings.rateHz << " Hz, " << settings.durationSeconds << " s per case" << std::endl
+		<< "Hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+	std::cout
+		<< std::left << std::setw(8) << "Mode" << std::right
+		<< std::setw(8) << "readers" << std::setw(14) << "Mreads/s" << std::setw(12) << "read p50 ns" << std::setw(12) << "read p99 ns"
+		<< std::setw(14) << "update Hz"
+		<< std::endl;
+
+	for(Mode mode : {Mode::Copy, Mode::Shared})
+	{
+		for(unsigned int numReaders = 1; numReaders <= settings.maxReaders; numReaders *= 2)
+		{
+			Measure(mode, numReaders, settings);
+		}
+	}
+	return 0;
+}
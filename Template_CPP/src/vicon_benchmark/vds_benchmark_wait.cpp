@@ -0,0 +1,117 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Benchmark the wait policies of GetFrame() (see vdsi::WaitPolicy)
+		A producer sets the frame ready signal at a fixed rate, like the update thread does
+		A consumer waits on the signal with each policy in turn
+
+	Measured:
+		Wake-up latency = time from the signal being set to the consumer returning from the wait
+		CPU load = process CPU time / wall time
+			The producer sleeps between frames, so this is dominated by the consumer
+
+Sample call:
+	./vds_benchmark_wait
+	./vds_benchmark_wait 200 2
+
+Inputs:
+	arg1 = producer rate [Hz] (default 200)
+	arg2 = duration per policy [s] (default 2)
+
+*/
+// Program output
+#include <iostream>
+#include <iomanip>
+
+// Other
+#include <atomic>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Brandon's VDS Interface
+#include "VDS_Interface.h"
+#include "Benchmark_Tools.h"
+
+
+namespace
+{
+	void Measure(const std::string& label, vdsi::WaitPolicy policy, double rateHz, double durationSeconds)
+	{
+		vdsi::FrameSignal FrameReady;
+		std::atomic<int64_t> setTimeNs = 0;
+		std::atomic<bool> IsKillRequest = false;
+
+		unsigned int numFrames = (unsigned int)(rateHz * durationSeconds);
+		std::vector<double> latencyNs;
+		latencyNs.reserve(numFrames);
+
+		auto tWall0 = bench::Clock::now();
+		std::clock_t tCpu0 = std::clock();
+
+		// Consumer: same pattern as GetFrame_WaitForNew()
+		std::thread consumer([&] {
+			while( ! IsKillRequest )
+			{
+				if( ! FrameReady.Wait(policy, std::chrono::milliseconds(100)) ) { continue; }
+				int64_t tWake = bench::Clock::now().time_since_epoch().count();
+				latencyNs.push_back(double(tWake - setTimeNs));
+				FrameReady.Clear();
+			}
+		});
+
+		// Producer: fixed rate
+		auto period = std::chrono::duration_cast<bench::Clock::duration>(std::chrono::duration<double>(1.0 / rateHz));
+		auto nextSet = bench::Clock::now();
+		for(unsigned int idx = 0; idx < numFrames; ++idx)
+		{
+			nextSet += period;
+			std::this_thread::sleep_until(nextSet);
+			setTimeNs = bench::Clock::now().time_since_epoch().count();
+			FrameReady.Set();
+		}
+
+		IsKillRequest = true;
+		consumer.join();
+
+		double cpuSeconds = double(std::clock() - tCpu0) / CLOCKS_PER_SEC;
+		double wallSeconds = bench::ElapsedNs(tWall0) / 1e9;
+
+		std::cout << std::fixed << std::setprecision(1)
+			<< std::left << std::setw(12) << label << std::right
+			<< std::setw(10) << latencyNs.size()
+			<< std::setw(14) << bench::Percentile(latencyNs, 50) / 1000
+			<< std::setw(14) << bench::Percentile(latencyNs, 99) / 1000
+			<< std::setw(14) << bench::Percentile(latencyNs, 100) / 1000
+			<< std::setw(10) << 100 * cpuSeconds / wallSeconds
+			<< std::endl;
+	}
+}
+
+
+int main( int argc, char* argv[] )
+{
+	double rateHz = (argc > 1) ? std::stod(argv[1]) : 200;
+	double durationSeconds = (argc > 2) ? std::stod(argv[2]) : 2;
+
+	std::cout << "Producer: " << rateHz << " Hz, " << durationSeconds << " s per policy" << std::endl;
+	std::cout
+		<< std::left << std::setw(12) << "Policy" << std::right
+		<< std::setw(10) << "frames"
+		<< std::setw(14) << "wake p50 [us]" << std::setw(14) << "wake p99 [us]" << std::setw(14) << "wake max [us]"
+		<< std::setw(10) << "CPU [%]"
+		<< std::endl;
+
+	Measure("Spin", vdsi::WaitPolicy::Spin, rateHz, durationSeconds);
+	Measure("SpinYield", vdsi::WaitPolicy::SpinYield, rateHz, durationSeconds);
+	Measure("Block", vdsi::WaitPolicy::Block, rateHz, durationSeconds);
+
+	return 0;
+}
@@ -0,0 +1,251 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Benchmark suite of the hot paths of VDS_Interface and ExportCSV
+	Swept over the number of subjects and markers per subject
+	Output is CSV, so that results of different versions can be compared (e.g. in a spreadsheet, or diff)
+
+	Benchmarks:
+		decode = decode one frame from a stand-in source (FrameSource_Synthetic), as the update thread does
+		decode_pose_only = decode, with a projection of only the pose of every subject (no markers)
+		decode_projected = decode, with a projection of every subject's pose, and the markers of the first subject only
+		filter_allows = FrameFilter::Allows() for every subject of a frame (object filter allows all subjects)
+		filter_sort = FrameFilter::SortByObjectFilter() of one frame (object filter lists all subjects, reversed)
+		getframe_copy = copy of the latest frame into the user's reused Points, as GetFrame(frame) does
+		getframe_new = copy of the latest frame into a new Points, as GetFrame() does
+		points_get = Points::Get(name) of every subject of a frame
+		points_find = Points::Find(handle) of every subject of a frame
+		csv_printall = build the CSV row of one frame (as vds_template_4) and ExportCSV::PrintAll it to a discarding stream
+		poses_point = Point::quat_xyzw() and Point::euler_rpy() of every subject of a frame, one at a time
+		poses_scalar = PoseBatch::Compute() of one frame, without SIMD
+		poses_simd = PoseBatch::Compute() of one frame, with the instruction set printed to stderr (see VDS_PoseKernels.h)
+		poses_frame = Points::ComputePoses() of one frame (poses_simd + gathering the inputs), as the update thread does
+
+	Output columns:
+		benchmark, subjects, markers, iterations, ns_per_op (median over samples), ns_per_op_p99, ns_per_op_min
+		One op = one frame
+
+Sample call:
+	./vds_benchmarks > results.csv
+	./vds_benchmarks 20
+
+Inputs:
+	arg1 = target measuring time per benchmark and size [ms] (default 100)
+
+*/
+// Program output
+#include <iostream>
+
+// Other
+#include <functional>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// Brandon's VDS Interface
+#include "VDS_Interface.h"
+#include "CSV_Exporter.h"
+#include "Benchmark_Tools.h"
+
+
+namespace
+{
+	// Output stream that discards everything
+	class NullBuffer : public std::streambuf
+	{
+	protected:
+		int overflow(int c) override { return c; }
+		std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+	};
+
+	// PURPOSE:
+	//	Time op, in samples of enough repetitions to be well above the clock resolution
+	//	Print the result as one CSV row
+	void Measure(const std::string& name, unsigned int numSubjects, unsigned int numMarkers, double targetMs, const std::function<void()>& op)
+	{
+		constexpr int numSamples = 31;
+
+		// Calibrate: repetitions per sample so that one sample takes ~targetMs/numSamples
+		op();
+		uint64_t repetitions = 1;
+		while(true)
+		{
+			auto t0 = bench::Clock::now();
+			for(uint64_t idx = 0; idx < repetitions; ++idx) { op(); }
+			double ns = bench::ElapsedNs(t0);
+			if(ns > targetMs * 1e6 / numSamples || repetitions > (uint64_t(1) << 30)) { break; }
+			repetitions *= 2;
+		}
+
+		std::vector<double> nsPerOp;
+		for(int idxSample = 0; idxSample < numSamples; ++idxSample)
+		{
+			auto t0 = bench::Clock::now();
+			for(uint64_t idx = 0; idx < repetitions; ++idx) { op(); }
+			nsPerOp.push_back(bench::ElapsedNs(t0) / double(repetitions));
+		}
+
+		double median = bench::Percentile(nsPerOp, 50);
+		double p99 = bench::Percentile(nsPerOp, 99);
+		double min = bench::Percentile(nsPerOp, 0);
+		std::cout
+			<< name << "," << numSubjects << "," << numMarkers << ","
+			<< repetitions * numSamples << ","
+			<< median << "," << p99 << "," << min
+			<< std::endl;
+	}
+
+	void RunAll(unsigned int numSubjects, unsigned int numMarkers, double targetMs)
+	{
+		// Stand-in source
+		vdsi::NameRegistry names;
+		vdsi::SyntheticSettings settings;
+		settings.numSubjects = numSubjects;
+		settings.numMarkers = numMarkers;
+		settings.occlusionRate = 0;
+		vdsi::FrameSource_Synthetic source(settings);
+		source.Connect(names);
+		source.WaitForFrame();
+
+		// Filter listing all subjects, in reverse order
+		std::vector<std::string> allowedObjects;
+		for(unsigned int idx = numSubjects; idx > 0; --idx) { allowedObjects.push_back("synthetic_subject_" + std::to_string(idx - 1)); }
+		vdsi::FrameFilter filter_none;
+		vdsi::FrameFilter filter_all;
+		filter_all.objects = vdsi::ObjectFilter::Create(allowedObjects, names);
+
+		// Decode projections
+		vdsi::ProjectionSettings projection;
+		projection.otherSubjects = vdsi::DecodeFields::Pose;
+		vdsi::FrameFilter filter_poseOnly;
+		filter_poseOnly.projection = vdsi::DecodeProjection::Create(projection, names);
+		projection.subjects = { { "synthetic_subject_0", vdsi::DecodeFields::PoseAndMarkers } };
+		vdsi::FrameFilter filter_projected;
+		filter_projected.projection = vdsi::DecodeProjection::Create(projection, names);
+
+		// A decoded frame, as held by the update thread
+		vdsi::Points decoded;
+		source.DecodeFrame(decoded, filter_none);
+		vdsi::Points sorted;
+		vdsi::Points userFrame;
+
+		Measure("decode", numSubjects, numMarkers, targetMs, [&] {
+			source.DecodeFrame(decoded, filter_none);
+			bench::DoNotOptimise(decoded);
+		});
+
+		Measure("decode_pose_only", numSubjects, numMarkers, targetMs, [&] {
+			source.DecodeFrame(decoded, filter_poseOnly);
+			bench::DoNotOptimise(decoded);
+		});
+
+		Measure("decode_projected", numSubjects, numMarkers, targetMs, [&] {
+			source.DecodeFrame(decoded, filter_projected);
+			bench::DoNotOptimise(decoded);
+		});
+		source.DecodeFrame(decoded, filter_none);
+
+		Measure("filter_allows", numSubjects, numMarkers, targetMs, [&] {
+			unsigned int numAllowed = 0;
+			for(auto& point : decoded.all) { numAllowed += filter_all.Allows(point.handle, point.IsOccluded); }
+			bench::DoNotOptimise(numAllowed);
+		});
+
+		Measure("filter_sort", numSubjects, numMarkers, targetMs, [&] {
+			filter_all.SortByObjectFilter(decoded, sorted);
+			bench::DoNotOptimise(sorted);
+		});
+
+		Measure("getframe_copy", numSubjects, numMarkers, targetMs, [&] {
+			userFrame = decoded;
+			bench::DoNotOptimise(userFrame);
+		});
+
+		Measure("getframe_new", numSubjects, numMarkers, targetMs, [&] {
+			vdsi::Points frame = decoded;
+			bench::DoNotOptimise(frame);
+		});
+
+		Measure("points_get", numSubjects, numMarkers, targetMs, [&] {
+			for(auto& name : allowedObjects)
+			{
+				auto point = decoded.Get(name);
+				bench::DoNotOptimise(point);
+			}
+		});
+
+		Measure("points_find", numSubjects, numMarkers, targetMs, [&] {
+			for(auto& handle : filter_all.objects->order)
+			{
+				auto point = decoded.Find(handle);
+				bench::DoNotOptimise(point);
+			}
+		});
+
+		NullBuffer nullBuffer;
+		std::ostream nullStream(&nullBuffer);
+		csv_exporter::ExportCSV ExportCSV(1);
+		csv_exporter::Export_CSV_RowBuilder<double> RowBuilder;
+		Measure("csv_printall", numSubjects, numMarkers, targetMs, [&] {
+			RowBuilder.Row.clear();
+			RowBuilder.AddData(double(decoded.frameNumber));
+			for(auto& point : decoded.all)
+			{
+				RowBuilder.AddData(point.R_rowMajor);
+				RowBuilder.AddData(point.P);
+				for(auto& marker : point.markers) { RowBuilder.AddData(marker.P); }
+			}
+			ExportCSV.AddRow(RowBuilder.Row);
+			ExportCSV.PrintAll_clear(nullStream);
+		});
+
+		Measure("poses_point", numSubjects, numMarkers, targetMs, [&] {
+			for(auto& point : decoded.all)
+			{
+				bench::DoNotOptimise(point.quat_xyzw());
+				bench::DoNotOptimise(point.euler_rpy());
+			}
+		});
+
+		decoded.ComputePoses();
+		Measure("poses_scalar", numSubjects, numMarkers, targetMs, [&] {
+			decoded.poses.Compute<vdsi::kernels::Lanes_Scalar>();
+			bench::DoNotOptimise(decoded.poses);
+		});
+
+		Measure("poses_simd", numSubjects, numMarkers, targetMs, [&] {
+			decoded.poses.Compute();
+			bench::DoNotOptimise(decoded.poses);
+		});
+
+		Measure("poses_frame", numSubjects, numMarkers, targetMs, [&] {
+			decoded.ComputePoses();
+			bench::DoNotOptimise(decoded.poses);
+		});
+
+		source.Disconnect();
+	}
+}
+
+
+int main( int argc, char* argv[] )
+{
+	double targetMs = (argc > 1) ? std::stod(argv[1]) : 100;
+
+	std::cerr << "Pose kernels instruction set: " << vdsi::kernels::InstructionSet << std::endl;
+	std::cout << "benchmark,subjects,markers,iterations,ns_per_op,ns_per_op_p99,ns_per_op_min" << std::endl;
+	for(unsigned int numSubjects : {1, 10, 50, 200, 500})
+	{
+		for(unsigned int numMarkers : {0, 5, 20})
+		{
+			RunAll(numSubjects, numMarkers, targetMs);
+		}
+	}
+	return 0;
+}
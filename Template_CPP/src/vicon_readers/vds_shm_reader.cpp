@@ -0,0 +1,113 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Read the frames that another process publishes to shared memory (VDS_Interface::EnableSharedMemory)
+	Does not link the Vicon DataStream SDK, and is built with the default libstdc++ ABI (see CMakeLists.txt)
+		=> the same code works in programs that can't use -D_GLIBCXX_USE_CXX11_ABI=0 (e.g. ROS 2 nodes)
+
+	Once per second, prints:
+		Frames read, and frames skipped (published while this reader was busy)
+		Latency from the publisher finishing the frame (tDecoded) to this process holding it [us]
+		Pose of the first object, and the number of occluded objects (counted in place, without a copy)
+
+Sample call:
+	Terminal 1 (publisher, synthetic frames):
+		./vds_template_4 --Synthetic 10 4 200 0.01 --SharedMemory /vds_frames --DurationSeconds 60
+	Terminal 2:
+		./vds_shm_reader
+		./vds_shm_reader /vds_frames 30
+
+Inputs:
+	arg1 = shared memory name (default /vds_frames)
+	arg2 = duration [s] (default 10)
+
+*/
+// Program output
+#include <iostream>
+#include <iomanip>
+
+// Other
+#include <chrono>
+#include <string>
+#include <thread>
+
+// Brandon's VDS Interface (SDK free parts only)
+#include "VDS_SharedMemory.h"
+#include "VDS_Stats.h"
+
+
+int main( int argc, char* argv[] )
+{
+	std::string name = (argc > 1) ? argv[1] : vdsi::ShmSettings().name;
+	double durationSeconds = (argc > 2) ? std::stod(argv[2]) : 10;
+
+#if defined(_GLIBCXX_USE_CXX11_ABI)
+	std::cout << "Built with _GLIBCXX_USE_CXX11_ABI=" << _GLIBCXX_USE_CXX11_ABI << std::endl;
+#endif
+
+	// Wait for the publisher
+	vdsi::ShmReader reader(name);
+	std::cout << "Waiting for " << name << std::endl;
+	auto tEnd = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(durationSeconds));
+	while( ! reader.Open() )
+	{
+		if(std::chrono::steady_clock::now() > tEnd) { std::cout << "No publisher found" << std::endl; return 1; }
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+
+	vdsi::Points frame;
+	vdsi::RollingHistogram latency(100000);
+	uint64_t framesRead = 0;
+	uint64_t framesSkipped = 0;
+	unsigned int lastFrameNumber = 0;
+	auto tReport = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+	while(std::chrono::steady_clock::now() < tEnd)
+	{
+		if( ! reader.GetFrame_WaitForNew(frame, std::chrono::milliseconds(100)) )
+		{
+			if( ! reader.IsAlive() )
+			{
+				std::cout << "Publisher closed. Waiting for a new one" << std::endl;
+				while( ! reader.Open() && std::chrono::steady_clock::now() < tEnd ) { std::this_thread::sleep_for(std::chrono::milliseconds(100)); }
+				lastFrameNumber = 0;
+			}
+			continue;
+		}
+
+		latency.Add(double(std::chrono::duration_cast<std::chrono::nanoseconds>(frame.timing.tPickup - frame.timing.tDecoded).count()));
+		if(lastFrameNumber != 0 && frame.frameNumber > lastFrameNumber + 1) { framesSkipped += frame.frameNumber - lastFrameNumber - 1; }
+		lastFrameNumber = frame.frameNumber;
+		++framesRead;
+
+		if(std::chrono::steady_clock::now() < tReport) { continue; }
+		tReport += std::chrono::seconds(1);
+
+		// Zero copy read: count occluded objects in place
+		unsigned int numOccluded = 0;
+		reader.Visit([&](const vdsi::shm::SlotView& view) {
+			numOccluded = 0;
+			for(uint32_t idx = 0; idx < view.header->numSubjects; ++idx) { numOccluded += view.subjects[idx].IsOccluded; }
+		});
+
+		auto summary = latency.Summary();
+		std::cout << std::fixed << std::setprecision(1)
+			<< "frame " << frame.frameNumber
+			<< ", read " << framesRead << ", skipped " << framesSkipped
+			<< ", latency p50 " << summary.p50 * 1e-3 << " us, p99 " << summary.p99 * 1e-3 << " us"
+			<< ", occluded " << numOccluded << "/" << frame.all.size();
+		if( ! frame.all.empty() )
+		{
+			auto& point = frame.all.front();
+			std::cout << ", " << point.viconObjectName << " P = " << point.x() << " " << point.y() << " " << point.z();
+		}
+		std::cout << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,83 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Receive the frames that another computer (or process) re-broadcasts over UDP (VDS_Interface::EnableUdpRelay)
+	Does not link the Vicon DataStream SDK, and is built with the default libstdc++ ABI (see CMakeLists.txt)
+
+	Once per second, prints:
+		Frames received, incomplete frames, and lost datagrams
+		Age of the frame on arrival: capture to arrival [us], as estimated by the sender + network delay on the same computer only
+		Pose of the first object
+
+Sample call:
+	Loopback test on one computer (unicast):
+		Terminal 1: ./vds_template_4 --Synthetic 10 4 200 0.01 --UdpRelay 127.0.0.1 51001 --DurationSeconds 60
+		Terminal 2: ./vds_udp_receiver 127.0.0.1 51001
+	Multicast (any number of receivers, on any computer of the subnet):
+		Sender:    ./vds_template_4 --Objects Jackal bj_ctrl --UdpRelay 239.255.80.1 51001 --DurationSeconds 600
+		Receivers: ./vds_udp_receiver 239.255.80.1 51001
+
+Inputs:
+	arg1 = address: multicast group to join, or any unicast address to receive on port (default 239.255.80.1)
+	arg2 = port (default 51001)
+	arg3 = duration [s] (default 10)
+
+*/
+// Program output
+#include <iostream>
+#include <iomanip>
+
+// Other
+#include <chrono>
+#include <string>
+
+// Brandon's VDS Interface (SDK free parts only)
+#include "VDS_UdpRelay.h"
+#include "VDS_Stats.h"
+
+
+int main( int argc, char* argv[] )
+{
+	vdsi::UdpReceiverSettings settings;
+	if(argc > 1) { settings.address = argv[1]; }
+	if(argc > 2) { settings.port = uint16_t(std::stoul(argv[2])); }
+	double durationSeconds = (argc > 3) ? std::stod(argv[3]) : 10;
+
+	vdsi::UdpReceiver receiver(settings);
+	std::cout << "Listening on " << settings.address << ":" << settings.port << std::endl;
+
+	vdsi::Points frame;
+	vdsi::RollingHistogram age(100000);
+	auto tEnd = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(durationSeconds));
+	auto tReport = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+	while(std::chrono::steady_clock::now() < tEnd)
+	{
+		if( ! receiver.Receive(frame, std::chrono::milliseconds(100)) ) { continue; }
+		age.Add(double(std::chrono::duration_cast<std::chrono::nanoseconds>(frame.timing.tReceived - frame.timing.tCaptured()).count()));
+
+		if(std::chrono::steady_clock::now() < tReport) { continue; }
+		tReport += std::chrono::seconds(1);
+
+		auto stats = receiver.Stats();
+		auto summary = age.Summary();
+		std::cout << std::fixed << std::setprecision(1)
+			<< "frame " << frame.frameNumber
+			<< ", received " << stats.framesReceived << ", incomplete " << stats.framesIncomplete << ", datagrams lost " << stats.datagramsLost
+			<< ", age p50 " << summary.p50 * 1e-3 << " us, p99 " << summary.p99 * 1e-3 << " us"
+			<< ", objects " << frame.all.size();
+		if( ! frame.all.empty() )
+		{
+			auto& point = frame.all.front();
+			std::cout << ", " << point.viconObjectName << " P = " << point.x() << " " << point.y() << " " << point.z();
+		}
+		std::cout << std::endl;
+	}
+	return 0;
+}
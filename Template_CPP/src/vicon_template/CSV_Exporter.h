@@ -1,7 +1,7 @@
 /*
 Written by:			Brandon Johns
 Version created:	2021-12-13
-Last edited:		2022-04-28
+Last edited:		2026-10-17
 
 Version changes:
 	NA
@@ -10,11 +10,15 @@ Purpose:
 	Helper to print data into a CSV
 		Enforces row length
 		Prints data at end to improve performance while collecting data
+		Data rows are held one after another in one array => adding a row does not allocate (once the array has grown)
+		Numbers are printed with std::to_chars: locale independent, and by default the shortest text that reads back to the same double
+		Optionally, prints data from a background thread while collecting data (async writer)
 
 Summary:
 	class ExportCSV
 		Holds the CSV data
 		Prints the data to the file when printAll is called
+		Or, after EnableAsyncWriter(), a background thread prints the data as it is added
 	class Export_CSV_RowBuilder
 		Helper for ExportCSV. Use to build a row of the CSV, then pass Row to ExportCSV.AddRow()
 
@@ -26,10 +30,53 @@ Summary:
 #include <iostream>
 #include <fstream> // read/write to files
 #include <vector>
+#include <array>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <charconv> // std::to_chars
 
 
 namespace csv_exporter
 {
+	// When the async writer flushes the output stream
+	//	Flushing hands the data to the operating system, so it survives a crash of this program
+	//	(it does not force the operating system to write to disk)
+	enum class FlushPolicy
+	{
+		OnClose,	// Only when the writer is disabled. Fastest
+		Interval,	// At most every AsyncWriterSettings::flushInterval
+		EveryBatch	// After every batch of rows written. Least data lost on a crash
+	};
+
+	// What AddRow does when the async writer has fallen behind by AsyncWriterSettings::backlogRowsMax rows
+	enum class BacklogPolicy
+	{
+		Block,	// Wait for the writer to catch up. No rows lost, but the caller stalls
+		Drop	// Discard the row and count it. The caller never stalls
+	};
+
+	// Precision for SetPrecision(): print the shortest text that reads back as exactly the same double
+	constexpr int Precision_ShortestRoundTrip = -1;
+
+	struct AsyncWriterSettings
+	{
+		FlushPolicy flushPolicy = FlushPolicy::Interval;
+		std::chrono::milliseconds flushInterval{1000};
+		BacklogPolicy backlogPolicy = BacklogPolicy::Block;
+		uint64_t backlogRowsMax = 100000;
+	};
+
+	struct AsyncWriterStats
+	{
+		uint64_t rowsWritten = 0;
+		uint64_t rowsDropped = 0;	// BacklogPolicy::Drop only
+		uint64_t timesBlocked = 0;	// BacklogPolicy::Block only: number of AddRow calls that had to wait
+		uint64_t maxBacklog = 0;	// Most rows ever waiting to be written
+	};
+
 	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 	// Print data into a csv
 	// Stores the data before user calls print to output all at once
@@ -42,9 +89,33 @@ namespace csv_exporter
 		uint64_t rowLength = 0;
 		bool rowLength_IsSet = false;
 
+		// Significant digits of printed numbers, or Precision_ShortestRoundTrip
+		int precision = Precision_ShortestRoundTrip;
+
+		// Reused between calls to PrintAll, to avoid allocating
+		std::vector<char> formatBuffer;
+
 		// CSV header & data rows
+		//	Data rows are stored one after another (rowLength values each)
+		//	Rows to preallocate for, once the row length is known
 		std::vector< std::vector<std::string> > headerRows;
-		std::vector< std::vector<double> > dataRows;
+		std::vector<double> dataRows;
+		uint64_t numDataRows = 0;
+		uint64_t numRows_estimate = 0;
+
+		// Async writer
+		//	Double buffered: AddRow appends to headerRows/dataRows while the writer thread prints the swapped out rows
+		//	mtx_Async guards headerRows, dataRows, numDataRows, backlog and stats while the writer is enabled
+		std::thread WriterThread;
+		std::ostream* asyncOutStream = nullptr;
+		AsyncWriterSettings asyncSettings;
+		std::mutex mtx_Async;
+		std::condition_variable cv_RowsAdded;
+		std::condition_variable cv_RowsWritten;
+		bool IsAsync = false;
+		bool IsAsyncStopRequest = false;
+		uint64_t backlog = 0; // Rows added but not yet printed (both buffers)
+		AsyncWriterStats asyncStats;
 
 		// Enforces the strict requirement that each row of the CSV must be exactly this length
 		void ValidateRowLength(uint64_t rowLength_in)
@@ -58,7 +129,97 @@ namespace csv_exporter
 			{
 				this->rowLength = rowLength_in;
 				this->rowLength_IsSet = true;
+				this->dataRows.reserve(this->numRows_estimate * this->rowLength);
+			}
+		}
+
+		// Print rows in CSV format
+		//	Numbers are formatted into buffer, which is written to outStream in large blocks
+		//	One flush at the end, rather than one per row
+		static void PrintRows(std::ostream& outStream, const std::vector< std::vector<std::string> >& headerRows_in, const std::vector<double>& dataRows_in, uint64_t numRows_in, uint64_t rowLength_in, int precision_in, std::vector<char>& buffer)
+		{
+			for (auto& row : headerRows_in)
+			{
+				for (auto& value : row)
+				{
+					outStream << value << ",";
+				}
+				outStream << '\n';
+			}
+
+			// Longest output of to_chars for a double is 24 chars (e.g. -2.2250738585072014e-308), plus separator
+			constexpr size_t maxValueChars = 32;
+			constexpr size_t blockBytes = 1 << 16;
+			if(buffer.size() < blockBytes + maxValueChars) { buffer.resize(blockBytes + maxValueChars); }
+			char* const begin = buffer.data();
+			char* const blockEnd = begin + blockBytes;
+			char* const end = begin + buffer.size();
+			char* pos = begin;
+
+			const double* value = dataRows_in.data();
+			for (uint64_t idxRow = 0; idxRow < numRows_in; ++idxRow)
+			{
+				for (uint64_t idxCol = 0; idxCol < rowLength_in; ++idxCol, ++value)
+				{
+					auto result = (precision_in == Precision_ShortestRoundTrip)
+						? std::to_chars(pos, end, *value)
+						: std::to_chars(pos, end, *value, std::chars_format::general, precision_in);
+					pos = result.ptr;
+					*pos++ = ',';
+					if(pos >= blockEnd) { outStream.write(begin, pos - begin); pos = begin; }
+				}
+				*pos++ = '\n';
+				if(pos >= blockEnd) { outStream.write(begin, pos - begin); pos = begin; }
+			}
+			outStream.write(begin, pos - begin);
+		}
+
+		// Async writer: wait for rows, swap buffers, print without holding the lock
+		void WriterLoop()
+		{
+			std::vector< std::vector<std::string> > headerRows_writing;
+			std::vector<double> dataRows_writing;
+			uint64_t numDataRows_writing = 0;
+			std::vector<char> formatBuffer_writing;
+			auto tLastFlush = std::chrono::steady_clock::now();
+
+			std::unique_lock<std::mutex> lock(this->mtx_Async);
+			while(true)
+			{
+				this->cv_RowsAdded.wait_for(lock, this->asyncSettings.flushInterval, [this]{
+					return this->IsAsyncStopRequest || !this->headerRows.empty() || this->numDataRows > 0;
+				});
+				bool IsStop = this->IsAsyncStopRequest;
+				std::swap(headerRows_writing, this->headerRows);
+				std::swap(dataRows_writing, this->dataRows);
+				std::swap(numDataRows_writing, this->numDataRows);
+				uint64_t rowLength_writing = this->rowLength;
+				lock.unlock();
+
+				PrintRows(*this->asyncOutStream, headerRows_writing, dataRows_writing, numDataRows_writing, rowLength_writing, this->precision, formatBuffer_writing);
+				uint64_t numWritten = numDataRows_writing;
+
+				auto tNow = std::chrono::steady_clock::now();
+				if((this->asyncSettings.flushPolicy == FlushPolicy::EveryBatch && numWritten > 0)
+					|| (this->asyncSettings.flushPolicy == FlushPolicy::Interval && tNow - tLastFlush >= this->asyncSettings.flushInterval))
+				{
+					this->asyncOutStream->flush();
+					tLastFlush = tNow;
+				}
+				headerRows_writing.clear();
+				dataRows_writing.clear();
+				numDataRows_writing = 0;
+
+				lock.lock();
+				this->backlog -= numWritten;
+				this->asyncStats.rowsWritten += numWritten;
+				this->cv_RowsWritten.notify_all();
+
+				// Stop only once everything added before the stop request has been printed
+				if(IsStop && this->headerRows.empty() && this->numDataRows == 0) { break; }
 			}
+			lock.unlock();
+			this->asyncOutStream->flush();
 		}
 
 	public:
@@ -67,10 +228,72 @@ namespace csv_exporter
 		//****************************************
 		// INPUT:
 		//	numRows_estimate = predicted required number of rows. Not an absolute max, just for preallocation
-		ExportCSV(uint64_t numRows_estimate)
+		ExportCSV(uint64_t numRows_estimate_in) : numRows_estimate(numRows_estimate_in)
 		{
-			// preallocate space to store data
-			this->dataRows.reserve(numRows_estimate);
+			// Space to store data is preallocated once the row length is known (first row)
+		}
+
+		~ExportCSV() { this->DisableAsyncWriter(); }
+
+		// INPUT:
+		//	significantDigits = in [1,17] (17 always reads back exactly)
+		//		or Precision_ShortestRoundTrip (default): shortest text that reads back exactly
+		//	Set before EnableAsyncWriter()
+		void SetPrecision(int significantDigits)
+		{
+			if(this->IsAsync) { throw std::runtime_error("csv_exporter_ERROR: Set precision before enabling the async writer"); }
+			if(significantDigits != Precision_ShortestRoundTrip && (significantDigits < 1 || significantDigits > 17))
+			{
+				throw std::runtime_error("csv_exporter_ERROR: Precision must be in [1,17] or Precision_ShortestRoundTrip");
+			}
+			this->precision = significantDigits;
+		}
+
+		ExportCSV(const ExportCSV&) = delete;
+		ExportCSV& operator=(const ExportCSV&) = delete;
+
+		//********************************************************************************
+		// Interface: async writer
+		//****************************************
+		// PURPOSE:
+		//	Print rows from a background thread as they are added
+		//	=> AddRow only appends to memory, so a slow disk does not stall the caller
+		//	Any rows already held are printed first
+		// INPUT:
+		//	outStream = where to print. Must remain valid until DisableAsyncWriter() (or destruction)
+		//	settings = flush and backlog behaviour
+		void EnableAsyncWriter(std::ostream& outStream, AsyncWriterSettings settings = {})
+		{
+			if(this->IsAsync) { throw std::runtime_error("csv_exporter_ERROR: Async writer is already enabled"); }
+			if(settings.backlogRowsMax == 0) { throw std::runtime_error("csv_exporter_ERROR: backlogRowsMax must be > 0"); }
+			this->asyncOutStream = &outStream;
+			this->asyncSettings = settings;
+			this->asyncStats = {};
+			this->backlog = this->numDataRows;
+			this->IsAsyncStopRequest = false;
+			this->IsAsync = true;
+			this->WriterThread = std::thread(&ExportCSV::WriterLoop, this);
+		}
+
+		// Print all remaining rows, flush, and stop the background thread
+		// Returns to normal mode (rows are held until PrintAll is called)
+		void DisableAsyncWriter()
+		{
+			if( ! this->IsAsync ) { return; }
+			{
+				std::lock_guard<std::mutex> lock(this->mtx_Async);
+				this->IsAsyncStopRequest = true;
+			}
+			this->cv_RowsAdded.notify_one();
+			this->WriterThread.join();
+			this->IsAsync = false;
+			this->asyncOutStream = nullptr;
+		}
+
+		AsyncWriterStats GetAsyncWriterStats()
+		{
+			std::lock_guard<std::mutex> lock(this->mtx_Async);
+			return this->asyncStats;
 		}
 
 		//********************************************************************************
@@ -81,42 +304,65 @@ namespace csv_exporter
 		// Header: the first line of the CSV
 		void AddHeader(std::vector<std::string> row)
 		{
+			std::unique_lock<std::mutex> lock(this->mtx_Async, std::defer_lock);
+			if(this->IsAsync) { lock.lock(); }
+
 			this->ValidateRowLength(row.size());
-			this->headerRows.push_back( row );
+			this->headerRows.push_back( std::move(row) );
+			if(this->IsAsync) { this->cv_RowsAdded.notify_one(); }
 		}
 
 		// Append a data row to the CSV
-		void AddRow(std::vector<double> row)
+		//	The values are copied into the held rows (no allocation per row)
+		void AddRow(const double* row, size_t rowLength_in)
 		{
-			this->ValidateRowLength(row.size());
-			this->dataRows.push_back( row );
+			if( ! this->IsAsync )
+			{
+				this->ValidateRowLength(rowLength_in);
+				this->dataRows.insert(this->dataRows.end(), row, row + rowLength_in);
+				this->numDataRows++;
+				return;
+			}
+
+			std::unique_lock<std::mutex> lock(this->mtx_Async);
+			this->ValidateRowLength(rowLength_in);
+
+			// Writer has fallen behind
+			if(this->backlog >= this->asyncSettings.backlogRowsMax)
+			{
+				if(this->asyncSettings.backlogPolicy == BacklogPolicy::Drop)
+				{
+					this->asyncStats.rowsDropped++;
+					return;
+				}
+				this->asyncStats.timesBlocked++;
+				this->cv_RowsWritten.wait(lock, [this]{ return this->backlog < this->asyncSettings.backlogRowsMax; });
+			}
+
+			this->dataRows.insert(this->dataRows.end(), row, row + rowLength_in);
+			this->numDataRows++;
+			this->backlog++;
+			if(this->backlog > this->asyncStats.maxBacklog) { this->asyncStats.maxBacklog = this->backlog; }
+			lock.unlock();
+			this->cv_RowsAdded.notify_one();
 		}
 
+		void AddRow(const std::vector<double>& row) { this->AddRow(row.data(), row.size()); }
+
+		// Append a data row with a column count known when compiling (e.g. vdsi::FixedRowWriter::Row)
+		template<size_t N>
+		void AddRow(const std::array<double, N>& row) { this->AddRow(row.data(), N); }
+
 		//********************************************************************************
 		// Interface: output
 		//****************************************
 		// Print all currently held data in CSV format
+		// (Not available while the async writer is enabled: it prints the data itself)
 		void PrintAll(std::ostream& outStream)
 		{
-			// Print head
-			for (auto& row : this->headerRows)
-			{
-				for (auto& value : row)
-				{
-					outStream << value << ",";
-				}
-				outStream << std::endl;
-			}
-
-			// Print rows
-			for (auto& row : this->dataRows)
-			{
-				for (auto& value : row)
-				{
-					outStream << value << ",";
-				}
-				outStream << std::endl;
-			}
+			if(this->IsAsync) { throw std::runtime_error("csv_exporter_ERROR: PrintAll called while the async writer is enabled"); }
+			PrintRows(outStream, this->headerRows, this->dataRows, this->numDataRows, this->rowLength, this->precision, this->formatBuffer);
+			outStream.flush();
 		}
 
 		// Print currently held data, then clear held data
@@ -126,6 +372,7 @@ namespace csv_exporter
 			PrintAll(outStream);
 			this->headerRows.clear();
 			this->dataRows.clear();
+			this->numDataRows = 0;
 		}
 
 	};
@@ -158,7 +405,13 @@ namespace csv_exporter
 			this->Row.push_back(value);
 		}
 
-		void AddData(std::vector<DataType> values)
+		void AddData(const std::vector<DataType>& values)
+		{
+			this->Row.insert( this->Row.end(), values.begin(), values.end() );
+		}
+
+		template<size_t N>
+		void AddData(const std::array<DataType, N>& values)
 		{
 			this->Row.insert( this->Row.end(), values.begin(), values.end() );
 		}
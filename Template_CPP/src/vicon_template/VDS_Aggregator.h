@@ -0,0 +1,516 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Merge the frames of several Vicon systems (e.g. two Tracker PCs covering adjacent volumes) into one vdsi::Points
+		One VDS_Interface per system, each with its own connection and update thread
+		A merge thread aligns their frames by capture time, and publishes one merged frame
+
+	Alignment
+		The systems are not synchronised: their frames arrive at different times, and maybe at different rates
+		A merge starts when any system has a new frame. It waits for the others, but never longer than maxWait
+			=> a slow or dead system delays the merged frame by at most maxWait
+			=> a faster system is not slowed down: a second frame from it ends the wait
+		Reference time = capture time of the oldest new frame
+		Each system then contributes its recent frame nearest the reference time (a system with no new frame contributes an old one)
+		A system that delivered nothing for staleAfter (e.g. disconnected) contributes nothing, so its last poses are not repeated
+
+	Each merged subject is tagged with its system (Point_Object::source), and can be transformed into a common frame
+	A subject seen by several systems (e.g. in the overlap of the volumes) appears once: see AggregatorSettings::IsMergeSameName
+
+Class Summary:
+	AggregatorSource
+		Connection and placement of one Vicon system
+
+	AggregatorSettings
+		Alignment wait, and handling of subjects seen by several systems
+
+	VDS_Aggregator
+		Owns the VDS_Interface of each system, and the merge thread
+		Same frame API as VDS_Interface: GetFrame(), TryGetFrame(), GetFrame_WaitForNew(), GetHandle()
+
+*/
+#pragma once
+
+// Brandon's VDS Interface helpers
+#include "VDS_Interface.h"
+#include "VDS_Stats.h"
+
+// Standard library
+#include <iostream>
+#include <string>
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+
+
+namespace vdsi
+{
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// One Vicon system
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	struct AggregatorSource
+	{
+		// Name of the system, for messages (e.g. "North")
+		std::string label;
+
+		// Connection: hostName of the Vicon PC, or instead any frame source (e.g. FrameSource_Replay, for tests)
+		std::string hostName = "localhost:801";
+		bool EnableLightweight = false;
+		std::unique_ptr<vdsi::FrameSource> source;
+
+		// Pose of this system's origin in the common frame: P_common = R * P + P0
+		//	Applied to subjects and markers, if HasTransform
+		bool HasTransform = false;
+		vdsi::RotationMatrix R = { 1,0,0, 0,1,0, 0,0,1 };
+		vdsi::Translation P0 = { 0,0,0 };
+	};
+
+	struct AggregatorSettings
+	{
+		// Longest time a merge waits for the other systems after the first new frame
+		std::chrono::nanoseconds maxWait = std::chrono::milliseconds(5);
+
+		// A system that delivered nothing for this long (e.g. disconnected) is not waited for, and its subjects are left out of the merge
+		//	=> its last poses are not repeated, and the same subjects from other systems are used instead
+		std::chrono::nanoseconds staleAfter = std::chrono::milliseconds(100);
+
+		// true = a subject name seen by several systems appears once:
+		//	from the first system (in the order given to Connect) that sees it unoccluded
+		// false = once per system (tell them apart by Point_Object::source)
+		bool IsMergeSameName = true;
+	};
+
+	struct AggregatorSourceStats
+	{
+		std::string label;
+		uint64_t framesReceived = 0;
+
+		// Merges that used an old frame of this system (e.g. it had no new frame within maxWait, or runs slower than the others)
+		uint64_t staleMerges = 0;
+
+		// |capture time of the frame used - reference time| [ns]
+		vdsi::HistogramSummary skew;
+	};
+
+	struct AggregatorStats
+	{
+		uint64_t framesMerged = 0;
+		std::vector<vdsi::AggregatorSourceStats> sources;
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Merge of several Vicon systems
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	class VDS_Aggregator
+	{
+	private:
+		using Clock = vdsi::FrameTiming::Clock;
+		static constexpr size_t HistoryLength = 4;
+
+		// Frames received from one system (written by its update thread, under mtx_Incoming)
+		struct Incoming
+		{
+			std::array<vdsi::Points, HistoryLength> history;
+			uint64_t received = 0; // Newest is history[(received - 1) % HistoryLength]
+			uint64_t merged = 0;   // Frames before this count have been merged (or skipped)
+			Clock::time_point tArrived;
+		};
+
+		struct System
+		{
+			std::string label;
+			bool HasTransform = false;
+			vdsi::RotationMatrix R;
+			vdsi::Translation P0;
+
+			std::unique_ptr<vdsi::VDS_Interface> VDS;
+			vdsi::SubscriptionId subscription;
+			Incoming incoming;
+
+			// Merge thread only (skew and staleMerges: under mtx_Incoming)
+			vdsi::Points chosen;
+			std::vector<vdsi::SubjectHandle> mergedHandleById; // Handle of the system's registry => handle of the merged frame
+			vdsi::RollingHistogram skew{1000};
+			uint64_t staleMerges = 0;
+		};
+
+		vdsi::AggregatorSettings settings;
+		std::vector<std::unique_ptr<System>> systems;
+
+		// Handles of the merged frame
+		vdsi::NameRegistry Names;
+
+		// New frames => merge thread
+		std::mutex mtx_Incoming;
+		std::condition_variable cv_Incoming;
+
+		// Merged frames => readers (same handoff as VDS_Interface)
+		vdsi::TripleBuffer<vdsi::Points> LatestFrame;
+		std::mutex mtx_Readers;
+		vdsi::FrameSignal FrameReady;
+		std::atomic<uint64_t> stats_FramesMerged = 0;
+
+		// Internal state control
+		std::unique_ptr<std::thread> MergeThread;
+		std::atomic<bool> IsConnected = false;
+		bool IsKillRequest = false; // Under mtx_Incoming
+
+		// Working storage of the merge thread, reused every merge
+		std::vector<uint32_t> slotByHandle;
+
+	public:
+		//********************************************************************************
+		// Interface: Create
+		//****************************************
+		VDS_Aggregator(const vdsi::AggregatorSettings& settings_in = vdsi::AggregatorSettings()) :
+			settings(settings_in)
+		{
+			// Nothing to do
+		}
+
+		~VDS_Aggregator() { this->Disconnect(); }
+
+		//********************************************************************************
+		// Interface: Connect / Disconnect
+		//****************************************
+		// PURPOSE: Connect to every system, then start merging
+		// INPUT: sources = the systems. Their order sets Point_Object::source, and the priority of IsMergeSameName
+		void Connect(std::vector<vdsi::AggregatorSource> sources)
+		{
+			if(this->IsConnected) { return; } // Nothing to do
+			if(sources.empty()) { throw std::runtime_error("ERROR_VDS: (VDS_Aggregator) No sources"); }
+			if(sources.size() > UINT16_MAX) { throw std::runtime_error("ERROR_VDS: (VDS_Aggregator) Too many sources"); }
+
+			// Every system exists before the merge thread starts, and systems is not resized while it runs
+			//	(the first frames of a system are merged while the next systems are still connecting)
+			this->systems.clear();
+			for(size_t idx = 0; idx < sources.size(); ++idx)
+			{
+				auto& source = sources[idx];
+				auto system = std::make_unique<System>();
+				system->label = source.label.empty() ? "system_" + std::to_string(idx) : source.label;
+				system->HasTransform = source.HasTransform;
+				system->R = source.R;
+				system->P0 = source.P0;
+				system->VDS = std::make_unique<vdsi::VDS_Interface>();
+				this->systems.push_back(std::move(system));
+			}
+
+			this->IsKillRequest = false;
+			this->FrameReady.Clear();
+			this->stats_FramesMerged = 0;
+			this->MergeThread = std::make_unique<std::thread>([this] { this->MergeInBackground(); });
+
+			for(size_t idx = 0; idx < sources.size(); ++idx)
+			{
+				auto& source = sources[idx];
+				System* systemPtr = this->systems[idx].get();
+
+				// Copy each frame on the update thread of its system
+				vdsi::SubscriptionSettings subscription;
+				subscription.mode = vdsi::CallbackMode::Inline;
+				systemPtr->subscription = systemPtr->VDS->Subscribe([this, systemPtr](const vdsi::Points& frame) { this->Receive(*systemPtr, frame); }, subscription);
+
+				std::cout << "INFO_VDS: (VDS_Aggregator) Connecting to " << systemPtr->label << std::endl;
+				if(source.source) { systemPtr->VDS->Connect(std::move(source.source)); }
+				else { systemPtr->VDS->Connect(source.hostName, source.EnableLightweight); }
+			}
+			this->IsConnected = true;
+		}
+
+		// PURPOSE: Disconnect from every system, and stop merging
+		void Disconnect()
+		{
+			if( ! this->IsConnected && ! this->MergeThread ) { return; } // Nothing to do
+
+			for(auto& system : this->systems)
+			{
+				system->VDS->Unsubscribe(system->subscription);
+				system->VDS->Disconnect();
+			}
+			{
+				std::lock_guard<std::mutex> lock(this->mtx_Incoming);
+				this->IsKillRequest = true;
+			}
+			this->cv_Incoming.notify_all();
+			if(this->MergeThread) { this->MergeThread->join(); }
+			this->MergeThread.reset();
+			this->IsConnected = false;
+		}
+
+		//********************************************************************************
+		// Interface: Systems
+		//****************************************
+		size_t NumSystems() const { return this->systems.size(); }
+
+		// OUTPUT: The interface of one system, e.g. to set its filters. Valid until Disconnect()
+		vdsi::VDS_Interface& GetSystem(size_t idx) { return *this->systems.at(idx)->VDS; }
+		const std::string& GetLabel(size_t idx) const { return this->systems.at(idx)->label; }
+
+		//********************************************************************************
+		// Interface: Get
+		//****************************************
+		// INPUT: Object name
+		// OUTPUT: Handle for fast lookup in merged frames (Points::Find(handle))
+		vdsi::SubjectHandle GetHandle(const std::string& name) { return this->Names.Intern(name); }
+
+		// PURPOSE: Latest merged frame (waits for the first one)
+		// OUTPUT: frame = the merged frame (copy assignment reuses its storage)
+		//	return = false if not connected or no merged frame yet (timed out after 1 s)
+		bool TryGetFrame(vdsi::Points& frame)
+		{
+			if( ! this->IsConnected ) { frame = vdsi::Points(); return false; }
+			bool IsReady = this->FrameReady.Wait(vdsi::WaitPolicy::Block, std::chrono::seconds(1));
+
+			std::lock_guard<std::mutex> lock(this->mtx_Readers);
+			this->LatestFrame.Update();
+			frame = this->LatestFrame.Front();
+			frame.timing.tPickup = Clock::now();
+			return IsReady;
+		}
+
+		void GetFrame(vdsi::Points& frame)
+		{
+			if( ! this->TryGetFrame(frame) ) { std::cout << "WARNING_VDS: (VDS_Aggregator::GetFrame) No merged frame" << std::endl; }
+		}
+
+		vdsi::Points GetFrame()
+		{
+			vdsi::Points frame;
+			this->GetFrame(frame);
+			return frame;
+		}
+
+		// PURPOSE: Same as GetFrame(), but waits for the next merged frame
+		bool GetFrame_WaitForNew(vdsi::Points& frame)
+		{
+			this->FrameReady.Clear();
+			return this->TryGetFrame(frame);
+		}
+
+		vdsi::AggregatorStats GetStats()
+		{
+			vdsi::AggregatorStats stats;
+			stats.framesMerged = this->stats_FramesMerged;
+			std::lock_guard<std::mutex> lock(this->mtx_Incoming);
+			for(auto& system : this->systems)
+			{
+				vdsi::AggregatorSourceStats sourceStats;
+				sourceStats.label = system->label;
+				sourceStats.framesReceived = system->incoming.received;
+				sourceStats.staleMerges = system->staleMerges;
+				sourceStats.skew = system->skew.Summary();
+				stats.sources.push_back(sourceStats);
+			}
+			return stats;
+		}
+
+	private:
+		//********************************************************************************
+		// Update threads of the systems
+		//****************************************
+		void Receive(System& system, const vdsi::Points& frame)
+		{
+			{
+				std::lock_guard<std::mutex> lock(this->mtx_Incoming);
+				auto& incoming = system.incoming;
+				incoming.history[incoming.received % HistoryLength] = frame;
+				++incoming.received;
+				incoming.tArrived = Clock::now();
+			}
+			this->cv_Incoming.notify_one();
+		}
+
+		//********************************************************************************
+		// Merge thread
+		//****************************************
+		static Clock::time_point CaptureTime(const vdsi::Points& frame)
+		{
+			return std::isfinite(frame.timing.latencySDK) ? frame.timing.tCaptured() : frame.timing.tReceived;
+		}
+
+		void MergeInBackground()
+		{
+			std::unique_lock<std::mutex> lock(this->mtx_Incoming);
+			while(true)
+			{
+				// Wait for any new frame
+				this->cv_Incoming.wait(lock, [this] { return this->IsKillRequest || this->IsAnyNew(); });
+				if(this->IsKillRequest) { return; }
+
+				// Then for the other systems, up to maxWait
+				auto tFirst = Clock::now();
+				this->cv_Incoming.wait_until(lock, tFirst + this->settings.maxWait, [this, tFirst] { return this->IsKillRequest || this->IsAllNew(tFirst); });
+				if(this->IsKillRequest) { return; }
+
+				// Choose and copy a frame of each system, then merge without the lock
+				Clock::time_point tReference = this->Choose();
+				lock.unlock();
+				this->Merge(tReference);
+				lock.lock();
+			}
+		}
+
+		bool IsAnyNew() const
+		{
+			for(auto& system : this->systems)
+			{
+				if(system->incoming.received > system->incoming.merged) { return true; }
+			}
+			return false;
+		}
+
+		// OUTPUT: true if every system that is still delivering has a new frame
+		//	Or if a system has two: it runs faster than the others, and waiting longer would drop its frames
+		bool IsAllNew(Clock::time_point tNow) const
+		{
+			bool IsAll = true;
+			for(auto& system : this->systems)
+			{
+				auto& incoming = system->incoming;
+				if(incoming.received >= incoming.merged + 2) { return true; }
+				bool IsDelivering = incoming.received > 0 && tNow - incoming.tArrived < this->settings.staleAfter;
+				if(IsDelivering && incoming.received == incoming.merged) { IsAll = false; }
+			}
+			return IsAll;
+		}
+
+		// PURPOSE: Copy into System::chosen the frame of each system nearest the reference time (under mtx_Incoming)
+		//	A system's frames after the chosen one stay new, and are merged next time => no frame is skipped
+		// OUTPUT: Reference time
+		Clock::time_point Choose()
+		{
+			// Reference = oldest of the new frames (those that fell out of the history are lost)
+			Clock::time_point tReference = Clock::time_point::max();
+			for(auto& system : this->systems)
+			{
+				auto& incoming = system->incoming;
+				if(incoming.received == incoming.merged) { continue; }
+				uint64_t oldestNew = std::max(incoming.merged, incoming.received - std::min<uint64_t>(incoming.received, HistoryLength));
+				Clock::time_point tOldest = CaptureTime(incoming.history[oldestNew % HistoryLength]);
+				if(tOldest < tReference) { tReference = tOldest; }
+			}
+
+			// No frames, or none for staleAfter => contributes nothing
+			Clock::time_point tNow = Clock::now();
+			for(auto& system : this->systems)
+			{
+				auto& incoming = system->incoming;
+				bool IsStale = incoming.received > 0 && tNow - incoming.tArrived >= this->settings.staleAfter;
+				if(incoming.received == 0 || IsStale) { system->chosen.BeginRefill(0); system->chosen.EndRefill(); continue; }
+
+				// Nearest of the held frames (count = number of the frame since connecting)
+				uint64_t numHeld = std::min<uint64_t>(incoming.received, HistoryLength);
+				uint64_t best = incoming.received - 1;
+				auto bestDistance = Clock::duration::max();
+				for(uint64_t count = incoming.received - numHeld; count < incoming.received; ++count)
+				{
+					auto distance = CaptureTime(incoming.history[count % HistoryLength]) - tReference;
+					if(distance < Clock::duration::zero()) { distance = -distance; }
+					if(distance < bestDistance) { bestDistance = distance; best = count; }
+				}
+
+				if(best < incoming.merged) { ++system->staleMerges; }
+				incoming.merged = std::max(incoming.merged, best + 1);
+				system->chosen = incoming.history[best % HistoryLength];
+				system->skew.Add(double(std::chrono::duration_cast<std::chrono::nanoseconds>(bestDistance).count()));
+			}
+			return tReference;
+		}
+
+		// PURPOSE: Merge the chosen frames into the back buffer, and publish it
+		void Merge(Clock::time_point tReference)
+		{
+			vdsi::Points& merged = this->LatestFrame.Back();
+			merged.BeginRefill(unsigned(this->stats_FramesMerged + 1));
+			std::fill(this->slotByHandle.begin(), this->slotByHandle.end(), UINT32_MAX);
+			uint32_t numMerged = 0;
+			Clock::time_point tReceived;
+
+			for(size_t idxS = 0; idxS < this->systems.size(); ++idxS)
+			{
+				auto& system = *this->systems[idxS];
+				if(system.chosen.timing.tReceived > tReceived) { tReceived = system.chosen.timing.tReceived; }
+
+				for(auto& point : system.chosen.all)
+				{
+					vdsi::SubjectHandle handle = this->MergedHandle(system, point);
+					if(handle.id >= this->slotByHandle.size()) { this->slotByHandle.resize(handle.id + 1, UINT32_MAX); }
+
+					// Seen already (by an earlier system)? Keep the first unoccluded
+					if(this->settings.IsMergeSameName && this->slotByHandle[handle.id] != UINT32_MAX)
+					{
+						auto& existing = merged.all[this->slotByHandle[handle.id]];
+						if( ! existing.IsOccluded || point.IsOccluded ) { continue; }
+						this->Place(existing, point, system, idxS, handle);
+						continue;
+					}
+
+					this->slotByHandle[handle.id] = numMerged++;
+					this->Place(merged.RefillNext(), point, system, idxS, handle);
+				}
+			}
+			merged.EndRefill();
+
+			// Timing: capture = reference time
+			merged.timing = vdsi::FrameTiming();
+			merged.timing.tReceived = tReceived;
+			merged.timing.latencySDK = std::chrono::duration<double>(tReceived - tReference).count();
+			merged.timing.tDecoded = Clock::now();
+
+			this->LatestFrame.Publish();
+			++this->stats_FramesMerged;
+			this->FrameReady.Set();
+		}
+
+		// OUTPUT: Handle in the merged frame of the point's name
+		vdsi::SubjectHandle MergedHandle(System& system, const vdsi::Point_Object& point)
+		{
+			if( ! point.handle.IsValid() ) { return this->Names.Intern(point.viconObjectName); }
+			auto& byId = system.mergedHandleById;
+			if(point.handle.id >= byId.size()) { byId.resize(point.handle.id + 1); }
+			if( ! byId[point.handle.id].IsValid() ) { byId[point.handle.id] = this->Names.Intern(point.viconObjectName); }
+			return byId[point.handle.id];
+		}
+
+		// PURPOSE: Copy point into out (reusing its storage), tagged and transformed into the common frame
+		static void Place(vdsi::Point_Object& out, const vdsi::Point_Object& point, const System& system, size_t idxSystem, vdsi::SubjectHandle handle)
+		{
+			out = point;
+			out.handle = handle;
+			out.source = uint16_t(idxSystem);
+			out.generation = 0;
+			if( ! system.HasTransform ) { return; }
+
+			auto& R = system.R;
+			auto Transform = [&](vdsi::Translation& P) {
+				vdsi::Translation P_in = P;
+				for(int row = 0; row < 3; ++row) { P[row] = R[3*row]*P_in[0] + R[3*row + 1]*P_in[1] + R[3*row + 2]*P_in[2] + system.P0[row]; }
+			};
+			Transform(out.P);
+			vdsi::RotationMatrix R_in = out.R_rowMajor;
+			for(int row = 0; row < 3; ++row)
+			{
+				for(int col = 0; col < 3; ++col)
+				{
+					out.R_rowMajor[3*row + col] = R[3*row]*R_in[col] + R[3*row + 1]*R_in[3 + col] + R[3*row + 2]*R_in[6 + col];
+				}
+			}
+			for(auto& marker : out.markers) { Transform(marker.P); }
+		}
+	};
+}
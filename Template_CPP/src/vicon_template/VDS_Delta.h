@@ -0,0 +1,145 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Delta mode: deliver only the objects that changed since the consumer's last read
+		Many objects in a large scene are static fixtures. Skipping them cuts the copying and processing downstream
+	Used through VDS_Interface::EnableDeltaMode() and GetFrameDelta()
+
+Class Summary:
+	DeltaSettings
+		Thresholds on the change in position and rotation
+
+	ChangeTracker
+		Run by the update thread on each frame
+		Stamps each object with a generation counter (Point_Object::generation)
+		The generation is incremented when the object's occlusion flips, or it has moved beyond the thresholds
+			Compared with its pose at the last increment, so slow drift still adds up to a change
+		Only sees the objects in the frame => needs the occluded filter disabled
+			Otherwise an object that becomes occluded is removed before Stamp(), and the flip is never reported
+
+	DeltaCursor
+		Read position of one consumer: the generation of each object it last received
+		Everything with a newer generation has changed since its last read, however many frames it skipped
+
+*/
+#pragma once
+
+// Brandon's VDS Interface helpers
+#include "VDS_Points.h"
+#include "VDS_NameRegistry.h"
+
+// Standard library
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+
+namespace vdsi
+{
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Thresholds of a change
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	struct DeltaSettings
+	{
+		// Smallest change of position [mm] (Vicon units), and of rotation [rad], that counts as moved
+		//	0 = any change at all
+		double positionThreshold = 0.5;
+		double rotationThreshold = 0.005;
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Generation counter per object (update thread)
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	class ChangeTracker
+	{
+	private:
+		// Pose of the object at its last generation
+		struct Reported
+		{
+			uint32_t generation = 0;
+			bool IsOccluded = true;
+			vdsi::RotationMatrix R = vdsi::RotationMatrix_NaN;
+			vdsi::Translation P = vdsi::Translation_NaN;
+		};
+		std::vector<Reported> reportedByHandle;
+
+	public:
+		// PURPOSE: Set Point_Object::generation of every object in the frame
+		//	Objects missing from the frame keep their generation (so don't remove occluded objects before this)
+		void Stamp(vdsi::Points& frame, const vdsi::DeltaSettings& settings)
+		{
+			// Compare squared distance, and the trace of R_old' * R_new (= 1 + 2 cos(angle)), to avoid sqrt and acos
+			double positionThreshold2 = settings.positionThreshold * settings.positionThreshold;
+			double traceThreshold = 1 + 2 * std::cos(settings.rotationThreshold);
+
+			for(auto& point : frame.all)
+			{
+				if( ! point.handle.IsValid() ) { continue; }
+				if(point.handle.id >= this->reportedByHandle.size()) { this->reportedByHandle.resize(point.handle.id + 1); }
+				Reported& reported = this->reportedByHandle[point.handle.id];
+
+				bool IsChanged = reported.generation == 0 || point.IsOccluded != reported.IsOccluded;
+				if( ! IsChanged && ! point.IsOccluded )
+				{
+					double distance2 = 0;
+					for(int idx = 0; idx < 3; ++idx) { distance2 += (point.P[idx] - reported.P[idx]) * (point.P[idx] - reported.P[idx]); }
+					double trace = 0;
+					for(int idx = 0; idx < 9; ++idx) { trace += point.R_rowMajor[idx] * reported.R[idx]; }
+					IsChanged = distance2 > positionThreshold2 || trace < traceThreshold;
+				}
+
+				if(IsChanged)
+				{
+					++reported.generation;
+					reported.IsOccluded = point.IsOccluded;
+					reported.R = point.R_rowMajor;
+					reported.P = point.P;
+				}
+				point.generation = reported.generation;
+			}
+		}
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Read position of one consumer
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// One per consumer thread. A new cursor receives every object on its first read
+	class DeltaCursor
+	{
+	private:
+		std::vector<uint32_t> generationByHandle;
+
+	public:
+		// PURPOSE: Copy the objects of frame that changed since this cursor last saw them, and mark them as seen
+		// OUTPUT: changed = refilled with the changed objects (frame number and timing of frame)
+		void Extract(const vdsi::Points& frame, vdsi::Points& changed)
+		{
+			changed.BeginRefill(frame.frameNumber);
+			for(auto& point : frame.all)
+			{
+				// Objects without a handle can't be tracked => always changed
+				if(point.handle.IsValid())
+				{
+					if(point.handle.id >= this->generationByHandle.size()) { this->generationByHandle.resize(point.handle.id + 1, 0); }
+					uint32_t& seen = this->generationByHandle[point.handle.id];
+					if(point.generation != 0 && point.generation == seen) { continue; }
+					seen = point.generation;
+				}
+
+				// Copy assignment reuses the storage of the old point
+				changed.RefillNext() = point;
+			}
+			changed.EndRefill();
+			changed.timing = frame.timing;
+		}
+
+		// PURPOSE: Forget what was seen, so that the next read receives every object
+		void Reset() { this->generationByHandle.clear(); }
+	};
+}
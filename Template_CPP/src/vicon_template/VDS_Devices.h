@@ -0,0 +1,224 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Device channels (force plates, analog inputs) and unlabeled markers
+		Devices send many subsamples per Vicon frame (e.g. 1000 Hz force plate => 10 per frame at 100 Hz)
+		and a scene can have hundreds of unlabeled markers
+		=> stored as flat arrays of doubles per frame, rather than one object per value (as Points does for subjects)
+	Used through VDS_Interface::EnableDeviceData(), GetDeviceFrame() and GetDeviceFrames()
+
+Class Summary:
+	DeviceSettings
+		Which data to decode, and the capacity of the queue of device frames
+
+	DeviceInfo, DeviceLayout
+		Names and shape of each device: channels (output.component) and subsamples per frame
+		Rebuilt by the frame source only when the devices change, and shared by all frames with that layout
+
+	DeviceFrame
+		The device data and unlabeled markers of one Vicon frame
+		values = all devices, each a block of (subsamples x channels), subsample major
+		unlabeled = (markers x 3) positions [mm]
+
+	DeviceRowWriter
+		Rows for CSV_Exporter / Binary_Exporter: one row per subsample of a device, or per unlabeled marker
+		Each device is written to its own file, as devices differ in channels and subsamples
+
+*/
+#pragma once
+
+// Brandon's VDS Interface helpers
+#include "VDS_Points.h"
+
+// Standard library
+#include <string>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+
+namespace vdsi
+{
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Settings
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	struct DeviceSettings
+	{
+		// Decode device channels (force plates, analog inputs)
+		// Decode unlabeled markers
+		bool IsDeviceData = true;
+		bool IsUnlabeledMarkers = true;
+
+		// Maximum number of device frames held for GetDeviceFrames(). Frames arriving while full are dropped and counted
+		//	e.g. 2 seconds of frames => 2*GetFrameRate()
+		size_t queueCapacity = 256;
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Layout of the devices
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	struct DeviceInfo
+	{
+		// Name of the device
+		// Name of each channel ("output.component", e.g. "Force.Fx")
+		// Subsamples per Vicon frame
+		// Index of the first value of the device in DeviceFrame::values
+		std::string name;
+		std::vector<std::string> channelNames;
+		unsigned int numSamples = 0;
+		size_t offset = 0;
+
+		size_t NumChannels() const { return this->channelNames.size(); }
+		size_t NumValues() const { return this->numSamples * this->channelNames.size(); }
+	};
+
+	struct DeviceLayout
+	{
+		std::vector<vdsi::DeviceInfo> devices;
+		size_t numValues = 0;
+
+		// PURPOSE: Append a device, placed after the previous devices in DeviceFrame::values
+		void Add(const std::string& name, const std::vector<std::string>& channelNames, unsigned int numSamples)
+		{
+			vdsi::DeviceInfo device;
+			device.name = name;
+			device.channelNames = channelNames;
+			device.numSamples = numSamples;
+			device.offset = this->numValues;
+			this->numValues += device.NumValues();
+			this->devices.push_back(device);
+		}
+
+		// OUTPUT: Index of the device, or -1 if there is none of that name
+		int IndexOf(const std::string& name) const
+		{
+			auto it = std::find_if(this->devices.begin(), this->devices.end(), [&name](const vdsi::DeviceInfo& device) { return device.name == name; });
+			return (it == this->devices.end()) ? -1 : int(it - this->devices.begin());
+		}
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Device data and unlabeled markers of one frame
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Copy assignment reuses the storage of the vectors, and shares the layout (no names are copied)
+	struct DeviceFrame
+	{
+		// VDS frame number (same as the Points of the same frame)
+		// Host time: the frame was received by the update thread (same clock as FrameTiming)
+		unsigned int frameNumber = 0;
+		vdsi::FrameTiming::Clock::time_point tReceived;
+
+		// Names and shape of the devices (nullptr = no devices)
+		// Values of all devices: device d, subsample s, channel c at values[offset_d + s*numChannels_d + c]. NaN = occluded
+		std::shared_ptr<const vdsi::DeviceLayout> layout;
+		std::vector<double> values;
+
+		// Unlabeled markers: positions [mm] as (x,y,z) triples, and the ID of each marker given by the SDK
+		std::vector<double> unlabeled;
+		std::vector<unsigned int> unlabeledIds;
+
+		//********************************************************************************
+		// Interface: Devices
+		//****************************************
+		size_t NumDevices() const { return this->layout ? this->layout->devices.size() : 0; }
+		const vdsi::DeviceInfo& Device(size_t idxDevice) const { return this->layout->devices[idxDevice]; }
+
+		// OUTPUT: The (subsamples x channels) block of a device, subsample major
+		const double* Samples(size_t idxDevice) const { return this->values.data() + this->Device(idxDevice).offset; }
+
+		double Value(size_t idxDevice, size_t idxSample, size_t idxChannel) const
+		{
+			return this->Samples(idxDevice)[idxSample * this->Device(idxDevice).NumChannels() + idxChannel];
+		}
+
+		//********************************************************************************
+		// Interface: Unlabeled markers
+		//****************************************
+		size_t NumUnlabeled() const { return this->unlabeledIds.size(); }
+
+		vdsi::Translation UnlabeledP(size_t idxMarker) const
+		{
+			const double* P = this->unlabeled.data() + 3*idxMarker;
+			return { P[0], P[1], P[2] };
+		}
+
+		// PURPOSE: Add an unlabeled marker (for frame sources)
+		void AddUnlabeled(unsigned int id, const double (&P)[3])
+		{
+			this->unlabeled.insert(this->unlabeled.end(), P, P + 3);
+			this->unlabeledIds.push_back(id);
+		}
+
+		// PURPOSE: Empty the frame, keeping the storage (for frame sources)
+		void Clear()
+		{
+			this->layout.reset();
+			this->values.clear();
+			this->unlabeled.clear();
+			this->unlabeledIds.clear();
+		}
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Rows for export
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Rows are built as one block, written with one call (ExportBinary::AddRows)
+	//	Device file: one row per subsample = frameNumber, subsample, then each channel
+	//	Unlabeled marker file: one row per marker = frameNumber, id, x, y, z
+	class DeviceRowWriter
+	{
+	public:
+		static std::vector<std::string> DeviceColumnNames(const vdsi::DeviceInfo& device)
+		{
+			std::vector<std::string> columnNames = { "frameNumber", "subsample" };
+			for(auto& channel : device.channelNames) { columnNames.push_back(device.name + "." + channel); }
+			return columnNames;
+		}
+
+		static std::vector<std::string> UnlabeledColumnNames() { return { "frameNumber", "id", "x", "y", "z" }; }
+
+		// INPUT: frameNumber = value of the first column (e.g. offset to start at 1, as in the templates)
+		// OUTPUT:
+		//	rows = the rows of every subsample of the device, one after another
+		//		The vector is never shrunk, so that its storage is reused when passed in again
+		//	return = number of rows
+		static size_t WriteDevice(const vdsi::DeviceFrame& frame, size_t idxDevice, double frameNumber, std::vector<double>& rows)
+		{
+			const vdsi::DeviceInfo& device = frame.Device(idxDevice);
+			const double* samples = frame.Samples(idxDevice);
+			size_t numChannels = device.NumChannels();
+			size_t numColumns = 2 + numChannels;
+			if(rows.size() < device.numSamples * numColumns) { rows.resize(device.numSamples * numColumns); }
+
+			for(size_t idxSample = 0; idxSample < device.numSamples; ++idxSample)
+			{
+				double* row = rows.data() + idxSample * numColumns;
+				row[0] = frameNumber;
+				row[1] = double(idxSample);
+				std::copy(samples + idxSample * numChannels, samples + (idxSample + 1) * numChannels, row + 2);
+			}
+			return device.numSamples;
+		}
+
+		static size_t WriteUnlabeled(const vdsi::DeviceFrame& frame, double frameNumber, std::vector<double>& rows)
+		{
+			size_t numMarkers = frame.NumUnlabeled();
+			if(rows.size() < numMarkers * 5) { rows.resize(numMarkers * 5); }
+
+			for(size_t idxMarker = 0; idxMarker < numMarkers; ++idxMarker)
+			{
+				double* row = rows.data() + idxMarker * 5;
+				row[0] = frameNumber;
+				row[1] = double(frame.unlabeledIds[idxMarker]);
+				std::copy(frame.unlabeled.data() + 3*idxMarker, frame.unlabeled.data() + 3*idxMarker + 3, row + 2);
+			}
+			return numMarkers;
+		}
+	};
+}
@@ -0,0 +1,386 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Interface for a list of objects that is known when compiling (e.g. the NAME_MyViconObject constants of the templates)
+	The names are template arguments, so the frame has one fixed slot per object
+		frame.get<"Jackal">() is an array index, resolved by the compiler. A misspelt name does not compile
+		The reader handles no strings per frame: the names are resolved to handles once, when created, and the frame is one plain struct
+		The CSV / binary row has a column count known when compiling. It is filled, and added to ExportCSV / ExportBinary, without allocating
+
+	Direct decode (default): the update thread of the underlying VDS_Interface decodes only the poses of the listed objects, straight into the fixed frame
+		With Connect(HostName), the SDK names of each object are cached once per change of the scene => no strings are handled per frame, and no vdsi::Points is made
+		Other frame sources (synthetic, replay) decode a vdsi::Points and pick the objects from it (see FrameSource::DecodePoses)
+		The modes of Interface() that take a vdsi::Points frame (GetFrame, subscriptions, relay, ...) then get no frames
+	Points decode (IsDirectDecode = false): the fixed frame is filled from each vdsi::Points frame of VDS_Interface, so all its modes still work
+
+	Example
+		vdsi::VDS_Fixed<"Jackal", "bj_ctrl"> VDS;
+		VDS.Connect("192.168.11.3");
+		auto frame = VDS.GetFrame();
+		auto& jackal = frame.get<"Jackal">();
+
+Class Summary:
+	FixedName
+		String literal as a template argument
+
+	FixedPose
+		Pose of one object (no name, no markers). In VDS_Points.h
+
+	FixedFrame<Names...>
+		One FixedPose per name, in the order of the names
+
+	VDS_Fixed<Names...>
+		VDS_Interface that delivers FixedFrame
+
+	FixedRowWriter<Frame>
+		Row of the CSV / binary recording of a FixedFrame (same columns as vds_template_3, without markers)
+
+*/
+#pragma once
+
+// Brandon's VDS Interface helpers
+#include "VDS_Interface.h"
+
+// Standard library
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <array>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <cstddef>
+
+
+namespace vdsi
+{
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// String literal as a template argument
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	template<size_t N>
+	struct FixedName
+	{
+		char chars[N] = {};
+
+		constexpr FixedName(const char (&name)[N])
+		{
+			for(size_t idx = 0; idx < N; ++idx) { this->chars[idx] = name[idx]; }
+		}
+
+		constexpr std::string_view View() const { return std::string_view(this->chars, N - 1); }
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Frame of a fixed list of objects
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Trivially copyable: copying a frame is one memcpy
+	template<vdsi::FixedName... Names>
+	class FixedFrame
+	{
+	public:
+		static constexpr size_t NumObjects = sizeof...(Names);
+		static constexpr std::array<std::string_view, NumObjects> ObjectNames = { Names.View()... };
+
+	private:
+		static constexpr size_t NotFound = NumObjects;
+
+		static constexpr size_t Find(std::string_view name)
+		{
+			for(size_t idx = 0; idx < NumObjects; ++idx)
+			{
+				if(ObjectNames[idx] == name) { return idx; }
+			}
+			return NotFound;
+		}
+
+		static constexpr bool IsUnique()
+		{
+			for(size_t idx = 0; idx < NumObjects; ++idx)
+			{
+				if(Find(ObjectNames[idx]) != idx) { return false; }
+			}
+			return true;
+		}
+		static_assert(NumObjects > 0, "ERROR_VDS: FixedFrame needs at least one object name");
+		static_assert(IsUnique(), "ERROR_VDS: FixedFrame object names must be unique");
+
+	public:
+		// One pose per name, in the order of the names
+		// VDS Frame number, and timestamps (same as Points)
+		std::array<vdsi::FixedPose, NumObjects> objects;
+		unsigned int frameNumber = 0;
+		vdsi::FrameTiming timing;
+
+		//********************************************************************************
+		// Interface: Get
+		//****************************************
+		// OUTPUT: Index of the name in objects. Does not compile if the name is not in the list
+		template<vdsi::FixedName Name>
+		static constexpr size_t IndexOf()
+		{
+			constexpr size_t idx = Find(Name.View());
+			static_assert(idx != NotFound, "ERROR_VDS: Object name is not in the list of this FixedFrame");
+			return idx;
+		}
+
+		// OUTPUT: Pose of the object. Occluded if it was not in the frame
+		template<vdsi::FixedName Name>
+		const vdsi::FixedPose& get() const { return this->objects[IndexOf<Name>()]; }
+
+		template<vdsi::FixedName Name>
+		vdsi::FixedPose& get() { return this->objects[IndexOf<Name>()]; }
+
+		//********************************************************************************
+		// Interface: Set
+		//****************************************
+		// PURPOSE: Fill from a frame of VDS_Interface
+		// INPUT:
+		//	frame = any frame (the objects may be in any order, and other objects are ignored)
+		//	handles = handle of each name, in the order of the names
+		void Fill(const vdsi::Points& frame, const std::array<vdsi::SubjectHandle, NumObjects>& handles)
+		{
+			this->frameNumber = frame.frameNumber;
+			this->timing = frame.timing;
+			for(size_t idx = 0; idx < NumObjects; ++idx)
+			{
+				auto& out = this->objects[idx];
+				const vdsi::Point_Object* point = frame.Find(handles[idx]);
+				if(point)
+				{
+					out.R_rowMajor = point->R_rowMajor;
+					out.P = point->P;
+					out.IsOccluded = point->IsOccluded;
+				}
+				else { out = vdsi::FixedPose(); }
+			}
+		}
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Interface to VDS for a fixed list of objects
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Direct decode: the update thread decodes the poses straight into the back buffer (VDS_Interface::EnableDirectPoses)
+	// Points decode: the update thread fills a FixedFrame from each decoded frame (Inline subscription)
+	// Either way, GetFrame() copies only the fixed frame
+	// The object filter is set to the names, so other objects are not decoded
+	template<vdsi::FixedName... Names>
+	class VDS_Fixed : private vdsi::DirectPoseTarget
+	{
+	public:
+		using Frame = vdsi::FixedFrame<Names...>;
+
+	private:
+		vdsi::VDS_Interface VDS;
+		std::array<vdsi::SubjectHandle, Frame::NumObjects> handles;
+		bool IsDirectDecode;
+		vdsi::SubscriptionId subscription = 0;
+
+		// Latest frame, handed from the update thread to GetFrame() (as in VDS_Interface)
+		vdsi::TripleBuffer<Frame> LatestFrame;
+		std::mutex mtx_Readers;
+		vdsi::FrameSignal FrameReady;
+
+		// User settings: How GetFrame() waits for a frame
+		std::atomic<vdsi::WaitPolicy> Wait_Policy = vdsi::WaitPolicy::Spin;
+		std::atomic<int64_t> Wait_TimeoutNs = 0;
+
+	public:
+		//********************************************************************************
+		// Interface: Create
+		//****************************************
+		// INPUT: IsDirectDecode_in = decode only the poses, straight into the fixed frame (see the purpose above)
+		VDS_Fixed(bool IsDirectDecode_in = true) :
+			IsDirectDecode(IsDirectDecode_in)
+		{
+			for(size_t idx = 0; idx < Frame::NumObjects; ++idx)
+			{
+				this->handles[idx] = this->VDS.GetHandle(std::string(Frame::ObjectNames[idx]));
+			}
+
+			if(this->IsDirectDecode)
+			{
+				this->VDS.EnableDirectPoses(this->ObjectNames(), *this);
+				return;
+			}
+
+			vdsi::SubscriptionSettings settings;
+			settings.mode = vdsi::CallbackMode::Inline;
+			this->subscription = this->VDS.Subscribe([this](const vdsi::Points& frame) {
+				this->LatestFrame.Back().Fill(frame, this->handles);
+				this->LatestFrame.Publish();
+				this->FrameReady.Set();
+			}, settings);
+		}
+
+		~VDS_Fixed()
+		{
+			this->VDS.Disconnect();
+			if( ! this->IsDirectDecode ) { this->VDS.Unsubscribe(this->subscription); }
+		}
+
+		VDS_Fixed(const VDS_Fixed&) = delete;
+		VDS_Fixed& operator=(const VDS_Fixed&) = delete;
+
+		//********************************************************************************
+		// Interface: Connect / Disconnect
+		//****************************************
+		// PURPOSE: Same as VDS_Interface::Connect(). The object filter is set to the names (direct decode: and only the poses are decoded)
+		void Connect(std::string HostName = "localhost:801", bool EnableLightweight = false)
+		{
+			this->SetObjectFilter();
+			this->VDS.Connect(HostName, EnableLightweight);
+		}
+
+		void Connect(std::unique_ptr<vdsi::FrameSource> source)
+		{
+			this->SetObjectFilter();
+			this->VDS.Connect(std::move(source));
+		}
+
+		void Disconnect() { this->VDS.Disconnect(); }
+
+		// OUTPUT: The underlying interface, for its other settings and modes (e.g. GetStats, EnableDeviceData. Points decode: also EnableUdpRelay, Subscribe, ...)
+		vdsi::VDS_Interface& Interface() { return this->VDS; }
+
+		// PURPOSE: Choose how GetFrame() waits for a frame (see VDS_Interface::SetWaitPolicy)
+		void SetWaitPolicy(vdsi::WaitPolicy policy, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::zero())
+		{
+			this->Wait_Policy = policy;
+			this->Wait_TimeoutNs = timeout.count();
+		}
+
+		//********************************************************************************
+		// Interface: Get data frames
+		//****************************************
+		double GetFrameRate() { return this->VDS.GetFrameRate(); }
+
+		// PURPOSE: Latest frame (waits for the first one)
+		//	End of a recording (see VDS_Interface::IsEndOfStream): does not wait
+		//	Points decode: a reader already waiting when the recording ends is only woken by the timeout (see SetWaitPolicy)
+		// OUTPUT:
+		//	frame = the latest frame
+		//	return = false if the wait timed out, or the recording has ended and no new frame was taken (frame is then the previous frame again)
+		bool TryGetFrame(Frame& frame)
+		{
+			bool IsEnded = this->VDS.IsEndOfStream();
+			bool IsReady = ! IsEnded && this->FrameReady.Wait(this->Wait_Policy, std::chrono::nanoseconds(this->Wait_TimeoutNs));
+
+			std::lock_guard<std::mutex> lock(this->mtx_Readers);
+			bool IsNew = this->LatestFrame.Update();
+			frame = this->LatestFrame.Front();
+			frame.timing.tPickup = vdsi::FrameTiming::Clock::now();
+			return this->VDS.IsEndOfStream() ? IsNew : IsReady;
+		}
+
+		void GetFrame(Frame& frame)
+		{
+			if( this->TryGetFrame(frame) ) { return; }
+			if( this->VDS.IsEndOfStream() ) { std::cout << "WARNING_VDS: (VDS_Fixed::GetFrame) End of the frame source, no new frame" << std::endl; }
+			else                            { std::cout << "WARNING_VDS: (VDS_Fixed::GetFrame) Timed out waiting for a frame" << std::endl; }
+		}
+
+		Frame GetFrame()
+		{
+			Frame frame;
+			this->GetFrame(frame);
+			return frame;
+		}
+
+		// PURPOSE: Same as GetFrame() but blocks until the next frame arrives
+		void GetFrame_WaitForNew(Frame& frame)
+		{
+			this->FrameReady.Clear();
+			this->GetFrame(frame);
+		}
+
+		Frame GetFrame_WaitForNew()
+		{
+			this->FrameReady.Clear();
+			return this->GetFrame();
+		}
+
+	private:
+		static std::vector<std::string> ObjectNames() { return std::vector<std::string>(Frame::ObjectNames.begin(), Frame::ObjectNames.end()); }
+
+		void SetObjectFilter()
+		{
+			this->VDS.EnableObjectFilter(this->ObjectNames());
+			this->VDS.DisableOccludedFilter();
+
+			// Direct decode: no markers (with the SDK, the Vicon PC then sends none)
+			if(this->IsDirectDecode)
+			{
+				vdsi::ProjectionSettings projection;
+				projection.otherSubjects = vdsi::DecodeFields::Pose;
+				this->VDS.EnableDecodeProjection(projection);
+			}
+		}
+
+		// Direct decode (called by the update thread)
+		vdsi::FixedPose* BeginPoses() override { return this->LatestFrame.Back().objects.data(); }
+
+		void CommitPoses(unsigned int frameNumber, const vdsi::FrameTiming& timing) override
+		{
+			Frame& frame = this->LatestFrame.Back();
+			frame.frameNumber = frameNumber;
+			frame.timing = timing;
+			this->LatestFrame.Publish();
+			this->FrameReady.Set();
+		}
+
+		void EndOfPoses() override { this->FrameReady.Set(); }
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Row of a recording of a FixedFrame
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Columns: FrameNumber, then for each object: R11..R33, P1..P3 (same as vds_template_3, without markers)
+	// Use with csv_exporter::ExportCSV or binary_exporter::ExportBinary:
+	//	ExportCSV.AddHeader(Writer::ColumnNames());           ExportCSV.AddRow(row);
+	//	ExportBinary.AddHeader(Writer::ColumnNames(), ...);  ExportBinary.AddRow(row);
+	template<class Frame>
+	class FixedRowWriter
+	{
+	public:
+		static constexpr size_t ColumnsPerObject = 12;
+		static constexpr size_t NumColumns = 1 + ColumnsPerObject * Frame::NumObjects;
+		using Row = std::array<double, NumColumns>;
+
+		// OUTPUT: Header row
+		static std::vector<std::string> ColumnNames()
+		{
+			static constexpr std::array<const char*, ColumnsPerObject> elementNames = { "R11","R12","R13", "R21","R22","R23", "R31","R32","R33", "P1","P2","P3" };
+
+			std::vector<std::string> names;
+			names.reserve(NumColumns);
+			names.push_back("FrameNumber");
+			for(auto& object : Frame::ObjectNames)
+			{
+				for(auto& element : elementNames) { names.push_back(std::string(object) + "_" + element); }
+			}
+			return names;
+		}
+
+		// PURPOSE: Fill row from frame
+		// INPUT: frameNumber = value of the first column (e.g. the frame number counted from the start of the recording)
+		static void Write(const Frame& frame, double frameNumber, Row& row)
+		{
+			row[0] = frameNumber;
+			for(size_t idx = 0; idx < Frame::NumObjects; ++idx)
+			{
+				auto& pose = frame.objects[idx];
+				double* out = &row[1 + ColumnsPerObject * idx];
+				for(size_t element = 0; element < 9; ++element) { out[element] = pose.R_rowMajor[element]; }
+				for(size_t element = 0; element < 3; ++element) { out[9 + element] = pose.P[element]; }
+			}
+		}
+	};
+}
@@ -0,0 +1,240 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Pass frames from the update thread to the user threads without the update thread ever waiting
+
+Class Summary:
+	TripleBuffer
+		Wait-free single producer handoff of the latest value
+		The producer writes into a back buffer and publishes it by swapping with the middle buffer
+		The reader takes the middle buffer by swapping it with its front buffer
+		=> Neither side waits for the other, and the reader never sees a partially written value
+
+	WaitPolicy
+		How a reader waits for the next frame: spin, spin then yield, or block
+
+	FrameSignal
+		Flag set by the update thread when a frame is ready, which readers can wait on with a WaitPolicy and timeout
+		Setting the flag never blocks the update thread unless a reader is blocked on it
+
+	SnapshotPool
+		Immutable, reference counted copies of a value, for any number of readers to hold at once
+		A copy is refilled once no reader holds it any more, so its storage is reused
+
+*/
+#pragma once
+
+// Standard library
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <condition_variable>
+
+
+namespace vdsi
+{
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Wait-free triple buffer
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// One producer thread and one reader at a time
+	//	If there are multiple reader threads, they must serialise between themselves
+	//	(this never blocks the producer)
+	template<class T>
+	class TripleBuffer
+	{
+	private:
+		// Index of the middle buffer, plus a flag set when it holds a value the reader has not yet taken
+		static constexpr uint8_t IndexMask = 0b011;
+		static constexpr uint8_t FreshBit  = 0b100;
+
+		std::array<T, 3> buffers;
+		std::atomic<uint8_t> middle = 1;
+		uint8_t back = 0;  // Only accessed by the producer
+		uint8_t front = 2; // Only accessed by the reader
+
+	public:
+		//********************************************************************************
+		// Interface: Producer
+		//****************************************
+		// OUTPUT: The buffer to write the next value into
+		//	It holds an old value, which can be overwritten in place to reuse its storage
+		T& Back() { return this->buffers[this->back]; }
+
+		// PURPOSE: Make the back buffer visible to the reader
+		void Publish()
+		{
+			this->back = this->middle.exchange(this->back | FreshBit, std::memory_order_acq_rel) & IndexMask;
+		}
+
+		//********************************************************************************
+		// Interface: Reader
+		//****************************************
+		// PURPOSE: Take the most recently published value, if there is one
+		// OUTPUT: true if Front() changed
+		bool Update()
+		{
+			if( ! (this->middle.load(std::memory_order_relaxed) & FreshBit) ) { return false; }
+			this->front = this->middle.exchange(this->front, std::memory_order_acq_rel) & IndexMask;
+			return true;
+		}
+
+		// OUTPUT: The most recent value taken by Update()
+		const T& Front() const { return this->buffers[this->front]; }
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// How to wait for the next frame
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	//	Spin
+	//		Busy wait. Lowest wake-up latency, but uses a full CPU core while waiting
+	//	SpinYield
+	//		Busy wait for a short time, then yield the CPU to other threads between checks
+	//		Low latency when frames arrive quickly, but still shows as CPU load
+	//	Block
+	//		Sleep until woken by the update thread. Uses no CPU while waiting,
+	//		but wake-up is left to the OS scheduler (typically some 10s of microseconds)
+	enum class WaitPolicy
+	{
+		Spin,
+		SpinYield,
+		Block
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Frame ready flag that can be waited on
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	class FrameSignal
+	{
+	private:
+		std::atomic<bool> IsReady = false;
+
+		// Blocked waiters
+		//	The update thread only touches the mutex if someone is blocked
+		std::atomic<int> NumBlocked = 0;
+		std::mutex mtx_Blocked;
+		std::condition_variable cv_Blocked;
+
+	public:
+		// Time to busy wait before yielding (WaitPolicy::SpinYield)
+		static constexpr std::chrono::microseconds SpinDuration{50};
+
+		//********************************************************************************
+		// Interface: Set / Clear
+		//****************************************
+		void Set()
+		{
+			this->IsReady = true;
+			if(this->NumBlocked > 0)
+			{
+				// Taking the mutex guarantees a waiter is either about to re-check IsReady, or is asleep and will be notified
+				{ std::lock_guard<std::mutex> lock(this->mtx_Blocked); }
+				this->cv_Blocked.notify_all();
+			}
+		}
+
+		void Clear() { this->IsReady = false; }
+		bool IsSet() const { return this->IsReady; }
+
+		//********************************************************************************
+		// Interface: Wait
+		//****************************************
+		// PURPOSE: Wait until the flag is set
+		// INPUT:
+		//	policy = how to wait
+		//	timeout = give up after this long. Zero = wait forever
+		// OUTPUT: true if the flag is set, false on timeout
+		bool Wait(vdsi::WaitPolicy policy, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::zero())
+		{
+			if(this->IsReady) { return true; }
+
+			using Clock = std::chrono::steady_clock;
+			bool HasTimeout = timeout > std::chrono::nanoseconds::zero();
+			auto tStart = Clock::now();
+			auto tTimeout = tStart + timeout;
+
+			switch(policy)
+			{
+			case vdsi::WaitPolicy::Spin:
+				//	NOTE:
+				//		The following does not work (On Windows at least, it sleeps way longer than it should)
+				//		std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+				//		==> Instead, use a no-op
+				//		((void)0);
+				while( ! this->IsReady )
+				{
+					if(HasTimeout && Clock::now() >= tTimeout) { return false; }
+				}
+				return true;
+
+			case vdsi::WaitPolicy::SpinYield:
+				while( ! this->IsReady )
+				{
+					auto tNow = Clock::now();
+					if(HasTimeout && tNow >= tTimeout) { return false; }
+					if(tNow - tStart > SpinDuration) { std::this_thread::yield(); }
+				}
+				return true;
+
+			case vdsi::WaitPolicy::Block:
+			default:
+			{
+				this->NumBlocked++;
+				std::unique_lock<std::mutex> lock(this->mtx_Blocked);
+				bool WasSet = true;
+				if(HasTimeout) { WasSet = this->cv_Blocked.wait_until(lock, tTimeout, [this] { return this->IsReady.load(); }); }
+				else           { this->cv_Blocked.wait(lock, [this] { return this->IsReady.load(); }); }
+				lock.unlock();
+				this->NumBlocked--;
+				return WasSet;
+			}
+			}
+		}
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Pool of immutable snapshots
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// One producer thread. Readers only hold and release the returned pointers
+	//	Once warmed up, taking a snapshot only copies the value (the copy assignment reuses the storage of the old snapshot)
+	template<class T>
+	class SnapshotPool
+	{
+	private:
+		std::vector<std::shared_ptr<T>> snapshots;
+		size_t maxPooled;
+
+	public:
+		// INPUT: maxPooled = most snapshots kept for reuse. Beyond this (readers holding many at once), new ones are allocated
+		explicit SnapshotPool(size_t maxPooled_in = 64) : maxPooled(maxPooled_in) { }
+
+		// OUTPUT: Read-only copy of value, shared by everyone who holds it
+		std::shared_ptr<const T> Take(const T& value)
+		{
+			for(auto& snapshot : this->snapshots)
+			{
+				if(snapshot.use_count() != 1) { continue; }
+
+				// Only the pool holds it => the last reader has finished with it
+				//	(the fence pairs with the release of the reader's reference)
+				std::atomic_thread_fence(std::memory_order_acquire);
+				*snapshot = value;
+				return snapshot;
+			}
+
+			auto snapshot = std::make_shared<T>(value);
+			if(this->snapshots.size() < this->maxPooled) { this->snapshots.push_back(snapshot); }
+			return snapshot;
+		}
+	};
+}
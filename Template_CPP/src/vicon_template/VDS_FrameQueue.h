@@ -0,0 +1,96 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Bounded queue to pass every frame from the update thread to a consumer, rather than only the latest
+
+Class Summary:
+	SpscRing
+		Lock-free single producer, single consumer ring buffer of preallocated slots
+		Slots are overwritten in place, so their storage is reused (no allocation once warmed up)
+		When full, the producer is told so and can decide what to do (it never waits)
+
+*/
+#pragma once
+
+// Standard library
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+
+namespace vdsi
+{
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Single producer, single consumer ring buffer
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// One producer thread and one consumer at a time
+	//	If there are multiple consumer threads, they must serialise between themselves
+	template<class T>
+	class SpscRing
+	{
+	private:
+		std::vector<T> slots;
+
+		// Monotonic counters: slot of a counter = counter % capacity
+		//	head = next slot to pop (written by consumer)
+		//	tail = next slot to push (written by producer)
+		std::atomic<uint64_t> head = 0;
+		std::atomic<uint64_t> tail = 0;
+
+	public:
+		//********************************************************************************
+		// Interface: Create
+		//****************************************
+		// INPUT: capacity = maximum number of queued values
+		explicit SpscRing(size_t capacity) : slots(capacity)
+		{
+			if(capacity == 0) { throw std::runtime_error("ERROR_VDS: SpscRing capacity must be > 0"); }
+		}
+
+		size_t Capacity() const { return this->slots.size(); }
+		size_t Size() const { return size_t(this->tail.load(std::memory_order_acquire) - this->head.load(std::memory_order_acquire)); }
+		bool IsEmpty() const { return this->Size() == 0; }
+
+		//********************************************************************************
+		// Interface: Producer
+		//****************************************
+		// OUTPUT: The slot to write the next value into, or nullptr if the queue is full
+		//	It holds an old value, which can be overwritten in place to reuse its storage
+		T* BeginPush()
+		{
+			uint64_t t = this->tail.load(std::memory_order_relaxed);
+			if(t - this->head.load(std::memory_order_acquire) == this->slots.size()) { return nullptr; }
+			return &this->slots[t % this->slots.size()];
+		}
+
+		// PURPOSE: Make the slot from BeginPush() visible to the consumer
+		void CommitPush()
+		{
+			this->tail.store(this->tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+		//********************************************************************************
+		// Interface: Consumer
+		//****************************************
+		// OUTPUT: The oldest value, or nullptr if the queue is empty
+		T* Front()
+		{
+			uint64_t h = this->head.load(std::memory_order_relaxed);
+			if(h == this->tail.load(std::memory_order_acquire)) { return nullptr; }
+			return &this->slots[h % this->slots.size()];
+		}
+
+		// PURPOSE: Release the slot from Front() back to the producer
+		void Pop()
+		{
+			this->head.store(this->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+	};
+}
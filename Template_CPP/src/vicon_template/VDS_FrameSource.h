@@ -0,0 +1,735 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Where VDS_Interface gets its frames from
+		The update thread of VDS_Interface only talks to a FrameSource
+		=> the threading, filtering and export code can run without a Vicon system (testing, benchmarks, load tests)
+
+Class Summary:
+	FrameSource
+		Abstract source of frames
+
+	FrameSource_Synthetic
+		Generates frames of N subjects with M markers each, at a set rate, with random occlusion
+		Optionally, devices of C channels with S subsamples per frame, and U unlabeled markers
+
+	FrameSource_Replay
+		Plays back a binary recording (vds_template_4 --Binary) in real time, faster, or as fast as possible
+
+	FrameSource_SDK (see VDS_FrameSource_SDK.h)
+		Frames from a Vicon system, through the Vicon DataStream SDK
+
+	ObjectFilter, FrameFilter
+		The filter settings of VDS_Interface, as applied to one frame
+
+	DecodeProjection, MarkerDemand
+		Which fields of which objects to decode (see VDS_Interface::EnableDecodeProjection)
+
+*/
+#pragma once
+
+// Brandon's VDS Interface helpers
+#include "VDS_Points.h"
+#include "VDS_NameRegistry.h"
+#include "VDS_Devices.h"
+#include "Binary_Exporter.h"
+
+// Standard library
+#include <string>
+#include <cmath>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <random>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <algorithm>
+
+
+namespace vdsi
+{
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Allowed objects list, resolved to handles
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// order = output order of the objects (precomputed permutation for SortByObjectFilter)
+	// isAllowed = indexed by handle id, for constant time filtering
+	struct ObjectFilter
+	{
+		std::vector<std::string> names;
+		std::vector<vdsi::SubjectHandle> order;
+		std::vector<bool> isAllowed;
+
+		// INPUT:
+		//	allowedObjects = names of the objects to allow, in output order
+		//	registry = resolves the names to handles
+		static std::shared_ptr<const ObjectFilter> Create(const std::vector<std::string>& allowedObjects, vdsi::NameRegistry& registry)
+		{
+			auto filter = std::make_shared<ObjectFilter>();
+			filter->names = allowedObjects;
+			for(auto& name : allowedObjects) { filter->order.push_back(registry.Intern(name)); }
+			filter->isAllowed.resize(registry.Size(), false);
+			for(auto& handle : filter->order) { filter->isAllowed[handle.id] = true; }
+			return filter;
+		}
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Decode projection: which fields of which objects to decode
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Bit flags
+	enum class DecodeFields : uint8_t
+	{
+		None = 0,
+		Pose = 1,
+		Markers = 2,
+		PoseAndMarkers = 3
+	};
+
+	inline bool HasPose(vdsi::DecodeFields fields)    { return (uint8_t(fields) & uint8_t(vdsi::DecodeFields::Pose)) != 0; }
+	inline bool HasMarkers(vdsi::DecodeFields fields) { return (uint8_t(fields) & uint8_t(vdsi::DecodeFields::Markers)) != 0; }
+
+	struct SubjectProjection
+	{
+		std::string name;
+		vdsi::DecodeFields fields = vdsi::DecodeFields::PoseAndMarkers;
+	};
+
+	struct ProjectionSettings
+	{
+		// Fields of the listed objects
+		// Fields of all other objects (None = they are not decoded at all)
+		std::vector<vdsi::SubjectProjection> subjects;
+		vdsi::DecodeFields otherSubjects = vdsi::DecodeFields::None;
+
+		// Lazy markers: markers are only decoded while a consumer asks for them (see VDS_Interface::RequestMarkers)
+		//	A request holds for markerHold, so request again at least this often (e.g. every loop)
+		bool IsLazyMarkers = false;
+		std::chrono::nanoseconds markerHold = std::chrono::seconds(1);
+	};
+
+	// ProjectionSettings, resolved to handles
+	struct DecodeProjection
+	{
+		std::vector<vdsi::DecodeFields> fieldsById;
+		vdsi::DecodeFields otherSubjects = vdsi::DecodeFields::None;
+		bool IsLazyMarkers = false;
+		int64_t markerHoldNs = 0;
+
+		// Whether any object needs the pose / the markers (=> the data the Vicon PC must send)
+		bool IsPoseNeeded = false;
+		bool IsMarkersNeeded = false;
+
+		static std::shared_ptr<const DecodeProjection> Create(const vdsi::ProjectionSettings& settings, vdsi::NameRegistry& registry)
+		{
+			auto projection = std::make_shared<DecodeProjection>();
+			projection->otherSubjects = settings.otherSubjects;
+			projection->IsLazyMarkers = settings.IsLazyMarkers;
+			projection->markerHoldNs = std::chrono::duration_cast<std::chrono::nanoseconds>(settings.markerHold).count();
+
+			std::vector<vdsi::SubjectHandle> handles;
+			for(auto& subject : settings.subjects) { handles.push_back(registry.Intern(subject.name)); }
+			projection->fieldsById.resize(registry.Size(), settings.otherSubjects);
+			for(size_t idx = 0; idx < handles.size(); ++idx) { projection->fieldsById[handles[idx].id] = settings.subjects[idx].fields; }
+
+			uint8_t allFields = uint8_t(settings.otherSubjects);
+			for(auto& subject : settings.subjects) { allFields |= uint8_t(subject.fields); }
+			projection->IsPoseNeeded = vdsi::HasPose(vdsi::DecodeFields(allFields));
+			projection->IsMarkersNeeded = vdsi::HasMarkers(vdsi::DecodeFields(allFields));
+			return projection;
+		}
+
+		vdsi::DecodeFields Fields(vdsi::SubjectHandle handle) const
+		{
+			return (handle.id < this->fieldsById.size()) ? this->fieldsById[handle.id] : this->otherSubjects;
+		}
+	};
+
+	// Lazy markers: until when [ns, on the clock of FrameTiming] the markers of each object were requested
+	//	Written by any thread (Request), read by the update thread through Snapshot()
+	class MarkerDemand
+	{
+	public:
+		// Indexed by handle id
+		using Table = std::vector<std::atomic<int64_t>>;
+
+	private:
+		std::atomic<std::shared_ptr<Table>> table = std::make_shared<Table>();
+		std::mutex mtx_Grow;
+
+	public:
+		void Request(vdsi::SubjectHandle handle, int64_t untilNs)
+		{
+			if( ! handle.IsValid() ) { return; }
+			auto current = this->table.load();
+			if(handle.id >= current->size())
+			{
+				// Grow (rare: once per new handle). A request racing with this may be lost, but requests are repeated
+				std::lock_guard<std::mutex> lock(this->mtx_Grow);
+				current = this->table.load();
+				if(handle.id >= current->size())
+				{
+					auto grown = std::make_shared<Table>(std::max<size_t>(handle.id + 1, 2 * current->size()));
+					for(size_t idx = 0; idx < current->size(); ++idx) { (*grown)[idx].store((*current)[idx].load(std::memory_order_relaxed), std::memory_order_relaxed); }
+					this->table.store(grown);
+					current = grown;
+				}
+			}
+			int64_t previous = (*current)[handle.id].load(std::memory_order_relaxed);
+			if(untilNs > previous) { (*current)[handle.id].store(untilNs, std::memory_order_relaxed); }
+		}
+
+		std::shared_ptr<const Table> Snapshot() const { return this->table.load(); }
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Filter settings applied to one frame
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Taken once per frame by the update thread, so that a frame is never half filtered with old settings
+	struct FrameFilter
+	{
+		// Allowed objects (nullptr = object filter disabled)
+		// Occluded objects are removed
+		std::shared_ptr<const vdsi::ObjectFilter> objects;
+		bool IsOccludedFilterActive = false;
+
+		// Fields to decode (nullptr = all fields of every object)
+		// Lazy markers: requests of markers, and the time of this frame [ns, on the clock of FrameTiming]
+		std::shared_ptr<const vdsi::DecodeProjection> projection;
+		std::shared_ptr<const vdsi::MarkerDemand::Table> markerDemand;
+		int64_t nowNs = 0;
+
+		// PURPOSE:
+		//	Fields of an object to decode, by the object filter and the projection (not the occluded filter)
+		//	Sources call this before decoding anything of the object, and skip it if None
+		//	Markers only: the pose is not decoded (NaN, occluded), and the occluded filter does not apply
+		vdsi::DecodeFields FieldsOf(vdsi::SubjectHandle handle) const
+		{
+			// Object filter
+			if(this->objects)
+			{
+				const auto& isAllowed = this->objects->isAllowed;
+				if( ! (handle.id < isAllowed.size() && isAllowed[handle.id]) ) { return vdsi::DecodeFields::None; }
+			}
+
+			// Projection
+			if( ! this->projection ) { return vdsi::DecodeFields::PoseAndMarkers; }
+			vdsi::DecodeFields fields = this->projection->Fields(handle);
+			if(this->projection->IsLazyMarkers && vdsi::HasMarkers(fields) && ! this->IsMarkersRequested(handle))
+			{
+				fields = vdsi::DecodeFields(uint8_t(fields) & ~uint8_t(vdsi::DecodeFields::Markers));
+			}
+			return fields;
+		}
+
+		bool IsMarkersRequested(vdsi::SubjectHandle handle) const
+		{
+			return this->markerDemand && handle.id < this->markerDemand->size() && (*this->markerDemand)[handle.id].load(std::memory_order_relaxed) >= this->nowNs;
+		}
+
+		// PURPOSE: Test if the point is allowed by the active filters
+		bool Allows(vdsi::SubjectHandle handle, bool IsOccluded) const
+		{
+			// Occluded filter
+			if(this->IsOccludedFilterActive && IsOccluded) {return false;}
+
+			// Object filter
+			if( ! this->objects ) {return true;}
+			// Look up allowed objects list
+			const auto& isAllowed = this->objects->isAllowed;
+			return handle.id < isAllowed.size() && isAllowed[handle.id];
+		}
+
+		// PURPOSE: Sort Points by the ordering specified in the AllowedObjects filter
+		// If the filter is not active, copy the input
+		// OUTPUT: Points_sorted = refilled with the sorted points
+		void SortByObjectFilter(const vdsi::Points& Points, vdsi::Points& Points_sorted) const
+		{
+			if( ! this->objects ) { Points_sorted = Points; return; }
+
+			const auto& filter = *this->objects;
+			Points_sorted.BeginRefill(Points.frameNumber);
+			for(size_t idx = 0; idx < filter.order.size(); ++idx)
+			{
+				// Objects missing from the frame are saved as occluded
+				const vdsi::Point_Object* point = Points.Find(filter.order[idx]);
+				bool IsOccluded = point ? point->IsOccluded : true;
+
+				// Save point to the return object if allowed by filters
+				//	i.e. apply occluded filter
+				if( ! this->Allows(filter.order[idx], IsOccluded) ) { continue; }
+				if(point) { Points_sorted.RefillNext() = *point; }
+				else      { Points_sorted.RefillNext().Reset(filter.names[idx], vdsi::RotationMatrix_NaN, vdsi::Translation_NaN, true, filter.order[idx]); }
+			}
+			Points_sorted.EndRefill();
+		}
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Abstract source of frames
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Called only by the update thread of VDS_Interface, in this order:
+	//	Connect() once, then ApplyDeviceSettings() if device data was enabled before
+	//	per frame: WaitForFrame(), then FrameRateHz(), LatencySeconds(), DecodeFrame() (DecodePoses() in direct pose mode), then DecodeDevices() if enabled
+	//	Disconnect() once
+	class FrameSource
+	{
+	public:
+		virtual ~FrameSource() = default;
+
+		// PURPOSE: Start producing frames. Throw std::runtime_error on failure
+		// INPUT: names = resolves object names to handles (use Intern on every object name)
+		virtual void Connect(vdsi::NameRegistry& names) = 0;
+		virtual void Disconnect() = 0;
+
+		// PURPOSE: Block until the next frame is available
+		// OUTPUT: false if there is no frame yet. Must return within ~100 ms, so that VDS_Interface can stop its thread
+		virtual bool WaitForFrame() = 0;
+
+		// OUTPUT: Frame rate of the source [Hz]
+		// OUTPUT: Latency of the current frame: capture => available to WaitForFrame [s]
+		virtual double FrameRateHz() = 0;
+		virtual double LatencySeconds() = 0;
+
+		// PURPOSE: Decode the current frame
+		//	Call filter.FieldsOf() before decoding anything of an object: skip it if None, and decode only the fields it returns
+		//	Then, if the pose was decoded, skip objects not allowed by filter.Allows() before their markers are decoded
+		// OUTPUT: frame = refilled with the objects of the current frame (BeginRefill ... EndRefill)
+		virtual void DecodeFrame(vdsi::Points& frame, const vdsi::FrameFilter& filter) = 0;
+
+		// OUTPUT: Number of times cached names of the scene were rebuilt (sources without a cache: 0)
+		virtual uint64_t SchemaRebuilds() const { return 0; }
+
+		// OUTPUT: true once the source will never give another frame (e.g. end of a recording). Live sources: false
+		virtual bool IsEndOfStream() const { return false; }
+
+		// PURPOSE: Decode the device channels and unlabeled markers of the current frame (see VDS_Devices.h)
+		//	Only the data enabled in settings. Keep the layout (shared_ptr) while the devices don't change
+		// OUTPUT: frame = values and unlabeled markers of the current frame (sources without devices: empty)
+		virtual void DecodeDevices(vdsi::DeviceFrame& frame, const vdsi::DeviceSettings& /*settings*/) { frame.Clear(); }
+
+		// PURPOSE: Ask for the data enabled in settings, before the first call of DecodeDevices (sources that must ask for it: see FrameSource_SDK)
+		virtual void ApplyDeviceSettings(const vdsi::DeviceSettings& /*settings*/) {}
+
+		// PURPOSE:
+		//	Direct pose mode: decode only the poses of a fixed list of objects, straight into poses (see VDS_Interface::EnableDirectPoses)
+		//	Sources with a direct path override this (FrameSource_SDK: no names handled per frame)
+		//	Default: decode a frame with filter, then pick the objects from it
+		// INPUT: handles = objects to decode. The same list every frame while connected
+		// OUTPUT:
+		//	poses = one per handle, in the same order. Occluded if not in the frame
+		//	return = frame number
+		virtual unsigned int DecodePoses(const std::vector<vdsi::SubjectHandle>& handles, vdsi::FixedPose* poses, const vdsi::FrameFilter& filter)
+		{
+			this->DecodeFrame(this->PosesFrame, filter);
+			for(size_t idx = 0; idx < handles.size(); ++idx)
+			{
+				const vdsi::Point_Object* point = this->PosesFrame.Find(handles[idx]);
+				if(point)
+				{
+					poses[idx].R_rowMajor = point->R_rowMajor;
+					poses[idx].P = point->P;
+					poses[idx].IsOccluded = point->IsOccluded;
+				}
+				else { poses[idx] = vdsi::FixedPose(); }
+			}
+			return this->PosesFrame.frameNumber;
+		}
+
+	private:
+		// Frame decoded by the default DecodePoses(), reused every frame
+		vdsi::Points PosesFrame;
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Synthetic frames, for testing without a Vicon system
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Each subject circles the origin, rotating about z. Its markers are fixed to it
+	// Frame numbers follow the wall clock, like a real Vicon system
+	//	=> if the consumer is too slow, frames are skipped (and counted in QueueStats::frameNumberGaps)
+	// Occluded subjects are reported as the SDK reports them: all zero, with IsOccluded set
+	struct SyntheticSettings
+	{
+		// Number of subjects (named synthetic_subject_0, ...)
+		// Number of markers per subject (named synthetic_marker_0, ...)
+		// Frame rate [Hz]
+		// Probability that a subject, or a marker, is occluded in a frame. In [0,1]
+		// Seed of the random occlusion, for repeatable runs
+		unsigned int numSubjects = 10;
+		unsigned int numMarkers = 5;
+		double frameRateHz = 100;
+		double occlusionRate = 0;
+		uint32_t seed = 1;
+
+		// Devices (named synthetic_device_0, ...): each channel is a sine wave, sampled deviceSubsamples times per frame
+		// Unlabeled markers: at random positions each frame
+		unsigned int numDevices = 0;
+		unsigned int deviceChannels = 6;
+		unsigned int deviceSubsamples = 10;
+		unsigned int numUnlabeled = 0;
+	};
+
+	class FrameSource_Synthetic : public FrameSource
+	{
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		vdsi::SyntheticSettings settings;
+		std::vector<std::string> subjectNames;
+		std::vector<vdsi::SubjectHandle> subjectHandles;
+		std::vector<std::string> markerNames;
+
+		std::mt19937 rng;
+		std::mt19937 rng_unlabeled; // Separate, so that the occlusions are the same with or without unlabeled markers
+		std::vector<uint8_t> marker_IsOccluded; // Draws of the current subject, reused every subject
+		std::uniform_real_distribution<double> uniform{0.0, 1.0};
+
+		std::shared_ptr<const vdsi::DeviceLayout> deviceLayout;
+
+		Clock::time_point tStart;
+		uint64_t frameNumber = 0;
+
+	public:
+		FrameSource_Synthetic(vdsi::SyntheticSettings settings_in) : settings(settings_in)
+		{
+			if( ! (this->settings.frameRateHz > 0) ) { throw std::runtime_error("ERROR_VDS: Synthetic frame rate must be > 0"); }
+			if( ! (0 <= this->settings.occlusionRate && this->settings.occlusionRate <= 1) ) { throw std::runtime_error("ERROR_VDS: Synthetic occlusion rate must be in [0,1]"); }
+		}
+
+		void Connect(vdsi::NameRegistry& names) override
+		{
+			this->subjectNames.clear();
+			this->subjectHandles.clear();
+			this->markerNames.clear();
+			for(unsigned int idx = 0; idx < this->settings.numSubjects; ++idx)
+			{
+				this->subjectNames.push_back("synthetic_subject_" + std::to_string(idx));
+				this->subjectHandles.push_back(names.Intern(this->subjectNames.back()));
+			}
+			for(unsigned int idx = 0; idx < this->settings.numMarkers; ++idx)
+			{
+				this->markerNames.push_back("synthetic_marker_" + std::to_string(idx));
+			}
+
+			auto layout = std::make_shared<vdsi::DeviceLayout>();
+			std::vector<std::string> channelNames;
+			for(unsigned int idx = 0; idx < this->settings.deviceChannels; ++idx) { channelNames.push_back("channel_" + std::to_string(idx)); }
+			for(unsigned int idx = 0; idx < this->settings.numDevices; ++idx)
+			{
+				layout->Add("synthetic_device_" + std::to_string(idx), channelNames, this->settings.deviceSubsamples);
+			}
+			this->deviceLayout = layout;
+
+			this->rng.seed(this->settings.seed);
+			this->rng_unlabeled.seed(this->settings.seed + 1);
+			this->tStart = Clock::now();
+			this->frameNumber = 0;
+		}
+
+		void Disconnect() override { }
+
+		bool WaitForFrame() override
+		{
+			// Next frame by the wall clock
+			double elapsed = std::chrono::duration<double>(Clock::now() - this->tStart).count();
+			uint64_t frameNumber_now = uint64_t(elapsed * this->settings.frameRateHz) + 1;
+			if(frameNumber_now <= this->frameNumber)
+			{
+				// Wait for it
+				frameNumber_now = this->frameNumber + 1;
+				auto tDue = this->tStart + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(double(frameNumber_now - 1) / this->settings.frameRateHz));
+				std::this_thread::sleep_until(std::min(tDue, Clock::now() + std::chrono::milliseconds(100)));
+				if(Clock::now() < tDue) { return false; }
+			}
+			this->frameNumber = frameNumber_now;
+			return true;
+		}
+
+		double FrameRateHz() override { return this->settings.frameRateHz; }
+		double LatencySeconds() override { return 0; }
+
+		void DecodeFrame(vdsi::Points& frame, const vdsi::FrameFilter& filter) override
+		{
+			constexpr double pi = 3.14159265358979323846;
+			double t = double(this->frameNumber - 1) / this->settings.frameRateHz;
+
+			frame.BeginRefill((unsigned int)this->frameNumber);
+			for(size_t idxS = 0; idxS < this->subjectNames.size(); ++idxS)
+			{
+				// Occlusion of the subject and each marker
+				//	Drawn for every subject and marker before any is skipped
+				//	=> the same seed gives the same occlusions, whatever the filters and projection
+				bool IsOccluded = this->uniform(this->rng) < this->settings.occlusionRate;
+				this->marker_IsOccluded.resize(this->markerNames.size());
+				for(auto& marker_IsOccluded : this->marker_IsOccluded) { marker_IsOccluded = this->uniform(this->rng) < this->settings.occlusionRate; }
+
+				vdsi::DecodeFields fields = filter.FieldsOf(this->subjectHandles[idxS]);
+				if(fields == vdsi::DecodeFields::None) { continue; }
+				if(vdsi::HasPose(fields) && ! filter.Allows(this->subjectHandles[idxS], IsOccluded) ) { continue; }
+
+				// Pose: circle of radius r at height z, facing along the direction of travel
+				double radius = 1000.0 + 10.0 * double(idxS);
+				double angle = 2*pi * 0.2 * t + 2*pi * double(idxS) / double(this->subjectNames.size());
+				double c = std::cos(angle);
+				double s = std::sin(angle);
+				vdsi::RotationMatrix R = { c,-s,0, s,c,0, 0,0,1 };
+				vdsi::Translation P = { radius*c, radius*s, 500.0 + double(idxS) };
+				if(IsOccluded)
+				{
+					R.fill(0);
+					P.fill(0);
+				}
+
+				vdsi::Point_Object& point = frame.RefillNext();
+				if(vdsi::HasPose(fields)) { point.Reset(this->subjectNames[idxS], R, P, IsOccluded, this->subjectHandles[idxS]); }
+				else                      { point.Reset(this->subjectNames[idxS], vdsi::RotationMatrix_NaN, vdsi::Translation_NaN, true, this->subjectHandles[idxS]); }
+				if( ! vdsi::HasMarkers(fields) ) { continue; }
+
+				// Markers: along the x axis of the subject
+				for(size_t idxM = 0; idxM < this->markerNames.size(); ++idxM)
+				{
+					if(IsOccluded || this->marker_IsOccluded[idxM])
+					{
+						point.AddMarker(vdsi::Point_Marker(this->markerNames[idxM]));
+						continue;
+					}
+					double offset = 50.0 * double(idxM + 1);
+					vdsi::Translation markerP = { P[0] + offset*c, P[1] + offset*s, P[2] };
+					point.AddMarker(vdsi::Point_Marker(this->markerNames[idxM], markerP, false));
+				}
+			}
+			frame.EndRefill();
+		}
+
+		void DecodeDevices(vdsi::DeviceFrame& frame, const vdsi::DeviceSettings& settings) override
+		{
+			constexpr double pi = 3.14159265358979323846;
+			double t = double(this->frameNumber - 1) / this->settings.frameRateHz;
+			frame.Clear();
+
+			// Devices: channel c of device d = amplitude (c+1)*100 at frequency (d+1) Hz
+			if(settings.IsDeviceData)
+			{
+				frame.layout = this->deviceLayout;
+				frame.values.resize(this->deviceLayout->numValues);
+				for(size_t idxD = 0; idxD < this->deviceLayout->devices.size(); ++idxD)
+				{
+					const vdsi::DeviceInfo& device = this->deviceLayout->devices[idxD];
+					double* values = frame.values.data() + device.offset;
+					for(size_t idxS = 0; idxS < device.numSamples; ++idxS)
+					{
+						double tSample = t + double(idxS) / (this->settings.frameRateHz * double(device.numSamples));
+						for(size_t idxC = 0; idxC < device.NumChannels(); ++idxC)
+						{
+							*values++ = 100.0 * double(idxC + 1) * std::sin(2*pi * double(idxD + 1) * tSample + double(idxC));
+						}
+					}
+				}
+			}
+
+			// Unlabeled markers: anywhere in a 4 x 4 x 2 m volume
+			if(settings.IsUnlabeledMarkers)
+			{
+				for(unsigned int idxM = 0; idxM < this->settings.numUnlabeled; ++idxM)
+				{
+					double P[3] = {
+						4000.0 * this->uniform(this->rng_unlabeled) - 2000.0,
+						4000.0 * this->uniform(this->rng_unlabeled) - 2000.0,
+						2000.0 * this->uniform(this->rng_unlabeled) };
+					frame.AddUnlabeled(idxM, P);
+				}
+			}
+		}
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Play back a binary recording
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Reads recordings with the column layout written by vds_template_4:
+	//	FrameNumber, then for each object: <object>_R11 ... <object>_P3, then optionally <object>_<marker>P1 ... P3 for each marker
+	// Objects with all zero or NaN pose are reported as occluded. Markers with NaN position are reported as occluded
+	// Rows are read from the file as they are played, so recordings of any length can be played
+	class FrameSource_Replay : public FrameSource
+	{
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		// Columns of each object in a row
+		struct ObjectLayout
+		{
+			std::string name;
+			vdsi::SubjectHandle handle;
+			size_t column;
+			std::vector<std::string> markerNames;
+			std::vector<size_t> markerColumns;
+		};
+
+		std::string fileName;
+		double speed;
+		bool IsLoop;
+
+		std::unique_ptr<binary_exporter::ImportBinary> file;
+		std::vector<ObjectLayout> layout;
+		std::vector<double> row;
+
+		// Playback position
+		//	Frame numbers keep increasing when looping
+		uint64_t nextRow = 0;
+		bool IsRowPending = false;
+		double frameNumber_first = 0;
+		uint64_t frameNumber_loopOffset = 0;
+		Clock::time_point tStart;
+
+		void ParseLayout(vdsi::NameRegistry& names)
+		{
+			this->layout.clear();
+			const auto& columns = this->file->ColumnNames();
+			const auto& objects = this->file->ObjectNames();
+			const std::vector<std::string> RP_string = { "R11","R12","R13", "R21","R22","R23", "R31","R32","R33", "P1","P2","P3" };
+
+			if(columns.empty() || columns[0] != "FrameNumber") { throw std::runtime_error("ERROR_VDS: Replay file layout not recognised (FrameNumber)"); }
+			size_t column = 1;
+			for(size_t idxObject = 0; idxObject < objects.size(); ++idxObject)
+			{
+				ObjectLayout object;
+				object.name = objects[idxObject];
+				object.handle = names.Intern(object.name);
+				object.column = column;
+
+				// Pose
+				for(auto& str : RP_string)
+				{
+					if(column >= columns.size() || columns[column] != object.name + "_" + str) { throw std::runtime_error("ERROR_VDS: Replay file layout not recognised (" + object.name + "_" + str + ")"); }
+					++column;
+				}
+
+				// Markers: until the next object
+				std::string prefix = object.name + "_";
+				std::string nextObject = (idxObject + 1 < objects.size()) ? objects[idxObject + 1] + "_R11" : "";
+				while(column + 2 < columns.size() && columns[column] != nextObject)
+				{
+					const std::string& col = columns[column];
+					if(col.size() <= prefix.size() + 2 || col.compare(0, prefix.size(), prefix) != 0 || col.compare(col.size() - 2, 2, "P1") != 0)
+					{
+						throw std::runtime_error("ERROR_VDS: Replay file layout not recognised (" + col + ")");
+					}
+					object.markerNames.push_back(col.substr(prefix.size(), col.size() - prefix.size() - 2));
+					object.markerColumns.push_back(column);
+					column += 3;
+				}
+				this->layout.push_back(object);
+			}
+			if(column != columns.size()) { throw std::runtime_error("ERROR_VDS: Replay file layout not recognised (extra columns)"); }
+		}
+
+	public:
+		// INPUT:
+		//	fileName_in = recording written by vds_template_4 --Binary
+		//	speed_in = playback speed: 1 = real time, 10 = ten times faster, 0 = as fast as possible
+		//	IsLoop_in = start again from the beginning at the end. Otherwise, frames stop at the end
+		FrameSource_Replay(const std::string& fileName_in, double speed_in = 1, bool IsLoop_in = false) :
+			fileName(fileName_in),
+			speed(speed_in),
+			IsLoop(IsLoop_in)
+		{
+			if(this->speed < 0) { throw std::runtime_error("ERROR_VDS: Replay speed must be >= 0"); }
+		}
+
+		void Connect(vdsi::NameRegistry& names) override
+		{
+			this->file = std::make_unique<binary_exporter::ImportBinary>(this->fileName);
+			if(this->file->NumRows() == 0) { throw std::runtime_error("ERROR_VDS: Replay file has no frames"); }
+			this->ParseLayout(names);
+
+			this->file->ReadRow(0, this->row);
+			this->frameNumber_first = this->row[0];
+			this->nextRow = 0;
+			this->IsRowPending = false;
+			this->frameNumber_loopOffset = 0;
+			this->tStart = Clock::now();
+		}
+
+		void Disconnect() override { this->file.reset(); }
+
+		bool WaitForFrame() override
+		{
+			if( ! this->IsRowPending )
+			{
+				// End of recording
+				if(this->nextRow >= this->file->NumRows())
+				{
+					if( ! this->IsLoop )
+					{
+						std::this_thread::sleep_for(std::chrono::milliseconds(10));
+						return false;
+					}
+					double frameNumber_last = this->row[0];
+					this->frameNumber_loopOffset += uint64_t(frameNumber_last - this->frameNumber_first) + 1;
+					this->nextRow = 0;
+					this->tStart = Clock::now();
+				}
+				this->file->ReadRow(this->nextRow++, this->row);
+				this->IsRowPending = true;
+			}
+
+			// Wait until the frame is due
+			if(this->speed > 0)
+			{
+				double tFrame = (this->row[0] - this->frameNumber_first) / (this->file->FrameRate() * this->speed);
+				auto tDue = this->tStart + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(tFrame));
+				std::this_thread::sleep_until(std::min(tDue, Clock::now() + std::chrono::milliseconds(100)));
+				if(Clock::now() < tDue) { return false; }
+			}
+			this->IsRowPending = false;
+			return true;
+		}
+
+		bool IsEndOfStream() const override { return ! this->IsLoop && ! this->IsRowPending && this->nextRow >= this->file->NumRows(); }
+
+		double FrameRateHz() override { return this->file->FrameRate(); }
+		double LatencySeconds() override { return 0; }
+
+		void DecodeFrame(vdsi::Points& frame, const vdsi::FrameFilter& filter) override
+		{
+			frame.BeginRefill((unsigned int)(uint64_t(this->row[0]) + this->frameNumber_loopOffset));
+			for(auto& object : this->layout)
+			{
+				vdsi::DecodeFields fields = filter.FieldsOf(object.handle);
+				if(fields == vdsi::DecodeFields::None) { continue; }
+
+				vdsi::RotationMatrix R;
+				vdsi::Translation P;
+				std::copy(this->row.begin() + object.column, this->row.begin() + object.column + 9, R.begin());
+				std::copy(this->row.begin() + object.column + 9, this->row.begin() + object.column + 12, P.begin());
+
+				// Recorded as zero by the SDK, or NaN if missing from the frame
+				bool IsOccluded =
+					   std::all_of(R.begin(), R.end(), [](double v){ return v == 0; })
+					|| std::all_of(P.begin(), P.end(), [](double v){ return v == 0; })
+					|| std::any_of(P.begin(), P.end(), [](double v){ return std::isnan(v); });
+				if(vdsi::HasPose(fields) && ! filter.Allows(object.handle, IsOccluded) ) { continue; }
+
+				vdsi::Point_Object& point = frame.RefillNext();
+				if(vdsi::HasPose(fields)) { point.Reset(object.name, R, P, IsOccluded, object.handle); }
+				else                      { point.Reset(object.name, vdsi::RotationMatrix_NaN, vdsi::Translation_NaN, true, object.handle); }
+				if( ! vdsi::HasMarkers(fields) ) { continue; }
+
+				for(size_t idxM = 0; idxM < object.markerNames.size(); ++idxM)
+				{
+					size_t column = object.markerColumns[idxM];
+					vdsi::Translation markerP = { this->row[column], this->row[column + 1], this->row[column + 2] };
+					if(std::isnan(markerP[0])) { point.AddMarker(vdsi::Point_Marker(object.markerNames[idxM])); }
+					else                       { point.AddMarker(vdsi::Point_Marker(object.markerNames[idxM], markerP, false)); }
+				}
+			}
+			frame.EndRefill();
+		}
+	};
+}
@@ -0,0 +1,615 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Frame source of a Vicon system, through the Vicon DataStream SDK (Using Version 1.11.0)
+	(Moved out of VDS_Interface.h, which now takes frames from any vdsi::FrameSource)
+
+Class Summary:
+	FrameSource_SDK
+		Connects to Vicon Tracker, and decodes the frames into vdsi::Points
+		Caches the names of the scene, so that only the pose data is queried each frame
+		Optionally, device channels and unlabeled markers into flat arrays (see VDS_Devices.h)
+
+*/
+#pragma once
+
+// Vicon DataStream SDK
+#include "DataStreamClient.h"
+namespace vds = ViconDataStreamSDK::CPP;
+
+// Brandon's VDS Interface helpers
+#include "VDS_FrameSource.h"
+
+// Standard library
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+
+
+namespace vdsi
+{
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Frames from the Vicon DataStream SDK
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	class FrameSource_SDK : public FrameSource
+	{
+	private:
+		vds::Client Client;
+		std::string HostName;
+		bool EnableLightweight;
+
+		// Resolves names to handles (owned by VDS_Interface)
+		vdsi::NameRegistry* Names = nullptr;
+
+		// Cached scene layout
+		//	Names are held as SDK strings, so that the per-frame queries don't build new strings
+		//	Rebuilt only when the layout changes (see DecodeFrame)
+		struct SubjectSchema
+		{
+			std::string name;
+			vds::String name_sdk;
+			vds::String segmentName_sdk;
+			vdsi::SubjectHandle handle;
+			std::vector<std::string> markerNames;
+			std::vector<vds::String> markerNames_sdk;
+		};
+		std::vector<SubjectSchema> Schema;
+		bool IsSchemaStale = true;
+		uint64_t schemaRebuilds = 0;
+
+		// Direct pose mode: index in Schema of each listed object (see DecodePoses)
+		//	Mapped once per rebuild of the layout. Subjects that are not listed are kept, to be probed
+		static constexpr uint32_t NoSubject = std::numeric_limits<uint32_t>::max();
+		std::vector<vdsi::SubjectHandle> Listed;
+		std::vector<uint32_t> schemaByListed;
+		std::vector<uint32_t> schemaUnlisted;
+		bool IsListedStale = true;
+
+		// Data sent by the Vicon PC, matched to the decode projection (see ApplyDataEnables)
+		bool IsSegmentDataEnabled = true;
+		bool IsMarkerDataEnabled = true;
+
+		// Cached device layout (see DecodeDevices)
+		//	Names as SDK strings, as for the subjects. Channel = output.component
+		struct DeviceSchema
+		{
+			vds::String name_sdk;
+			std::vector<vds::String> outputNames_sdk;
+			std::vector<vds::String> componentNames_sdk;
+		};
+		std::vector<DeviceSchema> DeviceSchemas;
+		std::shared_ptr<const vdsi::DeviceLayout> DeviceLayout;
+
+		// Device data and unlabeled markers sent by the Vicon PC (see DecodeDevices)
+		bool IsDeviceDataEnabled = false;
+		bool IsUnlabeledMarkerDataEnabled = false;
+
+	public:
+		// INPUT:
+		//	HOSTNAME = IP address of the vicon control computer (the computer running tracker 3)
+		//	Flag_Lightweight:
+		//		0 = Normal mode
+		//		1 = Lightweight mode (Sacrifice precision to reduce the network bandwidth by ~75%)
+		FrameSource_SDK(std::string HostName_in = "localhost:801", bool EnableLightweight_in = false) :
+			HostName(HostName_in),
+			EnableLightweight(EnableLightweight_in)
+		{
+			// Nothing to do
+		}
+
+		void Connect(vdsi::NameRegistry& names) override
+		{
+			this->Names = &names;
+
+			// Connect to server
+			if(this->Client.Connect(this->HostName).Result != vds::Result::Success)
+			{
+				throw std::runtime_error("ERROR_VDS: Failed to connect to " + this->HostName);
+			}
+
+			// Apply options
+			bool lightweightResult = this->EnableLightweight ? this->Client.EnableLightweightSegmentData().Result == vds::Result::Success : true;
+			bool streamModeResult = this->Client.SetStreamMode( vds::StreamMode::ServerPush ).Result == vds::Result::Success;
+			bool segmentDataResult = this->Client.EnableSegmentData().Result == vds::Result::Success;
+			bool markerDataResult = this->Client.EnableMarkerData().Result == vds::Result::Success;
+			bool wasSuccessful =
+				   lightweightResult
+				&& streamModeResult
+				&& segmentDataResult
+				&& markerDataResult;
+			if( !wasSuccessful ) { throw std::runtime_error("ERROR_VDS: Failed to initialise"); }
+
+			this->IsSchemaStale = true;
+			this->schemaRebuilds = 0;
+			this->IsSegmentDataEnabled = true;
+			this->IsMarkerDataEnabled = true;
+			this->IsDeviceDataEnabled = false;
+			this->IsUnlabeledMarkerDataEnabled = false;
+			this->DeviceSchemas.clear();
+			this->DeviceLayout.reset();
+		}
+
+		void Disconnect() override
+		{
+			this->Client.Disconnect();
+		}
+
+		bool WaitForFrame() override
+		{
+			// Wait for next frame
+			if(this->Client.GetFrame().Result == vds::Result::Success) { return true; }
+
+			// e.g. network lost. Don't spin on the error
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			return false;
+		}
+
+		// PURPOSE: Occlusion test of a segment pose returned by the SDK
+		static bool IsOccludedPose(const double (&Rotation)[9], const double (&Translation)[3])
+		{
+			// The occluded return value is broken - Always gives 0 (meaning not occluded)
+			// I'd like to do this:
+			//		bool IsOccluded = ret_R.Occluded || ret_P.Occluded;
+			// But oh well. Let's do it manually
+			// If it's occluded, all values return exactly 0 (at least that works)
+			// It's pretty unlikely that a real value will be exactly 0 in double precision
+			// Hence:
+			return (
+					   Rotation[0] == 0
+					&& Rotation[1] == 0
+					&& Rotation[2] == 0
+					&& Rotation[3] == 0
+					&& Rotation[4] == 0
+					&& Rotation[5] == 0
+					&& Rotation[6] == 0
+					&& Rotation[7] == 0
+					&& Rotation[8] == 0
+				) || (
+					   Translation[0] == 0
+					&& Translation[1] == 0
+					&& Translation[2] == 0
+				);
+		}
+
+		double FrameRateHz() override { return this->Client.GetFrameRate().FrameRateHz; }
+		double LatencySeconds() override { return this->Client.GetLatencyTotal().Total; }
+		uint64_t SchemaRebuilds() const override { return this->schemaRebuilds; }
+
+		// PURPOSE:
+		//	Decode the data frame (frame as in snapshot of system state at current time)
+		//	Apply filtering
+		// OUTPUT: Points = refilled with the decoded frame (empty if it could not be decoded, even with the layout rebuilt)
+		void DecodeFrame(vdsi::Points& Points, const vdsi::FrameFilter& filter) override
+		{
+			this->ApplyDataEnables(filter);
+
+			// The scene layout almost never changes, so only the numeric pose data is queried each frame
+			//	Added or removed subjects => subject count changes
+			//	Renamed or replaced subjects => the query by the cached name fails (filtered out subjects are probed, see DecodeSubjects)
+			// In both cases, rebuild the cached layout and decode again
+			unsigned int numS = this->Client.GetSubjectCount().SubjectCount;
+			if(this->IsSchemaStale || numS != this->Schema.size()) { this->RebuildSchema(); }
+			bool wasSuccessful = this->DecodeSubjects(Points, filter);
+			if( ! wasSuccessful )
+			{
+				this->RebuildSchema();
+				wasSuccessful = this->DecodeSubjects(Points, filter);
+			}
+
+			// Failed again => don't hand out a partial frame
+			if( ! wasSuccessful ) { Points.BeginRefill(Points.frameNumber); }
+			Points.EndRefill();
+		}
+
+		// PURPOSE:
+		//	Direct pose mode: query the pose of each listed object by its cached SDK names, straight into poses
+		//	No strings are built and no Points frame is made per frame
+		//	Same caching as DecodeFrame: rebuild the layout when it changes, and decode again
+		unsigned int DecodePoses(const std::vector<vdsi::SubjectHandle>& handles, vdsi::FixedPose* poses, const vdsi::FrameFilter& filter) override
+		{
+			this->ApplyDataEnables(filter);
+			unsigned int frameNumber = this->Client.GetFrameNumber().FrameNumber;
+
+			unsigned int numS = this->Client.GetSubjectCount().SubjectCount;
+			if(this->IsSchemaStale || numS != this->Schema.size()) { this->RebuildSchema(); }
+			if(this->IsListedStale || handles != this->Listed) { this->MapListed(handles); }
+			bool wasSuccessful = this->DecodeListed(poses);
+			if( ! wasSuccessful )
+			{
+				this->RebuildSchema();
+				this->MapListed(handles);
+				wasSuccessful = this->DecodeListed(poses);
+			}
+
+			// Failed again => don't hand out a partial frame
+			if( ! wasSuccessful ) { std::fill(poses, poses + handles.size(), vdsi::FixedPose()); }
+			return frameNumber;
+		}
+
+		// PURPOSE:
+		//	Ask the Vicon PC for device and unlabeled marker data, or stop it
+		//	Called at Connect if device data was enabled before, otherwise by the first DecodeDevices
+		//	The change applies from the next frames
+		void ApplyDeviceSettings(const vdsi::DeviceSettings& settings) override
+		{
+			if(settings.IsDeviceData != this->IsDeviceDataEnabled)
+			{
+				auto result = settings.IsDeviceData ? this->Client.EnableDeviceData().Result : this->Client.DisableDeviceData().Result;
+				if(result != vds::Result::Success) { std::cout << "WARNING_VDS: Failed to change device data" << std::endl; }
+				this->IsDeviceDataEnabled = settings.IsDeviceData;
+				this->DeviceSchemas.clear();
+				this->DeviceLayout.reset();
+			}
+			if(settings.IsUnlabeledMarkers != this->IsUnlabeledMarkerDataEnabled)
+			{
+				auto result = settings.IsUnlabeledMarkers ? this->Client.EnableUnlabeledMarkerData().Result : this->Client.DisableUnlabeledMarkerData().Result;
+				if(result != vds::Result::Success) { std::cout << "WARNING_VDS: Failed to change unlabeled marker data" << std::endl; }
+				this->IsUnlabeledMarkerDataEnabled = settings.IsUnlabeledMarkers;
+			}
+		}
+
+		// PURPOSE: Decode the device channels and unlabeled markers of the current frame
+		// OUTPUT: frame = values of every channel and subsample (NaN = occluded, or not decoded), and the unlabeled markers
+		void DecodeDevices(vdsi::DeviceFrame& frame, const vdsi::DeviceSettings& settings) override
+		{
+			this->ApplyDeviceSettings(settings);
+
+			frame.Clear();
+
+			// Devices
+			//	As for the subjects: the layout is cached, and rebuilt when the device count changes or a query fails
+			if(this->IsDeviceDataEnabled)
+			{
+				unsigned int numD = this->Client.GetDeviceCount().DeviceCount;
+				if( ! this->DeviceLayout || numD != this->DeviceSchemas.size() ) { this->RebuildDeviceSchema(); }
+				if( ! this->DecodeDeviceValues(frame) )
+				{
+					this->RebuildDeviceSchema();
+					// Failed again => don't hand out values of a partial decode
+					if( ! this->DecodeDeviceValues(frame) ) { std::fill(frame.values.begin(), frame.values.end(), vdsi::NaN); }
+				}
+			}
+
+			// Unlabeled markers
+			if(this->IsUnlabeledMarkerDataEnabled)
+			{
+				unsigned int numM = this->Client.GetUnlabeledMarkerCount().MarkerCount;
+				frame.unlabeled.reserve(3 * numM);
+				frame.unlabeledIds.reserve(numM);
+				for (unsigned int idxMarker = 0; idxMarker < numM; ++idxMarker)
+				{
+					vds::Output_GetUnlabeledMarkerGlobalTranslation retM_P = this->Client.GetUnlabeledMarkerGlobalTranslation(idxMarker);
+					if (retM_P.Result != vds::Result::Success) { break; }
+					frame.AddUnlabeled(retM_P.MarkerID, retM_P.Translation);
+				}
+			}
+		}
+
+	private:
+		// PURPOSE: Decode every channel and subsample of the devices in the cached layout
+		// OUTPUT:
+		//	frame = layout and values set
+		//	return = false if the cached layout no longer matches the frame
+		bool DecodeDeviceValues(vdsi::DeviceFrame& frame)
+		{
+			frame.layout = this->DeviceLayout;
+			frame.values.resize(this->DeviceLayout->numValues);
+			for (size_t idxDevice = 0; idxDevice < this->DeviceSchemas.size(); ++idxDevice)
+			{
+				const DeviceSchema& schema = this->DeviceSchemas[idxDevice];
+				const vdsi::DeviceInfo& device = this->DeviceLayout->devices[idxDevice];
+				size_t numChannels = device.NumChannels();
+				double* values = frame.values.data() + device.offset;
+				for (size_t idxChannel = 0; idxChannel < numChannels; ++idxChannel)
+				{
+					for (unsigned int idxSample = 0; idxSample < device.numSamples; ++idxSample)
+					{
+						vds::Output_GetDeviceOutputValue ret = this->Client.GetDeviceOutputValue(schema.name_sdk, schema.outputNames_sdk[idxChannel], schema.componentNames_sdk[idxChannel], idxSample);
+						if (ret.Result != vds::Result::Success) { return false; }
+						values[idxSample * numChannels + idxChannel] = ret.Occluded ? vdsi::NaN : ret.Value;
+					}
+				}
+			}
+			return true;
+		}
+
+		// PURPOSE: Query the names of all devices and channels, and the subsamples per frame
+		void RebuildDeviceSchema()
+		{
+			this->DeviceSchemas.clear();
+			auto layout = std::make_shared<vdsi::DeviceLayout>();
+			unsigned int numD = this->Client.GetDeviceCount().DeviceCount;
+			for (unsigned int idxDevice = 0; idxDevice < numD; ++idxDevice)
+			{
+				DeviceSchema schema;
+				std::string name = this->Client.GetDeviceName(idxDevice).DeviceName;
+				schema.name_sdk = vds::String(name);
+
+				std::vector<std::string> channelNames;
+				unsigned int numOutputs = this->Client.GetDeviceOutputCount(schema.name_sdk).DeviceOutputCount;
+				for (unsigned int idxOutput = 0; idxOutput < numOutputs; ++idxOutput)
+				{
+					vds::Output_GetDeviceOutputComponentName ret = this->Client.GetDeviceOutputComponentName(schema.name_sdk, idxOutput);
+					std::string outputName = ret.DeviceOutputName;
+					std::string componentName = ret.DeviceOutputComponentName;
+					schema.outputNames_sdk.push_back(vds::String(outputName));
+					schema.componentNames_sdk.push_back(vds::String(componentName));
+					channelNames.push_back(outputName + "." + componentName);
+				}
+
+				// All channels of a device have the same number of subsamples (the device rate / the Vicon rate)
+				unsigned int numSamples = 0;
+				if ( ! schema.outputNames_sdk.empty() )
+				{
+					numSamples = this->Client.GetDeviceOutputSubsamples(schema.name_sdk, schema.outputNames_sdk[0], schema.componentNames_sdk[0]).DeviceOutputSubsamples;
+				}
+
+				layout->Add(name, channelNames, numSamples);
+				this->DeviceSchemas.push_back(schema);
+			}
+			this->DeviceLayout = layout;
+			this->schemaRebuilds++;
+		}
+
+		// PURPOSE:
+		//	Only ask the Vicon PC for the data that the decode projection needs (less network and decode load)
+		//	Lazy markers still need marker data: a request may come at any time
+		//	The change applies from the next frames. Names may differ with the data sent => rebuild the cached layout
+		void ApplyDataEnables(const vdsi::FrameFilter& filter)
+		{
+			bool IsMarkersNeeded = ! filter.projection || filter.projection->IsMarkersNeeded;
+			bool IsPoseNeeded = ! filter.projection || filter.projection->IsPoseNeeded || ! IsMarkersNeeded;
+
+			if(IsPoseNeeded != this->IsSegmentDataEnabled)
+			{
+				auto result = IsPoseNeeded ? this->Client.EnableSegmentData().Result : this->Client.DisableSegmentData().Result;
+				if(result != vds::Result::Success) { std::cout << "WARNING_VDS: Failed to change segment data" << std::endl; }
+				this->IsSegmentDataEnabled = IsPoseNeeded;
+				this->IsSchemaStale = true;
+			}
+			if(IsMarkersNeeded != this->IsMarkerDataEnabled)
+			{
+				auto result = IsMarkersNeeded ? this->Client.EnableMarkerData().Result : this->Client.DisableMarkerData().Result;
+				if(result != vds::Result::Success) { std::cout << "WARNING_VDS: Failed to change marker data" << std::endl; }
+				this->IsMarkerDataEnabled = IsMarkersNeeded;
+				this->IsSchemaStale = true;
+			}
+		}
+
+		// PURPOSE: Decode all subjects in the cached layout
+		// OUTPUT:
+		//	Points = refilled with the decoded frame (call Points.EndRefill() after)
+		//	return = false if the cached layout no longer matches the frame
+		bool DecodeSubjects(vdsi::Points& Points, const vdsi::FrameFilter& filter)
+		{
+			Points.BeginRefill(Client.GetFrameNumber().FrameNumber);
+
+			// Loop over all subjects
+			for (auto& subject : this->Schema)
+			{
+				// Filtered out subjects are not decoded, only probed
+				//	A replaced subject that is filtered out would otherwise leave the cached layout stale forever
+				vdsi::DecodeFields fields = filter.FieldsOf(subject.handle);
+				if (fields == vdsi::DecodeFields::None)
+				{
+					if ( ! this->IsSubjectInFrame(subject) ) { return false; }
+					continue;
+				}
+
+				// Markers only
+				//	No pose => the occluded filter doesn't apply
+				if ( ! vdsi::HasPose(fields) || ! this->IsSegmentDataEnabled )
+				{
+					vdsi::Point_Object& point = Points.RefillNext();
+					point.Reset(subject.name, vdsi::RotationMatrix_NaN, vdsi::Translation_NaN, true, subject.handle);
+					if ( vdsi::HasMarkers(fields) && ! this->DecodeSubjectMarkers(subject, point) ) { return false; }
+					continue;
+				}
+
+				// Global translation
+				vds::Output_GetSegmentGlobalTranslation ret_P = this->Client.GetSegmentGlobalTranslation(subject.name_sdk, subject.segmentName_sdk);
+				if (ret_P.Result != vds::Result::Success) { return false; }
+				vdsi::Translation P;
+				std::copy(std::begin(ret_P.Translation), std::end(ret_P.Translation), P.begin());
+
+				// Global rotation matrix
+				//	Note: Vicon uses row major order
+				vds::Output_GetSegmentGlobalRotationMatrix ret_R = this->Client.GetSegmentGlobalRotationMatrix(subject.name_sdk, subject.segmentName_sdk);
+				if (ret_R.Result != vds::Result::Success) { return false; }
+				vdsi::RotationMatrix R;
+				std::copy(std::begin(ret_R.Rotation), std::end(ret_R.Rotation), R.begin());
+
+				bool IsOccluded = IsOccludedPose(ret_R.Rotation, ret_P.Translation);
+
+				// Save point to the return object if allowed by filters
+				if ( ! filter.Allows(subject.handle, IsOccluded) ) { continue; }
+				vdsi::Point_Object& point = Points.RefillNext();
+				point.Reset(subject.name, R, P, IsOccluded, subject.handle);
+
+				if ( vdsi::HasMarkers(fields) && ! this->DecodeSubjectMarkers(subject, point) ) { return false; }
+			}
+
+			return true;
+		}
+
+		// PURPOSE: Direct pose mode: find each listed object in the cached layout
+		void MapListed(const std::vector<vdsi::SubjectHandle>& handles)
+		{
+			this->Listed = handles;
+			this->schemaByListed.assign(handles.size(), NoSubject);
+			this->schemaUnlisted.clear();
+			for (uint32_t idxSubject = 0; idxSubject < this->Schema.size(); ++idxSubject)
+			{
+				auto it = std::find(handles.begin(), handles.end(), this->Schema[idxSubject].handle);
+				if (it == handles.end()) { this->schemaUnlisted.push_back(idxSubject); }
+				else { this->schemaByListed[size_t(it - handles.begin())] = idxSubject; }
+			}
+			this->IsListedStale = false;
+		}
+
+		// PURPOSE: Direct pose mode: decode the listed objects in the cached layout
+		// OUTPUT:
+		//	poses = one per listed object. Occluded if not in the frame
+		//	return = false if the cached layout no longer matches the frame
+		bool DecodeListed(vdsi::FixedPose* poses)
+		{
+			// Subjects that are not listed are only probed (as in DecodeSubjects)
+			for (uint32_t idxSubject : this->schemaUnlisted)
+			{
+				if ( ! this->IsSubjectInFrame(this->Schema[idxSubject]) ) { return false; }
+			}
+
+			for (size_t idx = 0; idx < this->schemaByListed.size(); ++idx)
+			{
+				vdsi::FixedPose& pose = poses[idx];
+				uint32_t idxSubject = this->schemaByListed[idx];
+				if (idxSubject == NoSubject || ! this->IsSegmentDataEnabled) { pose = vdsi::FixedPose(); continue; }
+				const SubjectSchema& subject = this->Schema[idxSubject];
+
+				vds::Output_GetSegmentGlobalTranslation ret_P = this->Client.GetSegmentGlobalTranslation(subject.name_sdk, subject.segmentName_sdk);
+				if (ret_P.Result != vds::Result::Success) { return false; }
+				vds::Output_GetSegmentGlobalRotationMatrix ret_R = this->Client.GetSegmentGlobalRotationMatrix(subject.name_sdk, subject.segmentName_sdk);
+				if (ret_R.Result != vds::Result::Success) { return false; }
+
+				// Note: Vicon uses row major order
+				std::copy(std::begin(ret_P.Translation), std::end(ret_P.Translation), pose.P.begin());
+				std::copy(std::begin(ret_R.Rotation), std::end(ret_R.Rotation), pose.R_rowMajor.begin());
+				pose.IsOccluded = IsOccludedPose(ret_R.Rotation, ret_P.Translation);
+			}
+			return true;
+		}
+
+		// PURPOSE: Cheap test that a subject of the cached layout is still in the frame (one query, no strings built)
+		bool IsSubjectInFrame(const SubjectSchema& subject)
+		{
+			auto result = this->IsSegmentDataEnabled ? this->Client.GetSegmentCount(subject.name_sdk).Result : this->Client.GetMarkerCount(subject.name_sdk).Result;
+			return result == vds::Result::Success;
+		}
+
+		// PURPOSE: Decode the markers of one subject, rebuilding its marker names if they changed
+		// OUTPUT:
+		//	point = markers appended
+		//	return = false if the subject is no longer in the frame
+		bool DecodeSubjectMarkers(SubjectSchema& subject, vdsi::Point_Object& point)
+		{
+			if ( ! this->IsMarkerDataEnabled ) { return true; }
+
+			// Markers added or removed => only this subject's marker names need to be rebuilt
+			vds::Output_GetMarkerCount retM = this->Client.GetMarkerCount(subject.name_sdk);
+			if (retM.Result != vds::Result::Success) { return false; }
+			unsigned int numM = retM.MarkerCount;
+			if (numM != subject.markerNames.size())
+			{
+				this->RebuildMarkerSchema(subject);
+				this->schemaRebuilds++;
+			}
+			if ( ! this->DecodeMarkers(subject, point) )
+			{
+				this->RebuildMarkerSchema(subject);
+				this->schemaRebuilds++;
+				point.markers.clear();
+				this->DecodeMarkers(subject, point);
+			}
+
+			return true;
+		}
+
+		// PURPOSE: Decode the markers of one subject in the cached layout
+		// OUTPUT:
+		//	point = markers appended
+		//	return = false if the cached marker names no longer match the frame
+		bool DecodeMarkers(const SubjectSchema& subject, vdsi::Point_Object& point)
+		{
+			for (size_t idxMarker = 0; idxMarker < subject.markerNames.size(); ++idxMarker)
+			{
+				// Maker global translation
+				vds::Output_GetMarkerGlobalTranslation retM_P = this->Client.GetMarkerGlobalTranslation(subject.name_sdk, subject.markerNames_sdk[idxMarker]);
+				if (retM_P.Result != vds::Result::Success) { return false; }
+				bool marker_IsOccluded = retM_P.Occluded;
+
+				// Save marker to object
+				//	Marker arrays should stay same size for a given object, otherwise access would be painful
+				//	Let's trust that VDS always specifies them in the same order...
+				if (!marker_IsOccluded)
+				{
+					vdsi::Translation MarkerP;
+					std::copy(std::begin(retM_P.Translation), std::end(retM_P.Translation), MarkerP.begin());
+					point.AddMarker(vdsi::Point_Marker(subject.markerNames[idxMarker], MarkerP, marker_IsOccluded));
+				}
+				else
+				{
+					// Create occluded
+					point.AddMarker(vdsi::Point_Marker(subject.markerNames[idxMarker]));
+				}
+			}
+			return true;
+		}
+
+		// PURPOSE: Query the names of all subjects, segments and markers in the current frame
+		void RebuildSchema()
+		{
+			this->Schema.clear();
+			unsigned int numS = this->Client.GetSubjectCount().SubjectCount;
+			for (unsigned int idxSubject = 0; idxSubject < numS; ++idxSubject)
+			{
+				SubjectSchema subject;
+				subject.name = this->Client.GetSubjectName(idxSubject).SubjectName;
+				subject.name_sdk = vds::String(subject.name);
+				subject.handle = this->Names->Intern(subject.name);
+
+				// Markers only (segment data not sent) => no segment to look up
+				if ( ! this->IsSegmentDataEnabled )
+				{
+					this->RebuildMarkerSchema(subject);
+					this->Schema.push_back(subject);
+					continue;
+				}
+
+				// Number of segments should always be 1 when using Vicon Tracker3... as far as I can tell
+				unsigned int SegmentCount = this->Client.GetSegmentCount(subject.name_sdk).SegmentCount;
+				if (SegmentCount!=1)
+				{
+					// If this happens, then you get to rewrite this interface to also loop over and store Segment data
+					// Refer to the example that comes with the Vicon DataStream SDK "ViconDataStreamSDK_CPPRetimerTest.cpp"
+					throw std::runtime_error("ERROR_VDS: Invalid assumption that segment count is 1");
+				}
+
+				// Segment name
+				unsigned int idxSegment = 0;
+				subject.segmentName_sdk = vds::String(std::string(this->Client.GetSegmentName(subject.name_sdk, idxSegment).SegmentName));
+
+				this->RebuildMarkerSchema(subject);
+				this->Schema.push_back(subject);
+			}
+			this->IsSchemaStale = false;
+			this->IsListedStale = true;
+			this->schemaRebuilds++;
+		}
+
+		// PURPOSE: Query the names of the markers of one subject
+		void RebuildMarkerSchema(SubjectSchema& subject)
+		{
+			subject.markerNames.clear();
+			subject.markerNames_sdk.clear();
+			unsigned int numM = this->Client.GetMarkerCount(subject.name_sdk).MarkerCount;
+			for (unsigned int idxMarker = 0; idxMarker < numM; ++idxMarker)
+			{
+				std::string MarkerName = this->Client.GetMarkerName(subject.name_sdk, idxMarker).MarkerName;
+				subject.markerNames.push_back(MarkerName);
+				subject.markerNames_sdk.push_back(vds::String(MarkerName));
+			}
+		}
+	};
+}
@@ -1,7 +1,7 @@
 /*
 Written by:			Brandon Johns
 Version created:	2021-11-04
-Last edited:		2022-04-28
+Last edited:		2026-10-17
 
 Version changes:
 	NA
@@ -13,24 +13,54 @@ Purpose:
 Class Summary:
 	VDS_Interface
 		Wrapper for the Vicon DataStream SDK
-
-	Point
-		Stores the position and rotation of vicon objects
-
-	Points
-		Stores collections Point objects.
-		Interface allows retrieval of a Point by name
+		Frames can instead come from a synthetic generator or a recording (see VDS_FrameSource.h)
+		Optionally, poses predicted to the time they are needed (see VDS_Retiming.h)
+		Optionally, recent poses addressable by time (see VDS_PoseHistory.h)
+		Optionally, frames pushed to callbacks (see VDS_Subscriptions.h)
+		Optionally, only the objects that moved since the last read (see VDS_Delta.h)
+		Optionally, quaternion and Euler angles of every object, computed as a batch (see VDS_PoseKernels.h)
+		Optionally, frames published to shared memory for other local processes (see VDS_SharedMemory.h)
+		Optionally, frames re-broadcast over UDP for other computers (see VDS_UdpRelay.h)
+		Optionally, user processing of each frame in stages on their own threads (see VDS_Pipeline.h)
+		Optionally, only the chosen fields of the chosen objects decoded, markers on demand (see EnableDecodeProjection)
+		Optionally, device channels and unlabeled markers, as flat arrays per frame (see VDS_Devices.h)
+		Optionally, only the poses of a fixed list of objects, decoded straight into a fixed frame (see VDS_Fixed.h)
+
+	Point, Point_Marker, Points
+		Storage of the returned data (see VDS_Points.h)
 
 */
 #pragma once
 
 // Vicon DataStream SDK
 #include "DataStreamClient.h"
-#include "DataStreamRetimingClient.h"
 namespace vds = ViconDataStreamSDK::CPP;
 
+// Brandon's VDS Interface helpers
+#include "VDS_Points.h"
+#include "VDS_FrameSource.h"
+#include "VDS_FrameSource_SDK.h"
+#include "VDS_Retiming.h"
+#include "VDS_PoseHistory.h"
+#include "VDS_Subscriptions.h"
+#include "VDS_Delta.h"
+#include "VDS_SharedMemory.h"
+#include "VDS_UdpRelay.h"
+#include "VDS_Pipeline.h"
+#include "VDS_Devices.h"
+#include "VDS_FrameHandoff.h"
+#include "VDS_NameRegistry.h"
+#include "VDS_FrameQueue.h"
+#include "VDS_Stats.h"
+
 // Standard library
 #include <iostream>
+#include <string>
+#include <array>
+#include <limits>
+#include <cmath>
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <chrono>
 #include <thread>
@@ -42,174 +72,79 @@ namespace vds = ViconDataStreamSDK::CPP;
 namespace vdsi
 {
 	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
-	// Stores the position and rotation of vicon objects
+	// Decode statistics (see VDS_Interface::GetDecodeStats)
 	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
-	// I suggest editing this to use the Armadillo C++ Maths library,
-	// but to keep it simple for the template, I use std::vector
-	class Point
+	struct DecodeStats
 	{
-	public:
-		// Object name, as appears in Vicon Tracker (VDS calls this the "SubjectName")
-		// Global Transformation - Rotation matrix, stored in row major order
-		// Global Transformation - Position vector
-		// Set if the object was occluded
-		std::string viconObjectName;
-		std::vector<double> R_rowMajor;
-		std::vector<double> P;
-		bool IsOccluded;
-
-		//********************************************************************************
-		// Interface: Create
-		//****************************************
-		// INPUT: (see variable defs)
-		Point(
-			std::string name_in,
-			std::vector<double> R_in = std::vector<double>(9, nan("")),
-			std::vector<double> P_in = std::vector<double>(3, nan("")),
-			bool occluded_in = true
-		) :
-			viconObjectName(name_in),
-			R_rowMajor(R_in),
-			P(P_in),
-			IsOccluded(occluded_in)
-		{
-			// Validate input
-			if(this->R_rowMajor.size() != 9) { throw std::runtime_error("ERROR_VDS: R_rowMajor is wrong size"); }
-			if(this->P.size() != 3)        { throw std::runtime_error("ERROR_VDS: P is wrong size"); }
-		}
-
-		//********************************************************************************
-		// Interface: Get
-		//****************************************
-		// OUTPUT: x,y,z coordinates
-		double x() { return this->P.at(0); }
-		double y() { return this->P.at(1); }
-		double z() { return this->P.at(2); }
-
-		// OUTPUT: the element of the rotation matrix, R(col,row)
-		//	Counting starts at 1, because I said so! => valid range=[1:3]
-		double R_at(uint8_t col, uint8_t row)
-		{
-			// Validate input
-			if(1>row||row>3 || 1>col||col>3) {throw  std::runtime_error("ERROR_VDS: Out of bounds");}
-
-			return this->R_rowMajor.at(3*(col-1) + (row-1));
-		}
+		// Frames decoded since Connect()
+		// Number of times the cached subject/segment/marker names were rebuilt
+		uint64_t framesDecoded = 0;
+		uint64_t schemaRebuilds = 0;
+
+		// Mean DecodeFrame() time [ns], of frames that used the cache, and of frames that rebuilt it
+		// Time saved per frame by the cache (meanDecodeNs_rebuild - meanDecodeNs_cached)
+		double meanDecodeNs_cached = vdsi::NaN;
+		double meanDecodeNs_rebuild = vdsi::NaN;
+		double savedNsPerFrame = vdsi::NaN;
 	};
 
-	class Point_Marker : public Point
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Frame queue statistics (see VDS_Interface::GetQueueStats)
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	struct QueueStats
 	{
-	public:
-		//********************************************************************************
-		// Interface: Create
-		//****************************************
-		// INPUT: (see variable defs)
-		Point_Marker(
-			std::string name_in,
-			std::vector<double> P_in = std::vector<double>(3, nan("")),
-			bool occluded_in = true
-		) :
-			Point(
-				name_in,
-				std::vector<double>(9, nan("")),
-				P_in,
-				occluded_in)
-		{
-			// Nothing to do
-		}
+		// Frames put in the queue since EnableFrameQueue()
+		// Frames dropped because the queue was full (the consumer fell behind by more than the capacity)
+		// Largest number of frames waiting in the queue at once
+		// Capacity of the queue (0 if not enabled)
+		uint64_t framesQueued = 0;
+		uint64_t overruns = 0;
+		uint64_t maxOccupancy = 0;
+		uint64_t capacity = 0;
+
+		// Frames never received by the update thread since Connect(), as seen by jumps in the VDS frame number
+		//	Counted whether or not the queue is enabled
+		uint64_t frameNumberGaps = 0;
 	};
 
-	class Point_Object : public Point
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Latency and throughput statistics (see VDS_Interface::GetStats)
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// All durations in nanoseconds, over the most recent ~1000-2000 frames
+	struct FrameStats
 	{
-	public:
-		// Child markers of this point
-		std::vector<vdsi::Point_Marker> markers;
-
-		//********************************************************************************
-		// Interface: Create
-		//****************************************
-		// INPUT: (see variable defs)
-		Point_Object(
-			std::string name_in,
-			std::vector<double> R_in = std::vector<double>(9, nan("")),
-			std::vector<double> P_in = std::vector<double>(3, nan("")),
-			bool occluded_in = true
-		) :
-			Point(
-				name_in,
-				R_in,
-				P_in,
-				occluded_in)
-		{
-			// Nothing to do
-		}
-
-		//********************************************************************************
-		// Interface: Set
-		//****************************************
-		// INPUT: Point_Marker
-		void AddMarker(vdsi::Point_Marker marker)
-		{
-			// Save point
-			this->markers.push_back(marker);
-		}
-
-		//********************************************************************************
-		// Interface: Get
-		//****************************************
-		// INPUT: Marker name
-		// OUTPUT: Copy of the found Marker
-		vdsi::Point_Marker Get(std::string name)
-		{
-			for (auto&& marker : this->markers)
-			{
-				// Return copy of point upon finding
-				if (marker.viconObjectName == name) { return vdsi::Point_Marker(marker); }
-			}
-
-			// No point found => return occluded
-			return vdsi::Point_Marker(name);
-		}
-
+		// Latency reported by the SDK: camera => this computer
+		// Decoding and filtering in the update thread
+		// Decoded => taken by the user
+		// Camera => taken by the user (latencySDK + tPickup - tReceived)
+		vdsi::HistogramSummary latencySDK;
+		vdsi::HistogramSummary decode;
+		vdsi::HistogramSummary pickup;
+		vdsi::HistogramSummary endToEnd;
+
+		// Time between frames arriving at the update thread
+		// Frame rate jitter = interval.p99 - interval.p50
+		vdsi::HistogramSummary interval;
+		double jitter = vdsi::NaN;
 	};
 
 	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
-	// Manages points of the Point class - storage, retrieval by name
+	// Receiver of the poses of the direct pose mode (see VDS_Interface::EnableDirectPoses)
 	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
-	class Points
+	// Called only by the update thread: BeginPoses(), then CommitPoses() once the poses are written
+	class DirectPoseTarget
 	{
 	public:
-		// Vector of Point objects
-		// VDS Frame number (incremental counter)
-		std::vector<vdsi::Point_Object> all;
-		unsigned int frameNumber = 0;
+		virtual ~DirectPoseTarget() = default;
 
-		//********************************************************************************
-		// Interface: Set
-		//****************************************
-		// INPUT: Point
-		void AddPoint(vdsi::Point_Object point)
-		{
-			// Save point
-			this->all.push_back(point);
-		}
+		// OUTPUT: Storage of the next frame: one pose per object, in the order of the names given to EnableDirectPoses()
+		virtual vdsi::FixedPose* BeginPoses() = 0;
 
-		//********************************************************************************
-		// Interface: Get
-		//****************************************
-		// INPUT: Point name
-		// OUTPUT: Copy of the found point
-		vdsi::Point_Object Get(std::string name)
-		{
-			for(auto&& point : this->all)
-			{
-				// Return copy of point upon finding
-				if (point.viconObjectName == name) { return vdsi::Point_Object(point); }
-			}
+		// PURPOSE: The poses of BeginPoses() hold a new frame
+		virtual void CommitPoses(unsigned int frameNumber, const vdsi::FrameTiming& timing) = 0;
 
-			// No point found => return occluded
-			return vdsi::Point_Object(name);
-		}
+		// PURPOSE: The frame source has ended (see VDS_Interface::IsEndOfStream): no more poses will come
+		virtual void EndOfPoses() {}
 	};
 
 	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -219,24 +154,142 @@ namespace vdsi
 	class VDS_Interface
 	{
 	private:
-		vds::Client Client;
+		// Where frames come from (the Vicon system, or a stand-in)
+		// Address of the Vicon system, if connected to one (empty for stand-in sources)
+		std::unique_ptr<vdsi::FrameSource> Source;
+		std::string HostName_SDK;
+		bool IsLightweight_SDK = false;
+
+		// Retiming mode (see EnableRetiming)
+		//	Newest frame of the update thread, to report the age of the retimed poses
+		std::atomic<std::shared_ptr<vdsi::Retimer>> Retiming;
+		std::atomic<int64_t> Retiming_OutputLatencyNs = 0;
+		std::atomic<int64_t> LatestCapturedNs = 0;
+		std::atomic<unsigned int> LatestFrameNumber = 0;
+
+		// Pose history mode (see EnablePoseHistory)
+		std::atomic<std::shared_ptr<vdsi::PoseHistory>> History;
+
+		// Callbacks of each new frame (see Subscribe)
+		vdsi::FrameDispatcher Dispatcher;
+
+		// Delta mode (see EnableDeltaMode)
+		//	The tracker is only accessed by the publishing thread (the update thread, or the last thread of the pipeline)
+		std::atomic<std::shared_ptr<const vdsi::DeltaSettings>> Delta_Settings;
+		vdsi::ChangeTracker Changes;
+
+		// Pose kernels: fill Points::poses of each frame (see EnablePoseKernels)
+		std::atomic<bool> IsPoseKernelsActive = false;
+
+		// Shared memory publisher (see EnableSharedMemory)
+		std::atomic<std::shared_ptr<vdsi::ShmPublisher>> SharedMemory;
+
+		// UDP relay (see EnableUdpRelay)
+		std::atomic<std::shared_ptr<vdsi::UdpRelay>> Relay;
+
+		// Pipeline mode (see EnablePipeline)
+		//	The stages are set while disconnected. The pipeline (threads and queues) exists while connected
+		std::vector<vdsi::PipelineStage> Pipeline_Stages;
+		vdsi::PipelineSettings Pipeline_Settings;
+		bool IsPipelineEnabled = false;
+		std::unique_ptr<vdsi::FramePipeline> Pipeline;
+
+		// Direct pose mode (see EnableDirectPoses)
+		//	Set while disconnected. Only read by the update thread while connected
+		std::vector<vdsi::SubjectHandle> DirectPoses_Handles;
+		vdsi::DirectPoseTarget* DirectPoses_Target = nullptr;
 
 		// System data
 		std::atomic<double> ViconFrameRate = nan("");
 
+		// Handles of all object names seen
+		vdsi::NameRegistry Names;
+
 		// User settings: Filter enables and list
+		//	The list is resolved to handles when the filter is set (see vdsi::ObjectFilter)
+		//	The list is swapped atomically, as the update thread reads it while the user may change it
 		std::atomic<bool> IsObjectFilterActive = false;
 		std::atomic<bool> IsOccludedFilterActive = false;
-		std::vector<std::string> filter_AllowedObjects;
+		std::atomic<std::shared_ptr<const vdsi::ObjectFilter>> filter_AllowedObjects;
+
+		// User settings: Fields to decode of each object (see EnableDecodeProjection)
+		//	Lazy markers: the markers requested by consumers (see RequestMarkers)
+		std::atomic<std::shared_ptr<const vdsi::DecodeProjection>> filter_Projection;
+		vdsi::MarkerDemand MarkerRequests;
+
+		// Filter applied to the frame being decoded (only accessed by the update thread)
+		vdsi::FrameFilter filter_ThisFrame;
 
 		// Internal state control
 		std::unique_ptr<std::thread> UpdateThread;
 		std::atomic<bool> IsConnected = false;
 		std::atomic<bool> IsKillRequest = false;
-		std::atomic<bool> IsFrameReady = false;
+		std::atomic<bool> IsSourceEnded = false;
+		vdsi::FrameSignal FrameReady;
 		std::atomic<bool> HasLatestFrameBeenRead = false;
-		vdsi::Points LatestFrame;
-		std::mutex mtx_LatestFrame;
+
+		// User settings: How GetFrame() waits for a frame
+		std::atomic<vdsi::WaitPolicy> Wait_Policy = vdsi::WaitPolicy::Spin;
+		std::atomic<int64_t> Wait_TimeoutNs = 0;
+
+		// Latest frame, handed from the update thread to GetFrame()
+		//	The update thread never waits on a reader
+		//	Readers only wait for each other (mtx_Readers)
+		vdsi::TripleBuffer<vdsi::Points> LatestFrame;
+		std::mutex mtx_Readers;
+
+		// Latest frame as an immutable snapshot, for any number of readers at once (see GetFrameShared)
+		//	Only published once someone has asked for it
+		//	SharedReady is set once a snapshot is published (apart from FrameReady, so that the first use does not delay GetFrame())
+		std::atomic<std::shared_ptr<const vdsi::Points>> LatestShared;
+		std::atomic<bool> IsSharedFrameActive = false;
+		vdsi::FrameSignal SharedReady;
+		vdsi::SnapshotPool<vdsi::Points> SharedSnapshots; // Only accessed by the publishing thread
+
+		// Working storage of the update thread, reused every frame
+		//	Only used while the object filter is active (frames are otherwise decoded straight into the back buffer)
+		vdsi::Points DecodedFrame;
+
+		// Lossless mode: every frame is also queued (see EnableFrameQueue)
+		//	The update thread never waits on the consumer. If the queue is full, the frame is dropped and counted
+		std::atomic<std::shared_ptr<vdsi::SpscRing<vdsi::Points>>> FrameQueue;
+		vdsi::FrameSignal QueueReady;
+		std::mutex mtx_QueueReaders;
+
+		// Queue statistics
+		std::atomic<uint64_t> stats_FramesQueued = 0;
+		std::atomic<uint64_t> stats_QueueOverruns = 0;
+		std::atomic<uint64_t> stats_QueueMaxOccupancy = 0;
+		std::atomic<uint64_t> stats_FrameNumberGaps = 0;
+		unsigned int LastFrameNumber = 0; // Only accessed by the update thread
+
+		// Device channels and unlabeled markers (see EnableDeviceData)
+		//	Latest frame as for LatestFrame, and every frame queued as for FrameQueue
+		std::atomic<std::shared_ptr<const vdsi::DeviceSettings>> Device_Settings;
+		vdsi::TripleBuffer<vdsi::DeviceFrame> LatestDevices;
+		std::mutex mtx_DeviceReaders;
+		std::atomic<std::shared_ptr<vdsi::SpscRing<vdsi::DeviceFrame>>> DeviceQueue;
+		vdsi::FrameSignal DeviceReady;
+		std::mutex mtx_DeviceQueueReaders;
+		std::atomic<uint64_t> stats_DeviceFramesQueued = 0;
+		std::atomic<uint64_t> stats_DeviceQueueOverruns = 0;
+		std::atomic<uint64_t> stats_DeviceQueueMaxOccupancy = 0;
+
+		// Latency statistics
+		vdsi::RollingHistogram stats_LatencySDK;
+		vdsi::RollingHistogram stats_Decode;
+		vdsi::RollingHistogram stats_Pickup;
+		vdsi::RollingHistogram stats_EndToEnd;
+		vdsi::RollingHistogram stats_Interval;
+		vdsi::FrameTiming::Clock::time_point LastReceived; // Only accessed by the update thread
+
+		// Decode statistics
+		std::atomic<uint64_t> stats_FramesDecoded = 0;
+		std::atomic<uint64_t> stats_SchemaRebuilds = 0;
+		std::atomic<uint64_t> stats_FramesCached = 0;
+		std::atomic<double> stats_DecodeNs_cached = 0;
+		std::atomic<uint64_t> stats_FramesRebuilt = 0;
+		std::atomic<double> stats_DecodeNs_rebuild = 0;
 
 	public:
 		//********************************************************************************
@@ -259,33 +312,61 @@ namespace vdsi
 		{
 			if(this->IsConnected) { return; } // Nothing to do
 
-			// Connect to server
-			if(this->Client.Connect(HostName).Result != vds::Result::Success)
-			{
-				throw std::runtime_error("ERROR_VDS: Failed to connect to " + HostName);
-			}
+			this->Connect(std::make_unique<vdsi::FrameSource_SDK>(HostName, EnableLightweight));
+			this->HostName_SDK = HostName;
+			this->IsLightweight_SDK = EnableLightweight;
+		}
+
+		// PURPOSE:
+		//	Same as Connect(), but take frames from any source
+		//	e.g. test without a Vicon system:
+		//		VDS.Connect(std::make_unique<vdsi::FrameSource_Synthetic>(vdsi::SyntheticSettings{}));
+		//		VDS.Connect(std::make_unique<vdsi::FrameSource_Replay>("tmp.vdsbin"));
+		void Connect(std::unique_ptr<vdsi::FrameSource> source)
+		{
+			if(this->IsConnected) { return; } // Nothing to do
 
-			// Apply options
-			bool lightweightResult = EnableLightweight ? this->Client.EnableLightweightSegmentData().Result != vds::Result::Success : true;
-			bool streamModeResult = this->Client.SetStreamMode( vds::StreamMode::ServerPush ).Result == vds::Result::Success;
-			bool segmentDataResult = this->Client.EnableSegmentData().Result == vds::Result::Success;
-			bool markerDataResult = this->Client.EnableMarkerData().Result == vds::Result::Success;
-			bool wasSuccessful =
-				   lightweightResult
-				&& streamModeResult
-				&& segmentDataResult
-				&& markerDataResult;
-			if( !wasSuccessful ) { throw std::runtime_error("ERROR_VDS: Failed to initialise"); }
+			// Connect to source
+			//	Device data enabled before => ask for it now, so that it arrives with the first frames
+			source->Connect(this->Names);
+			auto deviceSettings = this->Device_Settings.load();
+			if(deviceSettings) { source->ApplyDeviceSettings(*deviceSettings); }
+			this->Source = std::move(source);
+			this->HostName_SDK.clear();
 
 			// Start thread to listen for data
+			this->stats_FramesDecoded = 0;
+			this->stats_SchemaRebuilds = 0;
+			this->stats_FramesCached = 0;
+			this->stats_DecodeNs_cached = 0;
+			this->stats_FramesRebuilt = 0;
+			this->stats_DecodeNs_rebuild = 0;
+			this->stats_FrameNumberGaps = 0;
+			this->LastFrameNumber = 0;
+			this->LatestCapturedNs = 0;
+			this->LatestFrameNumber = 0;
+			this->stats_LatencySDK.Clear();
+			this->stats_Decode.Clear();
+			this->stats_Pickup.Clear();
+			this->stats_EndToEnd.Clear();
+			this->stats_Interval.Clear();
+			this->LastReceived = vdsi::FrameTiming::Clock::time_point();
 			this->IsKillRequest = false;
-			this->IsFrameReady = false;
+			this->IsSourceEnded = false;
+			this->FrameReady.Clear();
+			this->SharedReady.Clear();
 			this->HasLatestFrameBeenRead = false;
+			this->LatestShared.store(nullptr);
+			if(this->IsPipelineEnabled)
+			{
+				this->Pipeline = std::make_unique<vdsi::FramePipeline>(this->Pipeline_Stages, this->Pipeline_Settings, [this](vdsi::Points& frame) { this->PublishPipelineFrame(frame); });
+			}
 			this->UpdateThread = std::make_unique<std::thread>( [this] { this->UpdateFrameInBackground(); });
 			this->IsConnected = true;
 
 			// Get first frame to initialise
-			this->GetFrame();
+			//	Direct pose mode: there is no frame of Points (the target waits for its own poses)
+			if( ! this->DirectPoses_Target ) { this->GetFrame(); }
 
 			std::cout << "INFO_VDS: Ready to capture data" << std::endl;
 		}
@@ -298,11 +379,15 @@ namespace vdsi
 		{
 			if( ! this->IsConnected) { return; } // Nothing to do
 
+			this->DisableRetiming();
+
 			// Set kill flag and wait for thread to finish it's last loop
 			this->IsKillRequest = true;
 			this->UpdateThread->join();
+			this->Pipeline.reset();
 
-			this->Client.Disconnect();
+			this->Source->Disconnect();
+			this->Source.reset();
 			this->IsConnected = false;
 		}
 
@@ -321,17 +406,307 @@ namespace vdsi
 		//	Names of all the objects that you want to capture. Other captured objects will be discarded
 		void EnableObjectFilter(std::vector<std::string> allowedObjects)
 		{
+			this->filter_AllowedObjects = vdsi::ObjectFilter::Create(allowedObjects, this->Names);
 			this->IsObjectFilterActive = true;
-			this->filter_AllowedObjects = allowedObjects;
-			this->IsFrameReady = false;
+			this->InvalidateLatestFrame();
 		}
 
 		// PURPOSE: Show all captured objects in the output
 		// PURPOSE: Do not show occluded objects in the output
 		// PURPOSE: Show all captured objects in the output
-		void DisableObjectFilter()   { this->IsObjectFilterActive = false;   this->IsFrameReady = false; }
-		void EnableOccludedFilter()  { this->IsOccludedFilterActive = true;  this->IsFrameReady = false; }
-		void DisableOccludedFilter() { this->IsOccludedFilterActive = false; this->IsFrameReady = false;}
+		void DisableObjectFilter()   { this->IsObjectFilterActive = false;   this->InvalidateLatestFrame(); }
+		void EnableOccludedFilter()  { this->IsOccludedFilterActive = true;  this->InvalidateLatestFrame(); }
+		void DisableOccludedFilter() { this->IsOccludedFilterActive = false; this->InvalidateLatestFrame();}
+
+		// PURPOSE:
+		//	Decode projection: choose which fields of which objects are decoded (pose, markers, both, or none)
+		//	Objects with no fields are skipped before anything of them is queried. With the SDK, data that no object needs is not sent (e.g. no markers)
+		//	Markers only: the pose is NaN and occluded, and the occluded filter does not apply
+		//	Lazy markers: markers are only decoded while requested with RequestMarkers() (the SDK frame is gone by the time a consumer reads it)
+		// INPUT: settings = fields of each listed object, and of all other objects (see vdsi::ProjectionSettings)
+		void EnableDecodeProjection(const vdsi::ProjectionSettings& settings)
+		{
+			this->filter_Projection = vdsi::DecodeProjection::Create(settings, this->Names);
+			this->InvalidateLatestFrame();
+		}
+
+		// PURPOSE: Decode all fields of every object
+		void DisableDecodeProjection() { this->filter_Projection.store(nullptr); this->InvalidateLatestFrame(); }
+
+		// PURPOSE:
+		//	Lazy markers: decode the markers of these objects in the frames received during the hold time (see vdsi::ProjectionSettings::markerHold)
+		//	Call again before the hold runs out (e.g. every loop) for as long as the markers are needed
+		//	Frames already decoded are not changed => the markers appear from the next frame
+		// INPUT: handle(s) or names of the objects
+		void RequestMarkers(vdsi::SubjectHandle handle)
+		{
+			auto projection = this->filter_Projection.load();
+			int64_t holdNs = projection ? projection->markerHoldNs : 0;
+			int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(vdsi::FrameTiming::Clock::now().time_since_epoch()).count();
+			this->MarkerRequests.Request(handle, nowNs + holdNs);
+		}
+		void RequestMarkers(const std::vector<std::string>& names)
+		{
+			for(auto& name : names) { this->RequestMarkers(this->Names.Intern(name)); }
+		}
+
+		// PURPOSE:
+		//	Choose how GetFrame() waits for a frame (see vdsi::WaitPolicy)
+		//	The default (Spin) gives the lowest latency, but uses a full CPU core per waiting thread
+		// INPUT:
+		//	policy = Spin, SpinYield, or Block
+		//	timeout = give up waiting after this long. Zero = wait forever
+		void SetWaitPolicy(vdsi::WaitPolicy policy, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::zero())
+		{
+			this->Wait_Policy = policy;
+			this->Wait_TimeoutNs = timeout.count();
+		}
+
+		// PURPOSE:
+		//	Lossless mode: queue every decoded frame, for retrieval with GetFrames()
+		//	Use when every frame must be recorded, but the consumer may sometimes stall (e.g. writing to disk)
+		//	GetFrame() and friends still return the latest frame as usual
+		// INPUT:
+		//	capacity = maximum number of frames held. Frames arriving while the queue is full are dropped and counted (see GetQueueStats)
+		//	e.g. capacity = 2 seconds of frames => 2*GetFrameRate()
+		void EnableFrameQueue(size_t capacity)
+		{
+			this->stats_FramesQueued = 0;
+			this->stats_QueueOverruns = 0;
+			this->stats_QueueMaxOccupancy = 0;
+			this->FrameQueue = std::make_shared<vdsi::SpscRing<vdsi::Points>>(capacity);
+		}
+
+		// PURPOSE: Stop queueing frames. Frames still in the queue are discarded
+		void DisableFrameQueue() { this->FrameQueue.store(nullptr); }
+
+		// PURPOSE:
+		//	Retiming mode: get poses predicted (or interpolated) to the time they are needed, with GetFrame_Retimed()
+		//	For control loops faster than Vicon. Opens a 2nd connection to Vicon, through the SDK retiming client
+		//	Requires Connect(HostName) (not available with stand-in frame sources)
+		// INPUT:
+		//	outputLatency = time from getting the pose until it takes effect (e.g. actuation). Poses are predicted forward by this
+		//	maxPrediction = never predict further than this past the newest Vicon sample
+		void EnableRetiming(std::chrono::nanoseconds outputLatency, std::chrono::nanoseconds maxPrediction = std::chrono::milliseconds(100))
+		{
+			if( ! this->IsConnected || this->HostName_SDK.empty() ) { throw std::runtime_error("ERROR_VDS: Retiming requires Connect(HostName)"); }
+
+			auto retimer = std::make_shared<vdsi::Retimer>(this->HostName_SDK, this->IsLightweight_SDK, this->Names);
+			retimer->SetTiming(outputLatency, maxPrediction);
+			this->Retiming_OutputLatencyNs = outputLatency.count();
+			this->Retiming = retimer;
+		}
+
+		// PURPOSE: Close the connection of the retiming client
+		void DisableRetiming() { this->Retiming.store(nullptr); }
+
+		// PURPOSE:
+		//	Pose history mode: keep the recent poses of each object, for GetPoseAt()
+		//	For controllers that compensate for latency, and need the pose at a given time rather than the latest frame
+		//	Records the objects that pass the filters. Works with any frame source
+		// INPUT: settings = samples held per object, and limits of interpolation and extrapolation (see vdsi::PoseHistorySettings)
+		void EnablePoseHistory(const vdsi::PoseHistorySettings& settings = vdsi::PoseHistorySettings())
+		{
+			this->History = std::make_shared<vdsi::PoseHistory>(settings);
+		}
+
+		// PURPOSE: Stop recording the pose history. The recorded history is discarded
+		void DisablePoseHistory() { this->History.store(nullptr); }
+
+		// PURPOSE:
+		//	Delta mode: stamp each object with a generation counter (Point_Object::generation), incremented when it moves or its occlusion flips
+		//	Then GetFrameDelta() gives each consumer only the objects that changed since its last read
+		//	For large scenes of mostly static objects
+		//	Needs the occluded filter disabled: it removes an object that becomes occluded before the change is stamped
+		//		=> its consumers would keep the last pose, with no sign that the object left (GetFrameDelta throws instead)
+		// INPUT: settings = how far an object must move to count as changed (see vdsi::DeltaSettings)
+		void EnableDeltaMode(const vdsi::DeltaSettings& settings = vdsi::DeltaSettings())
+		{
+			this->Delta_Settings = std::make_shared<const vdsi::DeltaSettings>(settings);
+			this->InvalidateLatestFrame();
+		}
+
+		// PURPOSE: Stop stamping generations (all objects then read as changed)
+		void DisableDeltaMode() { this->Delta_Settings.store(nullptr); this->InvalidateLatestFrame(); }
+
+		// PURPOSE:
+		//	Compute the occlusion, quaternion, and Euler angles of every object of each frame, in the update thread
+		//	Read them from frame.poses, at the index of the object in frame.all (see Points::IndexOf)
+		//	The objects are converted as a batch with SIMD instructions (see VDS_PoseKernels.h)
+		//	For a few objects, the accessors of Point (quat_xyzw(), euler_rpy()) are just as good
+		void EnablePoseKernels() { this->IsPoseKernelsActive = true; this->InvalidateLatestFrame(); }
+
+		// PURPOSE: Stop computing poses (frame.poses is then empty)
+		void DisablePoseKernels() { this->IsPoseKernelsActive = false; this->InvalidateLatestFrame(); }
+
+		// PURPOSE:
+		//	Publish every frame into POSIX shared memory, for other processes on this computer (see VDS_SharedMemory.h)
+		//	They read it with vdsi::ShmReader, without linking the Vicon DataStream SDK (see vds_shm_reader)
+		//	The frames are published after the filters, as GetFrame() returns them
+		// INPUT: settings = name of the shared memory, and the most subjects and markers per frame
+		void EnableSharedMemory(const vdsi::ShmSettings& settings = vdsi::ShmSettings())
+		{
+			// Close the old publisher first, in case it has the same name
+			this->SharedMemory.store(nullptr);
+			this->SharedMemory = std::make_shared<vdsi::ShmPublisher>(settings);
+		}
+
+		// PURPOSE: Stop publishing, and remove the shared memory
+		void DisableSharedMemory() { this->SharedMemory.store(nullptr); }
+
+		// PURPOSE:
+		//	Re-broadcast every frame over UDP, so that other computers need no connection of their own to the Vicon PC (see VDS_UdpRelay.h)
+		//	They receive with vdsi::UdpReceiver, without the Vicon DataStream SDK (see vds_udp_receiver)
+		//	The frames are sent after the filters, as GetFrame() returns them. Sending never stalls the update thread
+		// INPUT: settings = destination (multicast group or one computer), precision, and whether to send markers
+		void EnableUdpRelay(const vdsi::UdpRelaySettings& settings = vdsi::UdpRelaySettings())
+		{
+			this->Relay = std::make_shared<vdsi::UdpRelay>(settings);
+		}
+
+		// PURPOSE: Stop sending
+		void DisableUdpRelay() { this->Relay.store(nullptr); }
+
+		// PURPOSE:
+		//	Pipeline mode: run user processing of each frame (e.g. smoothing, transforms) in stages, each on its own thread (see VDS_Pipeline.h)
+		//	The update thread then only waits for, decodes and filters each frame, so slow stages do not delay the next frame from Vicon
+		//	Frames reach GetFrame(), subscriptions and the other modes after the last stage
+		//	Set while disconnected. Applies from the next Connect()
+		// INPUT:
+		//	stages = in order. A stage may change the poses and markers of the objects, but not add or remove objects
+		//	settings = queue capacity, and worker threads for per object work (see vdsi::PipelineSettings)
+		void EnablePipeline(std::vector<vdsi::PipelineStage> stages, const vdsi::PipelineSettings& settings = vdsi::PipelineSettings())
+		{
+			if(this->IsConnected) { throw std::runtime_error("ERROR_VDS: (EnablePipeline) Set the pipeline before Connect()"); }
+			this->Pipeline_Stages = std::move(stages);
+			this->Pipeline_Settings = settings;
+			this->IsPipelineEnabled = true;
+		}
+
+		// PURPOSE: Process frames in the update thread again, from the next Connect()
+		void DisablePipeline()
+		{
+			if(this->IsConnected) { throw std::runtime_error("ERROR_VDS: (DisablePipeline) Change the pipeline before Connect()"); }
+			this->Pipeline_Stages.clear();
+			this->IsPipelineEnabled = false;
+		}
+
+		// PURPOSE:
+		//	Direct pose mode: decode only the poses of a fixed list of objects, straight into target (see VDS_Fixed.h)
+		//	With Connect(HostName), no names are handled and no frame of Points is made per frame (see FrameSource::DecodePoses)
+		//	=> GetFrame(), the frame queue, subscriptions, and the modes that take the frame (history, delta, shared memory, relay, pipeline) get no frames
+		//	The object filter and decode projection still apply. Device data still works
+		//	Set while disconnected. Applies from the next Connect()
+		// INPUT:
+		//	objectNames = objects to decode, in the order of the poses
+		//	target = receives the poses. Must outlive the connection
+		void EnableDirectPoses(const std::vector<std::string>& objectNames, vdsi::DirectPoseTarget& target)
+		{
+			if(this->IsConnected) { throw std::runtime_error("ERROR_VDS: (EnableDirectPoses) Set the direct pose mode before Connect()"); }
+			this->DirectPoses_Handles.clear();
+			for(auto& name : objectNames) { this->DirectPoses_Handles.push_back(this->Names.Intern(name)); }
+			this->DirectPoses_Target = &target;
+		}
+
+		// PURPOSE: Decode frames of Points again, from the next Connect()
+		void DisableDirectPoses()
+		{
+			if(this->IsConnected) { throw std::runtime_error("ERROR_VDS: (DisableDirectPoses) Change the direct pose mode before Connect()"); }
+			this->DirectPoses_Handles.clear();
+			this->DirectPoses_Target = nullptr;
+		}
+
+		// OUTPUT: For each stage, then for publishing: frames processed and dropped, time queued, time in the stage
+		//	Empty if not connected in pipeline mode. Decoding is in GetStats().decode
+		std::vector<vdsi::PipelineStageStats> GetPipelineStats() const
+		{
+			return this->Pipeline ? this->Pipeline->Stats() : std::vector<vdsi::PipelineStageStats>();
+		}
+
+		// PURPOSE:
+		//	Decode device channels (force plates, analog inputs) and unlabeled markers, as flat arrays per frame (see VDS_Devices.h)
+		//	Read the latest with GetDeviceFrame(), or every frame with GetDeviceFrames() (e.g. to record them)
+		//	Decoded by the update thread after each frame, separately from the subjects (not filtered, not in the pipeline)
+		// INPUT: settings = which data, and the capacity of the queue (see vdsi::DeviceSettings)
+		void EnableDeviceData(const vdsi::DeviceSettings& settings = vdsi::DeviceSettings())
+		{
+			this->stats_DeviceFramesQueued = 0;
+			this->stats_DeviceQueueOverruns = 0;
+			this->stats_DeviceQueueMaxOccupancy = 0;
+			this->DeviceQueue = std::make_shared<vdsi::SpscRing<vdsi::DeviceFrame>>(settings.queueCapacity);
+			this->Device_Settings = std::make_shared<const vdsi::DeviceSettings>(settings);
+		}
+
+		// PURPOSE: Stop decoding devices and unlabeled markers. Frames still in the queue are discarded
+		void DisableDeviceData()
+		{
+			this->Device_Settings.store(nullptr);
+			this->DeviceQueue.store(nullptr);
+		}
+
+		// OUTPUT: Frames and datagrams sent since EnableUdpRelay(). All 0 if not enabled
+		vdsi::UdpRelayStats GetUdpRelayStats() const
+		{
+			auto relay = this->Relay.load();
+			return relay ? relay->Stats() : vdsi::UdpRelayStats();
+		}
+
+		//********************************************************************************
+		// Interface: Subscriptions
+		//****************************************
+		// PURPOSE:
+		//	Have a callback called with each new frame, instead of polling GetFrame()
+		//	The callback gets a read-only view of the frame (no copy per subscriber)
+		//	Subscriptions are kept through Disconnect() and Connect()
+		// INPUT:
+		//	callback = called with every frame
+		//	settings:
+		//		mode = Inline: called on the update thread (pipeline mode: its last thread). Keep it short, as it delays every frame
+		//		mode = Dispatched: called on the dispatcher threads. If it falls behind by backlogMax frames, its oldest frames are dropped
+		// OUTPUT: Id of the subscription (see Unsubscribe, GetSubscriberStats)
+		vdsi::SubscriptionId Subscribe(vdsi::FrameCallback callback, const vdsi::SubscriptionSettings& settings = vdsi::SubscriptionSettings())
+		{
+			return this->Dispatcher.Subscribe(std::move(callback), settings);
+		}
+
+		// PURPOSE:
+		//	Same as Subscribe(callback), but only for some objects
+		//	The callback is called once for each listed object in the frame (after the filters). Frames without them are skipped
+		// INPUT: objectNames = names of the objects
+		vdsi::SubscriptionId Subscribe(const std::vector<std::string>& objectNames, vdsi::SubjectCallback callback, const vdsi::SubscriptionSettings& settings = vdsi::SubscriptionSettings())
+		{
+			std::vector<vdsi::SubjectHandle> handles;
+			for(auto& name : objectNames) { handles.push_back(this->GetHandle(name)); }
+			return this->Dispatcher.Subscribe(std::move(handles), std::move(callback), settings);
+		}
+
+		// PURPOSE:
+		//	Stop calling the callback. Waits for a call in progress to finish
+		//	Don't call from within the callback itself
+		// OUTPUT: false if there was no such subscription
+		bool Unsubscribe(vdsi::SubscriptionId id) { return this->Dispatcher.Unsubscribe(id); }
+
+		// PURPOSE:
+		//	Number of threads that run Dispatched callbacks (default 2)
+		//	Set before the first Dispatched subscription
+		void SetDispatcherThreads(size_t numThreads) { this->Dispatcher.SetNumWorkers(numThreads); }
+
+		// PURPOSE:
+		//	Get counters of a subscriber: frames delivered and dropped, and time spent in the callback
+		//	Check framesDropped to see if a Dispatched subscriber keeps up
+		vdsi::SubscriberStats GetSubscriberStats(vdsi::SubscriptionId id) const { return this->Dispatcher.Stats(id); }
+
+		//********************************************************************************
+		// Interface: Names
+		//****************************************
+		// PURPOSE:
+		//	Resolve an object name to a handle, for constant time lookup with Points::Find(handle)
+		//	Resolve once (e.g. before the main loop), then reuse the handle for every frame
+		//	The object does not need to be in the scene yet
+		vdsi::SubjectHandle GetHandle(const std::string& name) { return this->Names.Intern(name); }
+
+		// OUTPUT: Name of the object that the handle refers to
+		std::string GetName(vdsi::SubjectHandle handle) const { return this->Names.Name(handle); }
 
 		//********************************************************************************
 		// Interface: Get data frames
@@ -340,51 +715,376 @@ namespace vdsi
 		//	Get Frame rate of the vicon system [Hz]
 		double GetFrameRate() { return this->ViconFrameRate; }
 
+		// PURPOSE:
+		//	Get counters of the frame decoder, since Connect()
+		//	Use to check that the cached scene layout is rebuilt rarely, and how much time this saves
+		vdsi::DecodeStats GetDecodeStats() const
+		{
+			vdsi::DecodeStats stats;
+			stats.framesDecoded = this->stats_FramesDecoded;
+			stats.schemaRebuilds = this->stats_SchemaRebuilds;
+			if(this->stats_FramesCached > 0)  { stats.meanDecodeNs_cached = this->stats_DecodeNs_cached / double(this->stats_FramesCached); }
+			if(this->stats_FramesRebuilt > 0) { stats.meanDecodeNs_rebuild = this->stats_DecodeNs_rebuild / double(this->stats_FramesRebuilt); }
+			stats.savedNsPerFrame = stats.meanDecodeNs_rebuild - stats.meanDecodeNs_cached;
+			return stats;
+		}
+
+		// PURPOSE:
+		//	Get latency statistics of recent frames
+		//	Cheap enough to leave on. Each frame also carries its own timestamps (Points::timing)
+		vdsi::FrameStats GetStats() const
+		{
+			vdsi::FrameStats stats;
+			stats.latencySDK = this->stats_LatencySDK.Summary();
+			stats.decode = this->stats_Decode.Summary();
+			stats.pickup = this->stats_Pickup.Summary();
+			stats.endToEnd = this->stats_EndToEnd.Summary();
+			stats.interval = this->stats_Interval.Summary();
+			stats.jitter = stats.interval.p99 - stats.interval.p50;
+			return stats;
+		}
+
+		// PURPOSE:
+		//	Get counters of the lossless frame queue, and of frames missed by the update thread
+		//	Check these at the end of a recording to know if it has gaps
+		vdsi::QueueStats GetQueueStats() const
+		{
+			vdsi::QueueStats stats;
+			auto queue = this->FrameQueue.load();
+			stats.framesQueued = this->stats_FramesQueued;
+			stats.overruns = this->stats_QueueOverruns;
+			stats.maxOccupancy = this->stats_QueueMaxOccupancy;
+			stats.capacity = queue ? queue->Capacity() : 0;
+			stats.frameNumberGaps = this->stats_FrameNumberGaps;
+			return stats;
+		}
+
+		// OUTPUT: true once the frame source will never give another frame (e.g. the end of FrameSource_Replay without looping)
+		//	Frames still in the queues can be taken until GetFrames() / GetDeviceFrames() return 0
+		bool IsEndOfStream() const { return this->IsSourceEnded; }
+
+		// PURPOSE:
+		//	Lossless mode (see EnableFrameQueue): take all queued frames at once, oldest first
+		//	Waits until at least one frame is queued (per SetWaitPolicy)
+		// INPUT:
+		//	maxFrames = maximum number of frames to take
+		// OUTPUT:
+		//	frames = the first [return value] elements hold the frames
+		//		The vector is never shrunk, so that its storage is reused when passed in again
+		//	return = number of frames taken. 0 if the queue is not enabled, not connected, the wait timed out, or the source has ended (see IsEndOfStream)
+		size_t GetFrames(std::vector<vdsi::Points>& frames, size_t maxFrames = std::numeric_limits<size_t>::max())
+		{
+			auto queue = this->FrameQueue.load();
+			if( ! queue || ! this->IsConnected ) { return 0; }
+
+			std::lock_guard<std::mutex> lock(this->mtx_QueueReaders);
+
+			// Wait for a frame
+			//	Clear the signal before checking the queue, so that a frame pushed in between is not missed
+			while(queue->IsEmpty())
+			{
+				this->QueueReady.Clear();
+				if( ! queue->IsEmpty() ) { break; }
+				if(this->IsSourceEnded) { return 0; }
+				if( ! this->QueueReady.Wait(this->Wait_Policy, std::chrono::nanoseconds(this->Wait_TimeoutNs)) ) { return 0; }
+			}
+
+			// Take frames
+			size_t numFrames = 0;
+			while(numFrames < maxFrames)
+			{
+				vdsi::Points* frame = queue->Front();
+				if( ! frame ) { break; }
+				if(frames.size() <= numFrames) { frames.emplace_back(); }
+				frames[numFrames] = *frame;
+				queue->Pop();
+				this->RecordPickup(frames[numFrames]);
+				++numFrames;
+			}
+			return numFrames;
+		}
+
+		// PURPOSE:
+		//	Device data (see EnableDeviceData): get the latest device frame. Does not wait
+		// OUTPUT:
+		//	frame = the latest device frame (copy assignment reuses its storage)
+		//	return = true if it is new since the last call
+		bool GetDeviceFrame(vdsi::DeviceFrame& frame)
+		{
+			std::lock_guard<std::mutex> lock(this->mtx_DeviceReaders);
+			bool IsNew = this->LatestDevices.Update();
+			frame = this->LatestDevices.Front();
+			return IsNew;
+		}
+
+		// PURPOSE:
+		//	Device data (see EnableDeviceData): take all queued device frames at once, oldest first
+		//	Waits until at least one frame is queued (per SetWaitPolicy)
+		// OUTPUT: as GetFrames()
+		size_t GetDeviceFrames(std::vector<vdsi::DeviceFrame>& frames, size_t maxFrames = std::numeric_limits<size_t>::max())
+		{
+			auto queue = this->DeviceQueue.load();
+			if( ! queue || ! this->IsConnected ) { return 0; }
+
+			std::lock_guard<std::mutex> lock(this->mtx_DeviceQueueReaders);
+
+			// Wait for a frame (as GetFrames)
+			while(queue->IsEmpty())
+			{
+				this->DeviceReady.Clear();
+				if( ! queue->IsEmpty() ) { break; }
+				if(this->IsSourceEnded) { return 0; }
+				if( ! this->DeviceReady.Wait(this->Wait_Policy, std::chrono::nanoseconds(this->Wait_TimeoutNs)) ) { return 0; }
+			}
+
+			// Take frames
+			size_t numFrames = 0;
+			while(numFrames < maxFrames)
+			{
+				vdsi::DeviceFrame* frame = queue->Front();
+				if( ! frame ) { break; }
+				if(frames.size() <= numFrames) { frames.emplace_back(); }
+				frames[numFrames] = *frame;
+				queue->Pop();
+				++numFrames;
+			}
+			return numFrames;
+		}
+
+		// OUTPUT: Counters of the device frame queue, as GetQueueStats()
+		vdsi::QueueStats GetDeviceQueueStats() const
+		{
+			vdsi::QueueStats stats;
+			auto queue = this->DeviceQueue.load();
+			stats.framesQueued = this->stats_DeviceFramesQueued;
+			stats.overruns = this->stats_DeviceQueueOverruns;
+			stats.maxOccupancy = this->stats_DeviceQueueMaxOccupancy;
+			stats.capacity = queue ? queue->Capacity() : 0;
+			stats.frameNumberGaps = this->stats_FrameNumberGaps;
+			return stats;
+		}
+
+		// PURPOSE:
+		//	Retiming mode (see EnableRetiming): poses at (now + offset + output latency)
+		//	Does not wait: call at the rate of the control loop
+		//	Thread safe. Uses the same filter settings as GetFrame()
+		// INPUT: offset = time offset of the request (e.g. negative for the pose a little in the past)
+		// OUTPUT:
+		//	frame = poses, without markers
+		//		frame.timing.tPose = host time the poses are for
+		//		frame.timing.sampleAge = age of the newest Vicon sample at tPose
+		//	return = false if retiming is not enabled, it has no data yet, or the frame could not be decoded (frame is then empty)
+		bool GetFrame_Retimed(vdsi::Points& frame, std::chrono::nanoseconds offset = std::chrono::nanoseconds::zero())
+		{
+			auto retimer = this->Retiming.load();
+			if( ! retimer ) { return false; }
+
+			vdsi::FrameFilter filter;
+			filter.objects = this->IsObjectFilterActive ? this->filter_AllowedObjects.load() : nullptr;
+			filter.IsOccludedFilterActive = this->IsOccludedFilterActive;
+
+			auto tRequest = vdsi::FrameTiming::Clock::now();
+			if( ! retimer->GetFrame(frame, filter, offset, this->LatestFrameNumber) ) { return false; }
+
+			frame.timing.latencySDK = vdsi::NaN;
+			frame.timing.tReceived = tRequest;
+			frame.timing.tDecoded = vdsi::FrameTiming::Clock::now();
+			frame.timing.tPickup = frame.timing.tDecoded;
+			frame.timing.tPose = tRequest + std::chrono::duration_cast<vdsi::FrameTiming::Clock::duration>(offset + std::chrono::nanoseconds(this->Retiming_OutputLatencyNs));
+
+			int64_t tCapturedNs = this->LatestCapturedNs;
+			frame.timing.sampleAge = (tCapturedNs == 0) ? vdsi::NaN : 1e-9 * double(std::chrono::duration_cast<std::chrono::nanoseconds>(frame.timing.tPose.time_since_epoch()).count() - tCapturedNs);
+			return true;
+		}
+
+		vdsi::Points GetFrame_Retimed(std::chrono::nanoseconds offset = std::chrono::nanoseconds::zero())
+		{
+			vdsi::Points frame;
+			this->GetFrame_Retimed(frame, offset);
+			return frame;
+		}
+
+		// PURPOSE:
+		//	Pose history mode (see EnablePoseHistory): pose of an object at a host time
+		//	Interpolated between the samples either side of t (position linearly, rotation by SLERP)
+		//	or extrapolated past the newest sample, up to PoseHistorySettings::maxExtrapolation
+		//	Does not wait, and does not take the latest frame. Thread safe; cost is O(log capacity)
+		// INPUT:
+		//	handle = object (see GetHandle)
+		//	t = host time of the pose, on the clock of FrameTiming
+		//		e.g. the time a sensor reading was taken, or now + actuation latency
+		// OUTPUT:
+		//	pose = R_rowMajor, P and IsOccluded are overwritten. Occluded if unavailable
+		//	return = how the pose was found. Unavailable if the history is not enabled
+		vdsi::PoseEstimate GetPoseAt(vdsi::SubjectHandle handle, vdsi::FrameTiming::Clock::time_point t, vdsi::Point& pose) const
+		{
+			auto history = this->History.load();
+			if( ! history )
+			{
+				pose.R_rowMajor = vdsi::RotationMatrix_NaN;
+				pose.P = vdsi::Translation_NaN;
+				pose.IsOccluded = true;
+				return vdsi::PoseEstimate::Unavailable;
+			}
+			return history->GetPoseAt(handle, t, pose);
+		}
+
+		// INPUT: Object name
+		// OUTPUT: Pose of the object at time t. Occluded if unavailable
+		vdsi::Point GetPoseAt(const std::string& name, vdsi::FrameTiming::Clock::time_point t)
+		{
+			vdsi::Point pose(name);
+			this->GetPoseAt(this->GetHandle(name), t, pose);
+			return pose;
+		}
+
 		// PURPOSE:
 		//	Same as GetFrame() but blocks until the next frame arrives
+		//	Once the frame source has ended (see IsEndOfStream), returns the last frame at once
 		vdsi::Points GetFrame_WaitForNew()
 		{
-			this->IsFrameReady = false;
+			this->FrameReady.Clear();
 			return this->GetFrame();
 		}
 
+		void GetFrame_WaitForNew(vdsi::Points& frame)
+		{
+			this->FrameReady.Clear();
+			this->GetFrame(frame);
+		}
+
 		// PURPOSE:
 		//	Same as GetFrame() but
 		//		If the latest frame has not yet been read, return the cached frame
 		//		Otherwise, block until the next unread frame arrives
 		vdsi::Points GetFrame_GetUnread()
 		{
-			if(this->HasLatestFrameBeenRead) {this->IsFrameReady = false;}
+			if(this->HasLatestFrameBeenRead) {this->FrameReady.Clear();}
 			return this->GetFrame();
 		}
 
+		void GetFrame_GetUnread(vdsi::Points& frame)
+		{
+			if(this->HasLatestFrameBeenRead) {this->FrameReady.Clear();}
+			this->GetFrame(frame);
+		}
+
+		// PURPOSE:
+		//	Same as GetFrame(), but share the frame rather than copy it
+		//	For many threads reading the same VDS_Interface (e.g. controller, logger, visualiser)
+		//		Readers never wait on each other, and never copy. The update thread makes one copy per frame for all of them
+		//	The frame is read-only, and stays valid for as long as the pointer is held
+		//		Its timing.tPickup is not set, and it is not counted in GetStats().pickup
+		// OUTPUT: The latest frame. nullptr if not connected
+		//	If the wait timed out (see SetWaitPolicy), this is the previous frame again
+		std::shared_ptr<const vdsi::Points> GetFrameShared()
+		{
+			if( ! this->IsConnected )
+			{
+				std::cout << "WARNING_VDS: (GetFrameShared) Not Connected" << std::endl;
+				return nullptr;
+			}
+
+			// First use => the update thread starts publishing snapshots from the next frame
+			this->IsSharedFrameActive = true;
+
+			// End of a recording: no frame will come, so don't wait
+			bool IsReady = ! this->IsSourceEnded && this->SharedReady.Wait(this->Wait_Policy, std::chrono::nanoseconds(this->Wait_TimeoutNs));
+			auto frame = this->LatestShared.load();
+
+			if( ! IsReady && this->IsSourceEnded ) { std::cout << "WARNING_VDS: (GetFrameShared) End of the frame source" << std::endl; }
+			else if( ! IsReady ) { std::cout << "WARNING_VDS: (GetFrameShared) Timed out waiting for a frame" << std::endl; }
+			else if( ! this->HasLatestFrameBeenRead.load(std::memory_order_relaxed) ) { this->HasLatestFrameBeenRead = true; }
+			return frame;
+		}
+
+		// PURPOSE:
+		//	Delta mode (see EnableDeltaMode): the objects of the latest frame that changed since this consumer's last read
+		//	Takes the latest frame as GetFrameShared() does, then copies only the changed objects
+		//	Reading the same frame again gives no objects. Changes in frames that were skipped are not lost
+		//	Throws if delta mode is not enabled, or the occluded filter is (see EnableDeltaMode)
+		// INPUT: cursor = read position of this consumer. Keep one per consumer, and pass it to every call
+		// OUTPUT:
+		//	changed = refilled with the changed objects, with the frame number and timing of the latest frame
+		//	return = false if not connected
+		bool GetFrameDelta(vdsi::DeltaCursor& cursor, vdsi::Points& changed)
+		{
+			if( ! this->Delta_Settings.load() ) { throw std::runtime_error("ERROR_VDS: (GetFrameDelta) Delta mode is not enabled"); }
+			if( this->IsOccludedFilterActive ) { throw std::runtime_error("ERROR_VDS: (GetFrameDelta) Delta mode needs the occluded filter disabled (occluded objects would vanish unreported)"); }
+
+			auto frame = this->GetFrameShared();
+			if( ! frame )
+			{
+				changed = vdsi::Points();
+				return false;
+			}
+			cursor.Extract(*frame, changed);
+			return true;
+		}
+
 		// PURPOSE:
 		//	Get next data frame
 		// OUTPUT: Points object holding the captured data.
 		vdsi::Points GetFrame()
+		{
+			vdsi::Points frame;
+			this->GetFrame(frame);
+			return frame;
+		}
+
+		// PURPOSE:
+		//	Same as GetFrame(), but writes into an existing Points object
+		//	Reusing the same object every loop avoids allocating memory for each frame
+		// OUTPUT: frame = Points object holding the captured data.
+		//	If the wait timed out (see SetWaitPolicy), this is the previous frame again
+		void GetFrame(vdsi::Points& frame)
 		{
 			if( ! this->IsConnected )
 			{
 				std::cout << "WARNING_VDS: (GetFrame) Not Connected" << std::endl;
-				return vdsi::Points();
+				frame = vdsi::Points();
+				return;
 			}
 
-			// Block until thread signals ready
-			//	NOTE:
-			//		The following does not work (On Windows at least, it sleeps way longer than it should)
-			//		std::this_thread::sleep_for(std::chrono::nanoseconds(1));
-			//		==> Instead, use a no-op
-			//		((void)0);
-			while (!this->IsFrameReady) { ((void)0); }
+			if( ! this->TryGetFrame(frame) )
+			{
+				if(this->IsSourceEnded) { std::cout << "WARNING_VDS: (GetFrame) End of the frame source, no new frame" << std::endl; }
+				else                    { std::cout << "WARNING_VDS: (GetFrame) Timed out waiting for a frame" << std::endl; }
+			}
+		}
 
-			// This statement is written very specifically to invoke the copy constructor of vdsi::Points
-			// See syntax differences to call copy constructor VS operator=
-			this->mtx_LatestFrame.lock();
-			auto LatestFrame_copy(this->LatestFrame);
-			this->mtx_LatestFrame.unlock();
+		// PURPOSE:
+		//	Same as GetFrame(frame), but reports failure instead of printing a warning
+		// OUTPUT:
+		//	frame = Points object holding the captured data
+		//	return = false if not connected, the wait timed out, or the frame source has ended (see IsEndOfStream) and no new frame was taken
+		bool TryGetFrame(vdsi::Points& frame)
+		{
+			if( ! this->IsConnected )
+			{
+				frame = vdsi::Points();
+				return false;
+			}
 
-			this->HasLatestFrameBeenRead = true;
-			return LatestFrame_copy;
+			// Block until thread signals ready
+			//	End of a recording: no frame will come, so don't wait (readers already waiting are woken by the update thread)
+			bool IsReady = ! this->IsSourceEnded && this->FrameReady.Wait(this->Wait_Policy, std::chrono::nanoseconds(this->Wait_TimeoutNs));
+
+			// Take the latest published frame
+			// Copy assignment reuses the storage already held by frame
+			//	Only the reader that takes a newly published frame records its pickup
+			//	A frame read again (timed out, or polled by GetFrame between frames) would add its growing age to the latency statistics
+			this->mtx_Readers.lock();
+			bool IsNew = this->LatestFrame.Update();
+			frame = this->LatestFrame.Front();
+			this->mtx_Readers.unlock();
+
+			if(IsNew)
+			{
+				this->HasLatestFrameBeenRead = true;
+				this->RecordPickup(frame);
+			}
+			return this->IsSourceEnded ? IsNew : IsReady;
 		}
 
 	private:
@@ -397,159 +1097,266 @@ namespace vdsi
 			while( ! this->IsKillRequest )
 			{
 				// Wait for next frame
-				auto UpdateResult = Client.GetFrame();
+				//	End of a recording: wake the readers of the frame and the queues, so that they see it (see IsEndOfStream)
+				if( ! this->Source->WaitForFrame() )
+				{
+					if( ! this->IsSourceEnded && this->Source->IsEndOfStream() )
+					{
+						this->IsSourceEnded = true;
+						if(this->DirectPoses_Target) { this->DirectPoses_Target->EndOfPoses(); }
+						this->FrameReady.Set();
+						this->SharedReady.Set();
+						this->QueueReady.Set();
+						this->DeviceReady.Set();
+					}
+					continue;
+				}
+				auto tReceived = vdsi::FrameTiming::Clock::now();
 
 				// Retrieve system data
-				this->ViconFrameRate = Client.GetFrameRate().FrameRateHz;
+				this->ViconFrameRate = this->Source->FrameRateHz();
+				double latencySDK = this->Source->LatencySeconds();
+
+				// Take the current filter settings for this frame
+				this->filter_ThisFrame.objects = this->IsObjectFilterActive ? this->filter_AllowedObjects.load() : nullptr;
+				this->filter_ThisFrame.IsOccludedFilterActive = this->IsOccludedFilterActive;
+				this->filter_ThisFrame.projection = this->filter_Projection.load();
+				this->filter_ThisFrame.markerDemand = (this->filter_ThisFrame.projection && this->filter_ThisFrame.projection->IsLazyMarkers) ? this->MarkerRequests.Snapshot() : nullptr;
+				this->filter_ThisFrame.nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(tReceived.time_since_epoch()).count();
+
+				// Direct pose mode: only the poses of the listed objects, no frame of Points
+				if(this->DirectPoses_Target)
+				{
+					this->DecodePoses(*this->DirectPoses_Target, latencySDK, tReceived);
+					continue;
+				}
+
+				// Decode frame data into the back buffer (or the first queue of the pipeline)
+				//	Object filter: decode into DecodedFrame, then sort into the back buffer in the order of the filter
+				//	Pipeline full: decode into DecodedFrame anyway, to count the frame as a gap (the devices are still published)
+				//	The frames are members so that their storage is reused every loop
+				vdsi::Points* frame = this->Pipeline ? this->Pipeline->BeginPush() : &this->LatestFrame.Back();
+				vdsi::Points& decoded = (frame && ! this->filter_ThisFrame.objects) ? *frame : this->DecodedFrame;
+				this->DecodeFrame(decoded);
+				this->DecodeDevices(decoded.frameNumber, tReceived);
+				if( ! frame ) { this->CountFrameNumberGaps(decoded.frameNumber); continue; } // Pipeline full (counted)
+				if(&decoded != frame) { this->filter_ThisFrame.SortByObjectFilter(decoded, *frame); }
+
+				// Pipeline mode: the stages and the last thread of the pipeline take it from here
+				if(this->Pipeline)
+				{
+					this->CountFrameNumberGaps(frame->frameNumber);
+					this->RecordTiming(frame->timing, frame->frameNumber, latencySDK, tReceived);
+					this->Pipeline->CommitPush();
+					continue;
+				}
+
+				this->StampFrame(*frame);
+				this->CountFrameNumberGaps(frame->frameNumber);
+				this->RecordTiming(frame->timing, frame->frameNumber, latencySDK, tReceived);
+				this->PublishFrame();
+			}
+		}
+
+		// PURPOSE: Pipeline mode: publish a frame that made it through the stages (on the last thread of the pipeline)
+		void PublishPipelineFrame(vdsi::Points& frame)
+		{
+			// Swap rather than copy: the queue slot is refilled on its next use
+			std::swap(frame, this->LatestFrame.Back());
+			this->StampFrame(this->LatestFrame.Back());
+			this->PublishFrame();
+		}
+
+		// PURPOSE: Modes that add to the frame itself, before it is published
+		void StampFrame(vdsi::Points& frame)
+		{
+			// Delta mode
+			auto deltaSettings = this->Delta_Settings.load();
+			if(deltaSettings) { this->Changes.Stamp(frame, *deltaSettings); }
+
+			// Pose kernels
+			if(this->IsPoseKernelsActive) { frame.ComputePoses(); }
+		}
+
+		// PURPOSE: Hand the back buffer to every consumer, then make it the latest frame
+		void PublishFrame()
+		{
+			// Pose history mode
+			auto history = this->History.load();
+			if(history) { history->Add(this->LatestFrame.Back()); }
+
+			// Lossless mode
+			this->QueueFrame(this->LatestFrame.Back());
 
-				// Create object holding frame data
-				vdsi::Points LatestFrame_internal = this->DecodeFrame();
+			// Other processes
+			auto sharedMemory = this->SharedMemory.load();
+			if(sharedMemory) { sharedMemory->Publish(this->LatestFrame.Back()); }
+			auto relay = this->Relay.load();
+			if(relay) { relay->Send(this->LatestFrame.Back()); }
 
-				// Replace public reference to the previous frame with the new frame
-				this->mtx_LatestFrame.lock();
-				this->LatestFrame = LatestFrame_internal;
-				this->mtx_LatestFrame.unlock();
+			// Subscriptions
+			this->Dispatcher.Publish(this->LatestFrame.Back());
 
-				// (Only first loop) Unblock GetFrame()
-				this->HasLatestFrameBeenRead = false;
-				this->IsFrameReady = true;
+			// Shared readers
+			if(this->IsSharedFrameActive)
+			{
+				this->LatestShared = this->SharedSnapshots.Take(this->LatestFrame.Back());
+				this->SharedReady.Set();
 			}
+
+			// Replace public reference to the previous frame with the new frame
+			this->LatestFrame.Publish();
+
+			// (Only first loop) Unblock GetFrame()
+			this->HasLatestFrameBeenRead = false;
+			this->FrameReady.Set();
 		}
 
 		// PURPOSE:
-		//	Get next data frame from VDS (frame as in snapshot of system state at current time)
-		//	Decode the data frame
+		//	Decode the data frame from the source (frame as in snapshot of system state at current time)
 		//	Apply filtering
-		vdsi::Points DecodeFrame()
+		// OUTPUT: Points = refilled with the decoded frame
+		void DecodeFrame(vdsi::Points& Points)
 		{
-			// Object to return
-			vdsi::Points Points;
-			Points.frameNumber = Client.GetFrameNumber().FrameNumber;
+			auto t0 = std::chrono::steady_clock::now();
+			uint64_t schemaRebuilds0 = this->Source->SchemaRebuilds();
 
-			// Loop over all subjects
-			unsigned int numS = this->Client.GetSubjectCount().SubjectCount;
-			for (unsigned int idxSubject = 0; idxSubject < numS; ++idxSubject)
-			{
-				std::string SubjectName = this->Client.GetSubjectName(idxSubject).SubjectName;
+			this->Source->DecodeFrame(Points, this->filter_ThisFrame);
+			this->RecordDecode(t0, schemaRebuilds0);
+		}
 
-				// Number of segments should always be 1 when using Vicon Tracker3... as far as I can tell
-				unsigned int SegmentCount = this->Client.GetSegmentCount(SubjectName).SegmentCount;
-				if (SegmentCount!=1)
-				{
-					// If this happens, then you get to rewrite this interface to also loop over and store Segment data
-					// Refer to the example that comes with the Vicon DataStream SDK "ViconDataStreamSDK_CPPRetimerTest.cpp"
-					throw std::runtime_error("ERROR_VDS: Invalid assumption that segment count is 1");
-				}
+		// PURPOSE: Direct pose mode: decode the poses of the listed objects, and hand them to the target
+		void DecodePoses(vdsi::DirectPoseTarget& target, double latencySDK, vdsi::FrameTiming::Clock::time_point tReceived)
+		{
+			auto t0 = std::chrono::steady_clock::now();
+			uint64_t schemaRebuilds0 = this->Source->SchemaRebuilds();
 
-				// Segment name
-				unsigned int idxSegment = 0;
-				std::string SegmentName = this->Client.GetSegmentName(SubjectName, idxSegment).SegmentName;
-
-				// Global translation
-				vds::Output_GetSegmentGlobalTranslation ret_P = this->Client.GetSegmentGlobalTranslation(SubjectName, SegmentName);
-				std::vector<double> P(std::begin(ret_P.Translation), std::end(ret_P.Translation));
-
-				// Global rotation matrix
-				//	Note: Vicon uses row major order
-				vds::Output_GetSegmentGlobalRotationMatrix ret_R = this->Client.GetSegmentGlobalRotationMatrix(SubjectName, SegmentName);
-				std::vector<double> R(std::begin(ret_R.Rotation), std::end(ret_R.Rotation));
-
-				// The occluded return value is broken - Always gives 0 (meaning not occluded)
-				// I'd like to do this:
-				//		bool IsOccluded = ret_R.Occluded || ret_P.Occluded;
-				// But oh well. Let's do it manually
-				// If it's occluded, all values return exactly 0 (at least that works)
-				// It's pretty unlikely that a real value will be exactly 0 in double precision
-				// Hence:
-				bool IsOccluded = (
-						   ret_R.Rotation[0] == 0
-						&& ret_R.Rotation[1] == 0
-						&& ret_R.Rotation[2] == 0
-						&& ret_R.Rotation[3] == 0
-						&& ret_R.Rotation[4] == 0
-						&& ret_R.Rotation[5] == 0
-						&& ret_R.Rotation[6] == 0
-						&& ret_R.Rotation[7] == 0
-						&& ret_R.Rotation[8] == 0
-					) || (
-						   ret_P.Translation[0] == 0
-						&& ret_P.Translation[1] == 0
-						&& ret_P.Translation[2] == 0
-					);
-
-				// Save point to the return object if allowed by filters
-				vdsi::Point_Object point(SubjectName, R, P, IsOccluded);
-				if ( ! this->AllowedByFilters(point) ) { continue; }
-
-				// Markers
-				unsigned int numM = this->Client.GetMarkerCount(SubjectName).MarkerCount;
-				for (unsigned int idxMarker = 0; idxMarker < numM; ++idxMarker)
-				{
-					// Maker name and global translation
-					std::string MarkerName = this->Client.GetMarkerName(SubjectName, idxMarker).MarkerName;
-					vds::Output_GetMarkerGlobalTranslation retM_P = this->Client.GetMarkerGlobalTranslation(SubjectName, MarkerName);
-					std::vector<double> MarkerP(std::begin(retM_P.Translation), std::end(retM_P.Translation));
-					bool marker_IsOccluded = retM_P.Occluded;
-
-					// Save marker to object
-					//	Marker arrays should stay same size for a given object, otherwise access would be painful
-					//	Let's trust that VDS always specifies them in the same order...
-					vdsi::Point_Marker marker(MarkerName, P, marker_IsOccluded);
-					if (!marker_IsOccluded)
-					{
-						point.AddMarker(marker);
-					}
-					else
-					{
-						// Create occluded
-						point.AddMarker(vdsi::Point_Marker(MarkerName));
-					}
-				}
+			unsigned int frameNumber = this->Source->DecodePoses(this->DirectPoses_Handles, target.BeginPoses(), this->filter_ThisFrame);
+			this->RecordDecode(t0, schemaRebuilds0);
+			this->DecodeDevices(frameNumber, tReceived);
 
-				Points.AddPoint(point);
+			vdsi::FrameTiming timing;
+			this->CountFrameNumberGaps(frameNumber);
+			this->RecordTiming(timing, frameNumber, latencySDK, tReceived);
+			target.CommitPoses(frameNumber, timing);
+		}
 
-			}
-			
-			// Apply AllowedObjects filter if enabled
-			return this->SortByObjectFilter(Points);
+		// PURPOSE: Decode statistics of one frame
+		// INPUT: t0, schemaRebuilds0 = time and SchemaRebuilds() of the source before the decode
+		void RecordDecode(std::chrono::steady_clock::time_point t0, uint64_t schemaRebuilds0)
+		{
+			double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+			this->stats_FramesDecoded++;
+			this->stats_SchemaRebuilds = this->Source->SchemaRebuilds();
+			if(this->stats_SchemaRebuilds == schemaRebuilds0) { this->stats_FramesCached++;  this->stats_DecodeNs_cached = this->stats_DecodeNs_cached + ns; }
+			else                                              { this->stats_FramesRebuilt++; this->stats_DecodeNs_rebuild = this->stats_DecodeNs_rebuild + ns; }
 		}
 
 		//********************************************************************************
 		// Helper functions
 		//****************************************
-		// PURPOSE: Test if the point is allowed by the currently active filters
-		bool AllowedByFilters(const vdsi::Point_Object& point)
+		// PURPOSE: Settings changed => the next GetFrame() and GetFrameShared() wait for a frame made with the new settings
+		void InvalidateLatestFrame()
 		{
-			// Occluded filter
-			if(this->IsOccludedFilterActive && point.IsOccluded) {return false;}
+			this->FrameReady.Clear();
+			this->SharedReady.Clear();
+		}
 
-			// Object filter
-			if( ! this->IsObjectFilterActive ) {return true;}
-			// Seach allowed objects list
-			for(auto&& allowedObject_name : this->filter_AllowedObjects)
+		// PURPOSE:
+		//	Device data: decode the devices and unlabeled markers of the current frame, if enabled
+		//	Publish them as the latest, and queue a copy (dropped and counted if the queue is full)
+		void DecodeDevices(unsigned int frameNumber, vdsi::FrameTiming::Clock::time_point tReceived)
+		{
+			auto settings = this->Device_Settings.load();
+			if( ! settings ) { return; }
+
+			vdsi::DeviceFrame& frame = this->LatestDevices.Back();
+			this->Source->DecodeDevices(frame, *settings);
+			frame.frameNumber = frameNumber;
+			frame.tReceived = tReceived;
+
+			auto queue = this->DeviceQueue.load();
+			if(queue)
 			{
-				if(point.viconObjectName == allowedObject_name) {return true;}
+				vdsi::DeviceFrame* slot = queue->BeginPush();
+				if( ! slot ) { this->stats_DeviceQueueOverruns++; }
+				else
+				{
+					*slot = frame;
+					queue->CommitPush();
+					this->DeviceReady.Set();
+					this->stats_DeviceFramesQueued++;
+					uint64_t occupancy = queue->Size();
+					if(occupancy > this->stats_DeviceQueueMaxOccupancy) { this->stats_DeviceQueueMaxOccupancy = occupancy; }
+				}
 			}
-			// Not on allow list
-			return false;
+			this->LatestDevices.Publish();
 		}
 
-		// PURPOSE: Sort Points by the ordering specified in the AllowedObjects filter
-		// If the filter is not active, return the input
-		vdsi::Points SortByObjectFilter(vdsi::Points& Points) {
-			if( ! this->IsObjectFilterActive ) {return Points; }
+		// PURPOSE: Lossless mode: put a copy of the frame in the queue, if enabled
+		void QueueFrame(const vdsi::Points& frame)
+		{
+			auto queue = this->FrameQueue.load();
+			if( ! queue ) { return; }
+
+			// Full => drop this frame rather than wait for the consumer
+			vdsi::Points* slot = queue->BeginPush();
+			if( ! slot )
+			{
+				this->stats_QueueOverruns++;
+				return;
+			}
+
+			// Copy assignment reuses the storage of the slot
+			*slot = frame;
+			queue->CommitPush();
+			this->QueueReady.Set();
+
+			// Statistics
+			this->stats_FramesQueued++;
+			uint64_t occupancy = queue->Size();
+			if(occupancy > this->stats_QueueMaxOccupancy) { this->stats_QueueMaxOccupancy = occupancy; }
+		}
 
-			vdsi::Points Points_sorted;
-			Points_sorted.frameNumber = Points.frameNumber;
-			for(auto&& allowedObject_name : this->filter_AllowedObjects)
+		// PURPOSE: Stamp the frame timing and update the statistics of the update thread
+		void RecordTiming(vdsi::FrameTiming& timing, unsigned int frameNumber, double latencySDK, vdsi::FrameTiming::Clock::time_point tReceived)
+		{
+			timing.latencySDK = latencySDK;
+			timing.tReceived = tReceived;
+			timing.tDecoded = vdsi::FrameTiming::Clock::now();
+			timing.tPickup = vdsi::FrameTiming::Clock::time_point();
+
+			// Newest frame, for GetFrame_Retimed
+			this->LatestCapturedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(timing.tCaptured().time_since_epoch()).count();
+			this->LatestFrameNumber = frameNumber;
+
+			this->stats_LatencySDK.Add(latencySDK * 1e9);
+			this->stats_Decode.Add(std::chrono::duration<double, std::nano>(timing.tDecoded - tReceived).count());
+			if(this->LastReceived != vdsi::FrameTiming::Clock::time_point())
 			{
-				vdsi::Point_Object point = Points.Get(allowedObject_name);
+				this->stats_Interval.Add(std::chrono::duration<double, std::nano>(tReceived - this->LastReceived).count());
+			}
+			this->LastReceived = tReceived;
+		}
+
+		// PURPOSE: Stamp the time the user took the frame and update the statistics
+		void RecordPickup(vdsi::Points& frame)
+		{
+			if(frame.timing.tReceived == vdsi::FrameTiming::Clock::time_point()) { return; } // Empty frame
+
+			frame.timing.tPickup = vdsi::FrameTiming::Clock::now();
+			this->stats_Pickup.Add(std::chrono::duration<double, std::nano>(frame.timing.tPickup - frame.timing.tDecoded).count());
+			this->stats_EndToEnd.Add(frame.timing.latencySDK * 1e9 + std::chrono::duration<double, std::nano>(frame.timing.tPickup - frame.timing.tReceived).count());
+		}
 
-				// Save point to the return object if allowed by filters
-				//	i.e. apply occluded filter
-				if(this->AllowedByFilters(point)) { Points_sorted.AddPoint(point); }
+		// PURPOSE: Count frames that the update thread never received
+		void CountFrameNumberGaps(unsigned int frameNumber)
+		{
+			if(this->LastFrameNumber != 0 && frameNumber > this->LastFrameNumber + 1)
+			{
+				this->stats_FrameNumberGaps += frameNumber - this->LastFrameNumber - 1;
 			}
-			return Points_sorted;
+			this->LastFrameNumber = frameNumber;
 		}
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,120 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Stable integer handles for the names of vicon objects
+		Resolve a name once, then look up points by handle in constant time
+
+Class Summary:
+	SubjectHandle
+		Handle of a vicon object (VDS calls this the "Subject")
+		The same name always gives the same handle, for the lifetime of the VDS_Interface
+
+	MarkerHandle
+		Index of a marker within its object
+		Stable as long as Vicon Tracker lists the markers of the object in the same order
+
+	NameRegistry
+		Interns names into SubjectHandles. Thread safe
+
+*/
+#pragma once
+
+// Standard library
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+
+
+namespace vdsi
+{
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Handles
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	struct SubjectHandle
+	{
+		static constexpr uint32_t InvalidId = std::numeric_limits<uint32_t>::max();
+		uint32_t id = InvalidId;
+
+		bool IsValid() const { return this->id != InvalidId; }
+		bool operator==(const SubjectHandle& other) const { return this->id == other.id; }
+		bool operator!=(const SubjectHandle& other) const { return this->id != other.id; }
+	};
+
+	struct MarkerHandle
+	{
+		static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+		uint32_t index = InvalidIndex;
+
+		bool IsValid() const { return this->index != InvalidIndex; }
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Name interning
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Names are never removed, so handles stay valid even if the object leaves the scene
+	class NameRegistry
+	{
+	private:
+		std::vector<std::string> names;
+		std::unordered_map<std::string, uint32_t> idByName;
+		mutable std::shared_mutex mtx_Names;
+
+	public:
+		//********************************************************************************
+		// Interface: Get
+		//****************************************
+		// INPUT: Object name
+		// OUTPUT: Handle of the name. Registers the name if not seen before
+		vdsi::SubjectHandle Intern(const std::string& name)
+		{
+			// Common case: already registered
+			{
+				std::shared_lock<std::shared_mutex> lock(this->mtx_Names);
+				auto found = this->idByName.find(name);
+				if(found != this->idByName.end()) { return vdsi::SubjectHandle{found->second}; }
+			}
+
+			// Register new name (check again, as another thread may have got here first)
+			std::unique_lock<std::shared_mutex> lock(this->mtx_Names);
+			auto inserted = this->idByName.emplace(name, uint32_t(this->names.size()));
+			if(inserted.second) { this->names.push_back(name); }
+			return vdsi::SubjectHandle{inserted.first->second};
+		}
+
+		// INPUT: Object name
+		// OUTPUT: Handle of the name, or an invalid handle if not registered
+		vdsi::SubjectHandle Find(const std::string& name) const
+		{
+			std::shared_lock<std::shared_mutex> lock(this->mtx_Names);
+			auto found = this->idByName.find(name);
+			if(found == this->idByName.end()) { return vdsi::SubjectHandle(); }
+			return vdsi::SubjectHandle{found->second};
+		}
+
+		// INPUT: Handle
+		// OUTPUT: Copy of the name of the handle (empty if invalid)
+		std::string Name(vdsi::SubjectHandle handle) const
+		{
+			std::shared_lock<std::shared_mutex> lock(this->mtx_Names);
+			if(handle.id >= this->names.size()) { return std::string(); }
+			return this->names[handle.id];
+		}
+
+		// OUTPUT: Number of registered names (= 1 + largest handle id)
+		size_t Size() const
+		{
+			std::shared_lock<std::shared_mutex> lock(this->mtx_Names);
+			return this->names.size();
+		}
+	};
+}
@@ -0,0 +1,433 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Pipeline mode of VDS_Interface (see VDS_Interface::EnablePipeline)
+	User processing of each frame (e.g. smoothing, transforms, rules) in stages after the update thread
+		update thread (wait for frame, decode, filter) => stage 1 => ... => stage N => publish (GetFrame, subscriptions, ...)
+		Each stage has its own thread, so the update thread is ready for the next frame as soon as it has decoded one
+		Stages are connected by bounded lock-free queues (SpscRing). A frame arriving at a full queue is dropped and counted
+		Per subject work of a stage can be split over a pool of worker threads, for large scenes
+
+Class Summary:
+	PipelineStage
+		Name and work of one stage
+
+	PipelineSettings
+		Queue capacity, worker threads, and how the stage threads wait
+
+	PipelineStageStats
+		Frames processed and dropped, and time spent, of one stage
+
+	WorkerPool
+		Threads that run ParallelFor() jobs. Shared by all stages; several stages can use it at once
+
+	FramePipeline
+		The stage threads and their queues. Used by VDS_Interface
+
+*/
+#pragma once
+
+// Brandon's VDS Interface helpers
+#include "VDS_Points.h"
+#include "VDS_FrameQueue.h"
+#include "VDS_FrameHandoff.h"
+#include "VDS_Stats.h"
+
+// Standard library
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace vdsi
+{
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Settings and statistics
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	struct PipelineStage
+	{
+		// Name, for GetPipelineStats
+		std::string name;
+
+		// Work of the stage. Either or both (perFrame first)
+		//	perFrame = called with the whole frame, on the stage thread
+		//	perSubject = called with each object of the frame, on the stage thread and the worker pool at once
+		//		Objects are split into tasks of PipelineSettings::subjectsPerTask. Calls for different objects may run in parallel
+		//		e.g. state per object: index it by point.handle.id, so that each call touches its own state
+		// Exceptions are caught and counted (PipelineStageStats::exceptions). The frame continues to the next stage
+		std::function<void(vdsi::Points&)> perFrame;
+		std::function<void(vdsi::Point_Object&)> perSubject;
+	};
+
+	struct PipelineSettings
+	{
+		// Frames held in the queue before each stage
+		//	Larger absorbs longer stalls of a stage, at the cost of latency when it falls behind
+		size_t queueCapacity = 4;
+
+		// Threads of the worker pool (shared by all stages), in addition to the stage threads
+		//	0 = perSubject runs on the stage thread only
+		// Objects per task of the worker pool. Smaller spreads the work more evenly, at more overhead per task
+		size_t numWorkers = 0;
+		size_t subjectsPerTask = 32;
+
+		// How the stage threads wait for a frame
+		//	Block uses no CPU while waiting. Spin gives the lowest latency, but uses a full CPU core per stage
+		vdsi::WaitPolicy waitPolicy = vdsi::WaitPolicy::Block;
+	};
+
+	struct PipelineStageStats
+	{
+		std::string name;
+
+		// Frames the stage processed
+		// Frames dropped because the queue before the stage was full
+		// Exceptions thrown by perFrame or perSubject (caught)
+		uint64_t framesProcessed = 0;
+		uint64_t framesDropped = 0;
+		uint64_t exceptions = 0;
+
+		// Time [ns] in the queue before the stage, and in the stage
+		vdsi::HistogramSummary wait;
+		vdsi::HistogramSummary process;
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Pool of threads for data parallel work
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	class WorkerPool
+	{
+	private:
+		// One ParallelFor() call
+		//	Tasks are claimed by counter, so the pool does not allocate per call
+		struct Job
+		{
+			const std::function<void(size_t, size_t)>* work = nullptr;
+			size_t size = 0;
+			size_t taskSize = 1;
+			size_t numTasks = 0;
+			std::atomic<size_t> nextTask = 0;
+
+			// Under mtx_Jobs
+			size_t tasksDone = 0;
+			int numWorkersActive = 0;
+			std::exception_ptr exception;
+		};
+
+		std::vector<std::thread> threads;
+		std::mutex mtx_Jobs;
+		std::condition_variable cv_Jobs;
+		std::condition_variable cv_Done;
+		std::vector<Job*> jobs;
+		bool IsKillRequest = false;
+
+	public:
+		//********************************************************************************
+		// Interface: Create
+		//****************************************
+		// INPUT: numThreads = threads of the pool. 0 = ParallelFor() runs on the calling thread only
+		explicit WorkerPool(size_t numThreads)
+		{
+			for(size_t idx = 0; idx < numThreads; ++idx) { this->threads.emplace_back([this] { this->WorkInBackground(); }); }
+		}
+
+		~WorkerPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(this->mtx_Jobs);
+				this->IsKillRequest = true;
+			}
+			this->cv_Jobs.notify_all();
+			for(auto& thread : this->threads) { thread.join(); }
+		}
+
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+		size_t NumThreads() const { return this->threads.size(); }
+
+		//********************************************************************************
+		// Interface: Run
+		//****************************************
+		// PURPOSE: Call work(begin, end) over [0, size) in tasks of taskSize, on the calling thread and the pool
+		//	Returns when all tasks are done. The first exception thrown by work is rethrown here
+		void ParallelFor(size_t size, size_t taskSize, const std::function<void(size_t begin, size_t end)>& work)
+		{
+			if(size == 0) { return; }
+			taskSize = std::max<size_t>(taskSize, 1);
+			if(this->threads.empty() || size <= taskSize) { work(0, size); return; }
+
+			Job job;
+			job.work = &work;
+			job.size = size;
+			job.taskSize = taskSize;
+			job.numTasks = (size + taskSize - 1) / taskSize;
+			{
+				std::lock_guard<std::mutex> lock(this->mtx_Jobs);
+				this->jobs.push_back(&job);
+			}
+			this->cv_Jobs.notify_all();
+
+			// Help with own job, then wait for the workers to finish theirs
+			this->RunTasks(job);
+			std::unique_lock<std::mutex> lock(this->mtx_Jobs);
+			this->cv_Done.wait(lock, [&job] { return job.tasksDone == job.numTasks && job.numWorkersActive == 0; });
+			this->jobs.erase(std::find(this->jobs.begin(), this->jobs.end(), &job));
+			if(job.exception) { std::rethrow_exception(job.exception); }
+		}
+
+	private:
+		void WorkInBackground()
+		{
+			std::unique_lock<std::mutex> lock(this->mtx_Jobs);
+			while(true)
+			{
+				Job* job = nullptr;
+				this->cv_Jobs.wait(lock, [this, &job] {
+					if(this->IsKillRequest) { return true; }
+					for(Job* candidate : this->jobs)
+					{
+						if(candidate->nextTask.load(std::memory_order_relaxed) < candidate->numTasks) { job = candidate; return true; }
+					}
+					return false;
+				});
+				if(this->IsKillRequest) { return; }
+
+				// Active count keeps the job alive until this thread lets go of it
+				++job->numWorkersActive;
+				lock.unlock();
+				this->RunTasks(*job);
+				lock.lock();
+				--job->numWorkersActive;
+				if(job->tasksDone == job->numTasks && job->numWorkersActive == 0) { this->cv_Done.notify_all(); }
+			}
+		}
+
+		void RunTasks(Job& job)
+		{
+			size_t numDone = 0;
+			std::exception_ptr exception;
+			size_t task;
+			while((task = job.nextTask.fetch_add(1, std::memory_order_relaxed)) < job.numTasks)
+			{
+				size_t begin = task * job.taskSize;
+				try { (*job.work)(begin, std::min(begin + job.taskSize, job.size)); }
+				catch(...) { if( ! exception ) { exception = std::current_exception(); } }
+				++numDone;
+			}
+
+			std::lock_guard<std::mutex> lock(this->mtx_Jobs);
+			job.tasksDone += numDone;
+			if(exception && ! job.exception) { job.exception = exception; }
+			if(job.tasksDone == job.numTasks && job.numWorkersActive == 0) { this->cv_Done.notify_all(); }
+		}
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Stage threads and queues
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// One producer (the update thread) pushes decoded frames with BeginPush()/CommitPush()
+	// The last thread hands each frame to publish(), which may swap its storage out (the slot is refilled on its next use)
+	class FramePipeline
+	{
+	private:
+		using Clock = vdsi::FrameTiming::Clock;
+
+		// Frame in a queue
+		struct Slot
+		{
+			vdsi::Points frame;
+			Clock::time_point tQueued;
+		};
+
+		// Queue before a stage, and the stage's thread
+		//	The last one (publish) has no user work
+		struct Stage
+		{
+			vdsi::PipelineStage stage;
+			vdsi::SpscRing<Slot> queue;
+			vdsi::FrameSignal FrameReady;
+			std::unique_ptr<std::thread> thread;
+
+			std::atomic<uint64_t> stats_FramesProcessed = 0;
+			std::atomic<uint64_t> stats_FramesDropped = 0;
+			std::atomic<uint64_t> stats_Exceptions = 0;
+			vdsi::RollingHistogram stats_Wait;
+			vdsi::RollingHistogram stats_Process;
+
+			Stage(vdsi::PipelineStage stage_in, size_t capacity) : stage(std::move(stage_in)), queue(capacity) { }
+		};
+
+		vdsi::PipelineSettings settings;
+		std::vector<std::unique_ptr<Stage>> stages;
+		std::function<void(vdsi::Points&)> publish;
+		vdsi::WorkerPool Workers;
+		std::atomic<bool> IsKillRequest = false;
+
+		// Time between checks of IsKillRequest while waiting for a frame
+		static constexpr std::chrono::milliseconds WaitTimeout{100};
+
+	public:
+		//********************************************************************************
+		// Interface: Create
+		//****************************************
+		// INPUT:
+		//	stages_in = user stages, in order
+		//	settings_in = (see PipelineSettings)
+		//	publish_in = called by the last thread with each frame that made it through the stages
+		FramePipeline(std::vector<vdsi::PipelineStage> stages_in, const vdsi::PipelineSettings& settings_in, std::function<void(vdsi::Points&)> publish_in) :
+			settings(settings_in),
+			publish(std::move(publish_in)),
+			Workers(settings_in.numWorkers)
+		{
+			if(settings_in.queueCapacity == 0) { throw std::runtime_error("ERROR_VDS: (FramePipeline) queueCapacity must be > 0"); }
+
+			for(auto& stage : stages_in) { this->stages.push_back(std::make_unique<Stage>(std::move(stage), settings_in.queueCapacity)); }
+			vdsi::PipelineStage publishStage;
+			publishStage.name = "publish";
+			this->stages.push_back(std::make_unique<Stage>(std::move(publishStage), settings_in.queueCapacity));
+
+			for(size_t idx = 0; idx < this->stages.size(); ++idx)
+			{
+				this->stages[idx]->thread = std::make_unique<std::thread>([this, idx] { this->StageInBackground(idx); });
+			}
+		}
+
+		~FramePipeline()
+		{
+			this->IsKillRequest = true;
+			for(auto& stage : this->stages)
+			{
+				stage->FrameReady.Set();
+				stage->thread->join();
+			}
+		}
+
+		FramePipeline(const FramePipeline&) = delete;
+		FramePipeline& operator=(const FramePipeline&) = delete;
+
+		//********************************************************************************
+		// Interface: Producer (update thread)
+		//****************************************
+		// OUTPUT: Frame to refill with the next decoded frame, or nullptr if the first queue is full (the frame is dropped and counted)
+		vdsi::Points* BeginPush()
+		{
+			Slot* slot = this->stages.front()->queue.BeginPush();
+			if( ! slot ) { this->stages.front()->stats_FramesDropped++; return nullptr; }
+			return &slot->frame;
+		}
+
+		// PURPOSE: Pass the frame from BeginPush() to the first stage
+		void CommitPush()
+		{
+			this->Forward(*this->stages.front(), *this->stages.front()->queue.BeginPush());
+		}
+
+		//********************************************************************************
+		// Interface: Statistics
+		//****************************************
+		// OUTPUT: One entry per user stage, then one for publish
+		std::vector<vdsi::PipelineStageStats> Stats() const
+		{
+			std::vector<vdsi::PipelineStageStats> allStats;
+			for(auto& stage : this->stages)
+			{
+				vdsi::PipelineStageStats stats;
+				stats.name = stage->stage.name;
+				stats.framesProcessed = stage->stats_FramesProcessed;
+				stats.framesDropped = stage->stats_FramesDropped;
+				stats.exceptions = stage->stats_Exceptions;
+				stats.wait = stage->stats_Wait.Summary();
+				stats.process = stage->stats_Process.Summary();
+				allStats.push_back(stats);
+			}
+			return allStats;
+		}
+
+	private:
+		//************************************************************
+		// Stage threads
+		//******************************
+		void StageInBackground(size_t idx)
+		{
+			Stage& stage = *this->stages[idx];
+			Stage* next = (idx + 1 < this->stages.size()) ? this->stages[idx + 1].get() : nullptr;
+
+			while( ! this->IsKillRequest )
+			{
+				// Wait for a frame
+				//	Clear the signal before checking the queue, so that a frame pushed in between is not missed
+				Slot* in = stage.queue.Front();
+				if( ! in )
+				{
+					stage.FrameReady.Clear();
+					in = stage.queue.Front();
+					if( ! in ) { stage.FrameReady.Wait(this->settings.waitPolicy, WaitTimeout); continue; }
+				}
+				auto tStart = Clock::now();
+				stage.stats_Wait.Add(std::chrono::duration<double, std::nano>(tStart - in->tQueued).count());
+
+				if(next) { this->RunStage(stage, in->frame); }
+				else { this->publish(in->frame); }
+				stage.stats_Process.Add(std::chrono::duration<double, std::nano>(Clock::now() - tStart).count());
+				stage.stats_FramesProcessed++;
+
+				// Pass on by swapping storage with the slot of the next queue (no copy, no allocation)
+				if(next)
+				{
+					Slot* out = next->queue.BeginPush();
+					if( ! out ) { next->stats_FramesDropped++; }
+					else
+					{
+						std::swap(out->frame, in->frame);
+						this->Forward(*next, *out);
+					}
+				}
+				stage.queue.Pop();
+			}
+		}
+
+		void RunStage(Stage& stage, vdsi::Points& frame)
+		{
+			try
+			{
+				if(stage.stage.perFrame) { stage.stage.perFrame(frame); }
+				if(stage.stage.perSubject)
+				{
+					auto& perSubject = stage.stage.perSubject;
+					this->Workers.ParallelFor(frame.all.size(), this->settings.subjectsPerTask, [&frame, &perSubject](size_t begin, size_t end) {
+						for(size_t idx = begin; idx < end; ++idx) { perSubject(frame.all[idx]); }
+					});
+				}
+			}
+			catch(...)
+			{
+				stage.stats_Exceptions++;
+			}
+		}
+
+		// PURPOSE: Commit a slot of the stage's queue, and wake the stage
+		void Forward(Stage& stage, Slot& slot)
+		{
+			slot.tQueued = Clock::now();
+			stage.queue.CommitPush();
+			stage.FrameReady.Set();
+		}
+	};
+}
@@ -0,0 +1,516 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Storage of the data of one Vicon frame
+		Split out of VDS_Interface.h, so that code that only handles frames does not need the Vicon DataStream SDK
+		(e.g. frame sources, replay of recordings, benchmarks)
+
+Class Summary:
+	Point
+		Stores the position and rotation of vicon objects
+		Fixed size storage => no heap allocation per pose
+
+	Point_Marker
+		Stores the position of vicon markers
+
+	FixedPose
+		Pose of one object, without its name or markers (see VDS_Fixed.h)
+
+	Points
+		Stores collections Point objects.
+		Interface allows retrieval of a Point by name
+		Optionally holds the quaternion and Euler angles of all points, computed as a batch (see VDS_PoseKernels.h)
+
+*/
+#pragma once
+
+// Brandon's VDS Interface helpers
+#include "VDS_NameRegistry.h"
+#include "VDS_PoseKernels.h"
+
+// Standard library
+#include <string>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <chrono>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+
+
+namespace vdsi
+{
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Pose storage types
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Fixed size arrays are stored inline in the owning object
+	//	=> creating or copying a point never touches the heap
+	using RotationMatrix = std::array<double, 9>;
+	using Translation = std::array<double, 3>;
+
+	// Values of an occluded or unknown pose
+	inline constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+	inline constexpr RotationMatrix RotationMatrix_NaN = { NaN,NaN,NaN, NaN,NaN,NaN, NaN,NaN,NaN };
+	inline constexpr Translation Translation_NaN = { NaN,NaN,NaN };
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Timestamps of a frame on its way from the cameras to the user
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Host times use std::chrono::steady_clock
+	struct FrameTiming
+	{
+		using Clock = std::chrono::steady_clock;
+
+		// Latency reported by the SDK (GetLatencyTotal) [s]: camera exposure => frame available to the SDK on this computer
+		// Host time: Client.GetFrame() returned in the update thread
+		// Host time: Decoding and filtering finished
+		// Host time: Taken by the user (GetFrame, GetFrames)
+		double latencySDK = vdsi::NaN;
+		Clock::time_point tReceived;
+		Clock::time_point tDecoded;
+		Clock::time_point tPickup;
+
+		// Retimed frames only (see VDS_Interface::GetFrame_Retimed)
+		//	Host time that the poses were predicted for
+		//	Age of the newest Vicon sample at tPose [s]. Positive = predicted forward by this much, negative = interpolated
+		Clock::time_point tPose;
+		double sampleAge = vdsi::NaN;
+
+		// OUTPUT: Estimated host time of the camera exposure (tReceived - latencySDK)
+		Clock::time_point tCaptured() const
+		{
+			return this->tReceived - std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(this->latencySDK));
+		}
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Stores the position of vicon markers
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Markers have no orientation, so unlike Point, there is no rotation matrix
+	class Point_Marker
+	{
+	public:
+		// Marker name, as appears in Vicon Tracker
+		// Global Transformation - Position vector
+		// Set if the marker was occluded
+		std::string viconObjectName;
+		vdsi::Translation P;
+		bool IsOccluded;
+
+		//********************************************************************************
+		// Interface: Create
+		//****************************************
+		// INPUT: (see variable defs)
+		Point_Marker(
+			std::string name_in,
+			vdsi::Translation P_in = vdsi::Translation_NaN,
+			bool occluded_in = true
+		) :
+			viconObjectName(name_in),
+			P(P_in),
+			IsOccluded(occluded_in)
+		{
+			// Nothing to do
+		}
+
+		//********************************************************************************
+		// Interface: Get
+		//****************************************
+		// OUTPUT: x,y,z coordinates
+		double x() const { return this->P[0]; }
+		double y() const { return this->P[1]; }
+		double z() const { return this->P[2]; }
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Stores the position and rotation of vicon objects
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// I suggest editing this to use the Armadillo C++ Maths library,
+	// but to keep it simple for the template, I use std::array
+	class Point
+	{
+	public:
+		// Object name, as appears in Vicon Tracker (VDS calls this the "SubjectName")
+		// Global Transformation - Rotation matrix, stored in row major order
+		// Global Transformation - Position vector
+		// Set if the object was occluded
+		std::string viconObjectName;
+		vdsi::RotationMatrix R_rowMajor;
+		vdsi::Translation P;
+		bool IsOccluded;
+
+		//********************************************************************************
+		// Interface: Create
+		//****************************************
+		// INPUT: (see variable defs)
+		Point(
+			std::string name_in,
+			vdsi::RotationMatrix R_in = vdsi::RotationMatrix_NaN,
+			vdsi::Translation P_in = vdsi::Translation_NaN,
+			bool occluded_in = true
+		) :
+			viconObjectName(name_in),
+			R_rowMajor(R_in),
+			P(P_in),
+			IsOccluded(occluded_in)
+		{
+			// Nothing to do
+		}
+
+		// INPUT: (see variable defs) Kept for code written against the std::vector version of this class
+		Point(
+			std::string name_in,
+			const std::vector<double>& R_in,
+			const std::vector<double>& P_in,
+			bool occluded_in = true
+		) :
+			viconObjectName(name_in),
+			IsOccluded(occluded_in)
+		{
+			// Validate input
+			if(R_in.size() != 9) { throw std::runtime_error("ERROR_VDS: R_rowMajor is wrong size"); }
+			if(P_in.size() != 3) { throw std::runtime_error("ERROR_VDS: P is wrong size"); }
+
+			std::copy(R_in.begin(), R_in.end(), this->R_rowMajor.begin());
+			std::copy(P_in.begin(), P_in.end(), this->P.begin());
+		}
+
+		//********************************************************************************
+		// Interface: Get
+		//****************************************
+		// OUTPUT: x,y,z coordinates
+		double x() const { return this->P[0]; }
+		double y() const { return this->P[1]; }
+		double z() const { return this->P[2]; }
+
+		// OUTPUT: the element of the rotation matrix, R(col,row)
+		//	Counting starts at 1, because I said so! => valid range=[1:3]
+		double R_at(uint8_t col, uint8_t row) const
+		{
+			// Validate input
+			if(1>row||row>3 || 1>col||col>3) {throw  std::runtime_error("ERROR_VDS: Out of bounds");}
+
+			return this->R_rowMajor[3*(col-1) + (row-1)];
+		}
+
+		// OUTPUT: Rotation as a unit quaternion (x,y,z,w) or (w,x,y,z), w >= 0. NaN if occluded
+		//	For many points at once, Points::ComputePoses() is faster
+		std::array<double, 4> quat_xyzw() const
+		{
+			bool IsOccluded_kernel;
+			std::array<double, 4> q;
+			std::array<double, 3> rpy;
+			vdsi::kernels::SinglePose(this->R_rowMajor.data(), this->P.data(), IsOccluded_kernel, q, rpy);
+			return q;
+		}
+		std::array<double, 4> quat_wxyz() const
+		{
+			auto q = this->quat_xyzw();
+			return { q[3], q[0], q[1], q[2] };
+		}
+
+		// OUTPUT: Euler angles (roll, pitch, yaw) [rad], R = Rz(yaw) * Ry(pitch) * Rx(roll). NaN if occluded
+		std::array<double, 3> euler_rpy() const
+		{
+			bool IsOccluded_kernel;
+			std::array<double, 4> q;
+			std::array<double, 3> rpy;
+			vdsi::kernels::SinglePose(this->R_rowMajor.data(), this->P.data(), IsOccluded_kernel, q, rpy);
+			return rpy;
+		}
+	};
+
+	class Point_Object : public Point
+	{
+	public:
+		// Child markers of this point
+		// Handle of viconObjectName (invalid if the point was not created by VDS_Interface)
+		// Delta mode only: incremented each time the pose or occlusion changed (see VDS_Delta.h). Otherwise 0
+		// Index of the Vicon system that saw this point (see VDS_Aggregator.h). Otherwise 0
+		std::vector<vdsi::Point_Marker> markers;
+		vdsi::SubjectHandle handle;
+		uint32_t generation = 0;
+		uint16_t source = 0;
+
+		//********************************************************************************
+		// Interface: Create
+		//****************************************
+		// INPUT: (see variable defs)
+		Point_Object(
+			std::string name_in,
+			vdsi::RotationMatrix R_in = vdsi::RotationMatrix_NaN,
+			vdsi::Translation P_in = vdsi::Translation_NaN,
+			bool occluded_in = true
+		) :
+			Point(
+				name_in,
+				R_in,
+				P_in,
+				occluded_in)
+		{
+			// Nothing to do
+		}
+
+		// INPUT: (see variable defs) Kept for code written against the std::vector version of this class
+		Point_Object(
+			std::string name_in,
+			const std::vector<double>& R_in,
+			const std::vector<double>& P_in,
+			bool occluded_in = true
+		) :
+			Point(
+				name_in,
+				R_in,
+				P_in,
+				occluded_in)
+		{
+			// Nothing to do
+		}
+
+		//********************************************************************************
+		// Interface: Set
+		//****************************************
+		// INPUT: Point_Marker
+		void AddMarker(const vdsi::Point_Marker& marker)
+		{
+			// Save point
+			this->markers.push_back(marker);
+		}
+
+		// PURPOSE:
+		//	Overwrite this point with a new pose, keeping the storage allocated for the markers
+		//	Used to refill a frame without allocating (see Points::RefillNext)
+		void Reset(const std::string& name_in, const vdsi::RotationMatrix& R_in, const vdsi::Translation& P_in, bool occluded_in, vdsi::SubjectHandle handle_in = vdsi::SubjectHandle())
+		{
+			this->handle = handle_in;
+			this->generation = 0;
+			this->source = 0;
+			this->viconObjectName = name_in;
+			this->R_rowMajor = R_in;
+			this->P = P_in;
+			this->IsOccluded = occluded_in;
+			this->markers.clear();
+		}
+
+		//********************************************************************************
+		// Interface: Get
+		//****************************************
+		// INPUT: Marker name
+		// OUTPUT: Copy of the found Marker
+		vdsi::Point_Marker Get(std::string name) const
+		{
+			for (auto&& marker : this->markers)
+			{
+				// Return copy of point upon finding
+				if (marker.viconObjectName == name) { return vdsi::Point_Marker(marker); }
+			}
+
+			// No point found => return occluded
+			return vdsi::Point_Marker(name);
+		}
+
+		// INPUT: Marker name
+		// OUTPUT: Handle for fast access with Marker(), or an invalid handle if not found
+		//	Resolve once, then reuse the handle for every frame
+		vdsi::MarkerHandle FindMarker(const std::string& name) const
+		{
+			for (uint32_t idx = 0; idx < this->markers.size(); ++idx)
+			{
+				if (this->markers[idx].viconObjectName == name) { return vdsi::MarkerHandle{idx}; }
+			}
+			return vdsi::MarkerHandle();
+		}
+
+		// INPUT: Marker handle
+		// OUTPUT: Pointer to the marker, or nullptr if the object has no such marker
+		const vdsi::Point_Marker* Marker(vdsi::MarkerHandle markerHandle) const
+		{
+			if(markerHandle.index >= this->markers.size()) { return nullptr; }
+			return &this->markers[markerHandle.index];
+		}
+
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Pose of one object, without its name or markers
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Same meaning as the members of Point (see VDS_Fixed.h, and FrameSource::DecodePoses)
+	struct FixedPose
+	{
+		vdsi::RotationMatrix R_rowMajor = vdsi::RotationMatrix_NaN;
+		vdsi::Translation P = vdsi::Translation_NaN;
+		bool IsOccluded = true;
+
+		double x() const { return this->P[0]; }
+		double y() const { return this->P[1]; }
+		double z() const { return this->P[2]; }
+
+		// OUTPUT: Rotation as a unit quaternion (x,y,z,w), w >= 0. NaN if occluded (see Point::quat_xyzw)
+		std::array<double, 4> quat_xyzw() const
+		{
+			bool IsOccluded_kernel;
+			std::array<double, 4> q;
+			std::array<double, 3> rpy;
+			vdsi::kernels::SinglePose(this->R_rowMajor.data(), this->P.data(), IsOccluded_kernel, q, rpy);
+			return q;
+		}
+
+		// OUTPUT: Euler angles (roll, pitch, yaw) [rad]. NaN if occluded (see Point::euler_rpy)
+		std::array<double, 3> euler_rpy() const
+		{
+			bool IsOccluded_kernel;
+			std::array<double, 4> q;
+			std::array<double, 3> rpy;
+			vdsi::kernels::SinglePose(this->R_rowMajor.data(), this->P.data(), IsOccluded_kernel, q, rpy);
+			return rpy;
+		}
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Manages points of the Point class - storage, retrieval by name or handle
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// The points are held contiguously in one vector
+	// Copy assigning into an existing Points object reuses its storage
+	//	=> after the first few frames, refilling or copying a frame does not allocate
+	class Points
+	{
+	public:
+		// Vector of Point objects
+		// VDS Frame number (incremental counter)
+		// Timestamps of this frame
+		std::vector<vdsi::Point_Object> all;
+		unsigned int frameNumber = 0;
+		vdsi::FrameTiming timing;
+
+		// Occlusion, quaternion, and Euler angles of each point in all (same index)
+		//	Empty until ComputePoses() is called on this frame (see VDS_Interface::EnablePoseKernels)
+		vdsi::PoseBatch poses;
+
+	private:
+		static constexpr uint32_t NoSlot = std::numeric_limits<uint32_t>::max();
+
+		// Number of points written since BeginRefill()
+		size_t refillCount = 0;
+
+		// Index into all, for each handle id (NoSlot if not in this frame)
+		std::vector<uint32_t> slotByHandle;
+
+		void IndexPoint(uint32_t slot)
+		{
+			vdsi::SubjectHandle handle = this->all[slot].handle;
+			if( ! handle.IsValid() ) { return; }
+			if(handle.id >= this->slotByHandle.size()) { this->slotByHandle.resize(handle.id + 1, NoSlot); }
+			this->slotByHandle[handle.id] = slot;
+		}
+
+	public:
+		//********************************************************************************
+		// Interface: Set
+		//****************************************
+		// INPUT: Point
+		void AddPoint(const vdsi::Point_Object& point)
+		{
+			// Save point
+			this->all.push_back(point);
+			this->IndexPoint(uint32_t(this->all.size() - 1));
+		}
+
+		// PURPOSE:
+		//	Refill this object with a new frame, reusing the storage of the previous frame
+		//	Call BeginRefill(), then RefillNext() for each point, then EndRefill()
+		//	Points that are not overwritten are removed by EndRefill()
+		void BeginRefill(unsigned int frameNumber_in)
+		{
+			this->frameNumber = frameNumber_in;
+			this->refillCount = 0;
+		}
+
+		// OUTPUT: Reference to the next point to overwrite (use Point_Object::Reset)
+		vdsi::Point_Object& RefillNext()
+		{
+			if(this->refillCount == this->all.size()) { this->all.emplace_back(""); }
+			return this->all[this->refillCount++];
+		}
+
+		void EndRefill()
+		{
+			this->all.erase(this->all.begin() + this->refillCount, this->all.end());
+
+			// Rebuild the handle index
+			std::fill(this->slotByHandle.begin(), this->slotByHandle.end(), NoSlot);
+			for(uint32_t slot = 0; slot < this->all.size(); ++slot) { this->IndexPoint(slot); }
+
+			// Poses of the previous frame no longer apply
+			this->poses.Resize(0);
+		}
+
+		// PURPOSE: Fill poses from the points in all
+		//	The points are converted several at a time with SIMD instructions (see VDS_PoseKernels.h)
+		void ComputePoses()
+		{
+			this->poses.Resize(this->all.size());
+			for(size_t idx = 0; idx < this->all.size(); ++idx)
+			{
+				this->poses.SetInput(idx, this->all[idx].R_rowMajor.data(), this->all[idx].P.data());
+			}
+			this->poses.Compute();
+		}
+
+		//********************************************************************************
+		// Interface: Get
+		//****************************************
+		// INPUT: Point name
+		// OUTPUT: Pointer to the found point, or nullptr if not found
+		const vdsi::Point_Object* Find(const std::string& name) const
+		{
+			for(auto&& point : this->all)
+			{
+				if (point.viconObjectName == name) { return &point; }
+			}
+			return nullptr;
+		}
+
+		// INPUT: Handle of the point name (see VDS_Interface::GetHandle)
+		// OUTPUT: Pointer to the found point, or nullptr if not in this frame
+		//	Constant time. Prefer this over Get(name) in fast loops
+		const vdsi::Point_Object* Find(vdsi::SubjectHandle handle) const
+		{
+			if(handle.id >= this->slotByHandle.size()) { return nullptr; }
+			uint32_t slot = this->slotByHandle[handle.id];
+			if(slot == NoSlot) { return nullptr; }
+			return &this->all[slot];
+		}
+
+		// INPUT: Point name
+		// OUTPUT: Copy of the found point
+		vdsi::Point_Object Get(std::string name) const
+		{
+			// Return copy of point upon finding
+			auto point = this->Find(name);
+			if(point) { return vdsi::Point_Object(*point); }
+
+			// No point found => return occluded
+			return vdsi::Point_Object(name);
+		}
+
+		// INPUT: Point name, or handle
+		// OUTPUT: Index of the point in all (and in poses), or -1 if not found
+		long IndexOf(const std::string& name) const
+		{
+			auto point = this->Find(name);
+			return point ? long(point - this->all.data()) : -1;
+		}
+		long IndexOf(vdsi::SubjectHandle handle) const
+		{
+			auto point = this->Find(handle);
+			return point ? long(point - this->all.data()) : -1;
+		}
+	};
+}
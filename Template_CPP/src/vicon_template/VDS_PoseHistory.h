@@ -0,0 +1,357 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Recent poses of each object, addressable by host time
+		For controllers that compensate for latency, and need the pose "at time t" rather than the latest frame
+		e.g. the pose at the time a sensor reading was taken, or at the time an actuation will take effect
+	Used through VDS_Interface::EnablePoseHistory() and GetPoseAt()
+
+Class Summary:
+	PoseHistory
+		Fixed capacity ring of samples per object (no allocation once every object has been seen)
+		Samples are stamped with the estimated time of the camera exposure (FrameTiming::tCaptured)
+		Query by time: binary search (O(log capacity)), then
+			linear interpolation of position, SLERP of rotation
+			or extrapolation past the newest sample, up to a limit
+		Many readers at once, one writer (the update thread). The writer never waits on a reader
+			Each object's ring is a seqlock: readers retry if the writer changed the ring while they read it
+			New objects are added to a copy of the table of rings, which then replaces it (readers keep the one they hold)
+
+*/
+#pragma once
+
+// Brandon's VDS Interface helpers
+#include "VDS_Points.h"
+#include "VDS_NameRegistry.h"
+#include "VDS_PoseKernels.h"
+
+// Standard library
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace vdsi
+{
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Settings and result of a query
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	struct PoseHistorySettings
+	{
+		// Samples held per object. e.g. 256 samples at 200 Hz => 1.28 s of history
+		// Furthest to extrapolate past the newest sample (0 = never extrapolate)
+		// Don't interpolate across a gap between samples longer than this (e.g. the object was occluded)
+		size_t capacity = 256;
+		std::chrono::nanoseconds maxExtrapolation = std::chrono::milliseconds(20);
+		std::chrono::nanoseconds maxGap = std::chrono::milliseconds(50);
+	};
+
+	enum class PoseEstimate
+	{
+		Unavailable,  // No samples near the requested time (the pose is returned as occluded)
+		Interpolated, // Between two samples (or exactly at one)
+		Extrapolated  // Past the newest sample, within maxExtrapolation
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Pose history of all objects
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	class PoseHistory
+	{
+	private:
+		using Quaternion = std::array<double, 4>; // w,x,y,z
+
+		// Rotation is held as a quaternion, converted once when the sample is added
+		struct Sample
+		{
+			int64_t tNs;
+			vdsi::Translation P;
+			Quaternion q;
+		};
+
+		// Ring of samples of one object, oldest first from index [first]
+		//	seq is odd while the writer changes the ring (seqlock)
+		//	The samples are allocated before the ring is published, and never resized => every index is in bounds, even in a torn read
+		struct SubjectHistory
+		{
+			std::atomic<uint64_t> seq = 0;
+			std::vector<Sample> samples;
+			std::atomic<size_t> first = 0;
+			std::atomic<size_t> count = 0;
+
+			explicit SubjectHistory(size_t capacity) : samples(capacity) { }
+
+			const Sample& At(size_t first_in, size_t idx) const { return this->samples[(first_in + idx) % this->samples.size()]; }
+		};
+
+		// Rings indexed by handle id (nullptr = object not seen yet)
+		//	Only the writer replaces the table, by a copy with the new objects (Subjects_Writer is its own reference)
+		using Table = std::vector<std::shared_ptr<SubjectHistory>>;
+
+		vdsi::PoseHistorySettings Settings;
+		std::atomic<std::shared_ptr<const Table>> Subjects = std::make_shared<const Table>();
+		std::shared_ptr<const Table> Subjects_Writer = this->Subjects.load();
+		std::atomic<bool> IsClearRequest = false;
+
+	public:
+		//********************************************************************************
+		// Interface: Create
+		//****************************************
+		explicit PoseHistory(const vdsi::PoseHistorySettings& settings) : Settings(settings)
+		{
+			if(settings.capacity < 2) { throw std::runtime_error("ERROR_VDS: PoseHistory capacity must be >= 2"); }
+		}
+
+		//********************************************************************************
+		// Interface: Set
+		//****************************************
+		// PURPOSE:
+		//	Add the poses of a frame, stamped with the time of the camera exposure
+		//	Occluded objects are not added. Frames older than the newest sample of an object are ignored
+		//	Only one thread may add (the update thread)
+		void Add(const vdsi::Points& frame)
+		{
+			int64_t tNs = std::chrono::duration_cast<std::chrono::nanoseconds>(frame.timing.tCaptured().time_since_epoch()).count();
+
+			if(this->IsClearRequest.exchange(false))
+			{
+				for(auto& history : *this->Subjects_Writer)
+				{
+					if( ! history ) { continue; }
+					uint64_t seq = history->seq.load(std::memory_order_relaxed);
+					history->seq.store(seq + 1, std::memory_order_relaxed);
+					std::atomic_thread_fence(std::memory_order_release);
+					history->first.store(0, std::memory_order_relaxed);
+					history->count.store(0, std::memory_order_relaxed);
+					history->seq.store(seq + 2, std::memory_order_release);
+				}
+			}
+
+			for(auto& point : frame.all)
+			{
+				if(point.IsOccluded || ! point.handle.IsValid()) { continue; }
+
+				// First sample of this object => allocate its ring, and publish a table that holds it
+				if(point.handle.id >= this->Subjects_Writer->size() || ! (*this->Subjects_Writer)[point.handle.id])
+				{
+					auto grown = std::make_shared<Table>(*this->Subjects_Writer);
+					if(point.handle.id >= grown->size()) { grown->resize(point.handle.id + 1); }
+					(*grown)[point.handle.id] = std::make_shared<SubjectHistory>(this->Settings.capacity);
+					this->Subjects_Writer = grown;
+					this->Subjects.store(this->Subjects_Writer);
+				}
+				SubjectHistory& history = *(*this->Subjects_Writer)[point.handle.id];
+
+				// Only this thread writes the ring => its own reads need no seqlock
+				size_t first = history.first.load(std::memory_order_relaxed);
+				size_t count = history.count.load(std::memory_order_relaxed);
+				if(count > 0 && tNs <= history.At(first, count - 1).tNs) { continue; }
+
+				// Same conversion as PoseBatch (x,y,z,w with w >= 0), reordered to w,x,y,z once here
+				bool IsOccluded = false;
+				std::array<double, 4> q_xyzw;
+				std::array<double, 3> rpy;
+				vdsi::kernels::SinglePose(point.R_rowMajor.data(), point.P.data(), IsOccluded, q_xyzw, rpy);
+				if(IsOccluded) { continue; }
+
+				// Full => overwrite the oldest
+				size_t slot = (first + count) % history.samples.size();
+				if(count == history.samples.size()) { first = (first + 1) % history.samples.size(); }
+				else { ++count; }
+
+				uint64_t seq = history.seq.load(std::memory_order_relaxed);
+				history.seq.store(seq + 1, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_release);
+				Sample& sample = history.samples[slot];
+				sample.tNs = tNs;
+				sample.P = point.P;
+				sample.q = { q_xyzw[3], q_xyzw[0], q_xyzw[1], q_xyzw[2] };
+				history.first.store(first, std::memory_order_relaxed);
+				history.count.store(count, std::memory_order_relaxed);
+				history.seq.store(seq + 2, std::memory_order_release);
+			}
+		}
+
+		// PURPOSE: Forget all samples (keeps the allocated rings)
+		//	Done by the writer, at the next Add()
+		void Clear() { this->IsClearRequest = true; }
+
+		//********************************************************************************
+		// Interface: Get
+		//****************************************
+		// INPUT:
+		//	handle = object (see VDS_Interface::GetHandle)
+		//	t = host time of the pose (same clock as FrameTiming)
+		// OUTPUT:
+		//	pose = R_rowMajor, P and IsOccluded are overwritten (the name is not changed)
+		//		Unavailable => NaN and occluded
+		//	return = how the pose was found
+		vdsi::PoseEstimate GetPoseAt(vdsi::SubjectHandle handle, vdsi::FrameTiming::Clock::time_point t, vdsi::Point& pose) const
+		{
+			int64_t tNs = std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+
+			auto subjects = this->Subjects.load();
+			const SubjectHistory* history = (handle.id < subjects->size()) ? (*subjects)[handle.id].get() : nullptr;
+			if( ! history ) { return SetUnavailable(pose); }
+
+			// Copy the samples either side of t, then check that the writer did not change the ring meanwhile
+			Sample a;
+			Sample b;
+			vdsi::PoseEstimate estimate;
+			while(true)
+			{
+				uint64_t seq0 = history->seq.load(std::memory_order_acquire);
+				if(seq0 & 1) { std::this_thread::yield(); continue; }
+
+				estimate = this->FindSamples(*history, tNs, a, b);
+
+				// The acquire fence keeps the reads above from moving after the check of seq
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if(history->seq.load(std::memory_order_relaxed) == seq0) { break; }
+			}
+			if(estimate == vdsi::PoseEstimate::Unavailable) { return SetUnavailable(pose); }
+
+			double u = (b.tNs == a.tNs) ? 0 : double(tNs - a.tNs) / double(b.tNs - a.tNs);
+			return SetPose(pose, a, b, u, estimate);
+		}
+
+		// OUTPUT: Host time span held for the object (first = oldest sample, second = newest). Both zero if none
+		std::pair<vdsi::FrameTiming::Clock::time_point, vdsi::FrameTiming::Clock::time_point> TimeSpan(vdsi::SubjectHandle handle) const
+		{
+			using Clock = vdsi::FrameTiming::Clock;
+			auto subjects = this->Subjects.load();
+			const SubjectHistory* history = (handle.id < subjects->size()) ? (*subjects)[handle.id].get() : nullptr;
+			if( ! history ) { return { Clock::time_point(), Clock::time_point() }; }
+
+			int64_t oldestNs = 0;
+			int64_t newestNs = 0;
+			while(true)
+			{
+				uint64_t seq0 = history->seq.load(std::memory_order_acquire);
+				if(seq0 & 1) { std::this_thread::yield(); continue; }
+
+				size_t first = history->first.load(std::memory_order_relaxed);
+				size_t count = history->count.load(std::memory_order_relaxed);
+				oldestNs = (count == 0) ? 0 : history->At(first, 0).tNs;
+				newestNs = (count == 0) ? 0 : history->At(first, count - 1).tNs;
+
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if(history->seq.load(std::memory_order_relaxed) == seq0) { break; }
+			}
+			if(newestNs == 0) { return { Clock::time_point(), Clock::time_point() }; }
+
+			auto ToTime = [](int64_t ns) { return Clock::time_point(std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(ns))); };
+			return { ToTime(oldestNs), ToTime(newestNs) };
+		}
+
+	private:
+		//********************************************************************************
+		// Helper functions
+		//****************************************
+		// PURPOSE: Find the samples to interpolate (or extrapolate) the pose at time tNs from
+		//	Called inside the seqlock of the ring: the result is only used if the ring did not change meanwhile
+		// OUTPUT: a, b = copies of the samples. return = Unavailable if there are none near tNs
+		vdsi::PoseEstimate FindSamples(const SubjectHistory& history, int64_t tNs, Sample& a, Sample& b) const
+		{
+			size_t first = history.first.load(std::memory_order_relaxed);
+			size_t count = history.count.load(std::memory_order_relaxed);
+			if(count == 0 || tNs < history.At(first, 0).tNs) { return vdsi::PoseEstimate::Unavailable; }
+
+			// Past the newest sample => extrapolate from the newest two
+			const Sample& newest = history.At(first, count - 1);
+			if(tNs >= newest.tNs)
+			{
+				if(tNs == newest.tNs) { a = newest; b = newest; return vdsi::PoseEstimate::Interpolated; }
+				if(tNs - newest.tNs > this->Settings.maxExtrapolation.count() || count < 2) { return vdsi::PoseEstimate::Unavailable; }
+
+				const Sample& previous = history.At(first, count - 2);
+				if(newest.tNs - previous.tNs > this->Settings.maxGap.count()) { return vdsi::PoseEstimate::Unavailable; }
+				a = previous;
+				b = newest;
+				return vdsi::PoseEstimate::Extrapolated;
+			}
+
+			// Binary search: first sample later than t
+			size_t lo = 1;
+			size_t hi = count - 1;
+			while(lo < hi)
+			{
+				size_t mid = lo + (hi - lo) / 2;
+				if(history.At(first, mid).tNs <= tNs) { lo = mid + 1; }
+				else { hi = mid; }
+			}
+			const Sample& after = history.At(first, lo);
+			const Sample& before = history.At(first, lo - 1);
+			if(after.tNs - before.tNs > this->Settings.maxGap.count()) { return vdsi::PoseEstimate::Unavailable; }
+			a = before;
+			b = after;
+			return vdsi::PoseEstimate::Interpolated;
+		}
+
+		static vdsi::PoseEstimate SetUnavailable(vdsi::Point& pose)
+		{
+			pose.R_rowMajor = vdsi::RotationMatrix_NaN;
+			pose.P = vdsi::Translation_NaN;
+			pose.IsOccluded = true;
+			return vdsi::PoseEstimate::Unavailable;
+		}
+
+		// PURPOSE: Pose at fraction u from sample a (u=0) to sample b (u=1). u>1 extrapolates
+		static vdsi::PoseEstimate SetPose(vdsi::Point& pose, const Sample& a, const Sample& b, double u, vdsi::PoseEstimate estimate)
+		{
+			for(int idx = 0; idx < 3; ++idx) { pose.P[idx] = a.P[idx] + u * (b.P[idx] - a.P[idx]); }
+			pose.R_rowMajor = ToRotationMatrix(Slerp(a.q, b.q, u));
+			pose.IsOccluded = false;
+			return estimate;
+		}
+
+		// PURPOSE: Spherical linear interpolation (also valid for u outside [0,1])
+		static Quaternion Slerp(const Quaternion& a, Quaternion b, double u)
+		{
+			// q and -q are the same rotation => take the shorter way around
+			double cosTheta = a[0]*b[0] + a[1]*b[1] + a[2]*b[2] + a[3]*b[3];
+			if(cosTheta < 0) { cosTheta = -cosTheta; for(auto& value : b) { value = -value; } }
+
+			// Nearly the same rotation => linear interpolation avoids dividing by ~0
+			double wa = 1 - u;
+			double wb = u;
+			if(cosTheta < 0.9995)
+			{
+				double theta = std::acos(cosTheta);
+				double sinTheta = std::sin(theta);
+				wa = std::sin((1 - u) * theta) / sinTheta;
+				wb = std::sin(u * theta) / sinTheta;
+			}
+
+			Quaternion q;
+			for(int idx = 0; idx < 4; ++idx) { q[idx] = wa * a[idx] + wb * b[idx]; }
+			double norm = std::sqrt(q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3]);
+			for(auto& value : q) { value /= norm; }
+			return q;
+		}
+
+		// PURPOSE: Unit quaternion => rotation matrix (row major)
+		static vdsi::RotationMatrix ToRotationMatrix(const Quaternion& q)
+		{
+			double w = q[0], x = q[1], y = q[2], z = q[3];
+			return {
+				1 - 2*(y*y + z*z),     2*(x*y - w*z),     2*(x*z + w*y),
+				    2*(x*y + w*z), 1 - 2*(x*x + z*z),     2*(y*z - w*x),
+				    2*(x*z - w*y),     2*(y*z + w*x), 1 - 2*(x*x + y*y)
+			};
+		}
+	};
+}
@@ -0,0 +1,394 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Batch conversion of the poses of all objects in a frame: occlusion, quaternion, and Euler angles
+		Runs over the frame as structure-of-arrays, several objects per instruction (SIMD)
+	Used through Points::ComputePoses(), or automatically with VDS_Interface::EnablePoseKernels()
+
+	Instruction set (chosen at compile time):
+		AVX2   = 4 objects at a time. Build with -mavx2 (GCC) or /arch:AVX2 (MSVC), e.g. cmake -DVDS_ENABLE_AVX2=ON
+		SSE2   = 2 objects at a time. Every x86-64 CPU
+		Scalar = 1 object at a time. Other CPUs (e.g. ARM)
+	All produce the same results (same algorithm, no fused multiply-add)
+
+	Conventions (R is row major: R(row,col) = R_rowMajor[3*row + col])
+		Quaternion (x,y,z,w), unit length, w >= 0 (same as Template_Python: Point.quat_xyzw())
+		Euler angles (roll, pitch, yaw) [rad]: R = Rz(yaw) * Ry(pitch) * Rx(roll)
+			roll, yaw in [-pi, pi], pitch in [-pi/2, pi/2]
+		Occluded = rotation all 0, or position all 0 (as returned by the SDK), or any NaN
+			Occluded objects get NaN quaternion and Euler angles
+
+Class Summary:
+	PoseBatch
+		Inputs (R, P) and outputs (occluded, quaternion, Euler angles) of a frame, structure-of-arrays
+
+	kernels
+		The algorithm, written once against a small set of vector operations (Lanes_*)
+
+*/
+#pragma once
+
+// Standard library
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <vector>
+
+// SIMD intrinsics
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define VDSI_POSE_KERNELS_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define VDSI_POSE_KERNELS_SSE2
+#endif
+
+
+namespace vdsi
+{
+	namespace kernels
+	{
+		//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+		// Vector operations
+		//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+		// V = vector of doubles, M = mask (result of a comparison)
+		// Select(m, a, b) = m ? a : b, per lane
+		struct Lanes_Scalar
+		{
+			using V = double;
+			using M = bool;
+			static constexpr size_t Width = 1;
+
+			static V Load(const double* p) { return *p; }
+			static void Store(double* p, V a) { *p = a; }
+			static V Set(double a) { return a; }
+
+			static V Add(V a, V b) { return a + b; }
+			static V Sub(V a, V b) { return a - b; }
+			static V Mul(V a, V b) { return a * b; }
+			static V Div(V a, V b) { return a / b; }
+			static V Sqrt(V a) { return std::sqrt(a); }
+			static V Max(V a, V b) { return a > b ? a : b; }
+			static V Abs(V a) { return std::fabs(a); }
+			static V CopySign(V magnitude, V sign) { return std::copysign(magnitude, sign); }
+
+			static M Eq(V a, V b) { return a == b; }
+			static M Lt(V a, V b) { return a < b; }
+			static M Ge(V a, V b) { return a >= b; }
+			static M IsNaN(V a) { return a != a; }
+			static M And(M a, M b) { return a && b; }
+			static M Or(M a, M b) { return a || b; }
+			static M AndNot(M a, M b) { return ! a && b; }
+			static V Select(M m, V a, V b) { return m ? a : b; }
+			static unsigned Bits(M m) { return m ? 1u : 0u; }
+		};
+
+#if defined(VDSI_POSE_KERNELS_SSE2)
+		struct Lanes_SSE2
+		{
+			using V = __m128d;
+			using M = __m128d;
+			static constexpr size_t Width = 2;
+
+			static V Load(const double* p) { return _mm_loadu_pd(p); }
+			static void Store(double* p, V a) { _mm_storeu_pd(p, a); }
+			static V Set(double a) { return _mm_set1_pd(a); }
+
+			static V Add(V a, V b) { return _mm_add_pd(a, b); }
+			static V Sub(V a, V b) { return _mm_sub_pd(a, b); }
+			static V Mul(V a, V b) { return _mm_mul_pd(a, b); }
+			static V Div(V a, V b) { return _mm_div_pd(a, b); }
+			static V Sqrt(V a) { return _mm_sqrt_pd(a); }
+			static V Max(V a, V b) { return _mm_max_pd(a, b); }
+			static V Abs(V a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+			static V CopySign(V magnitude, V sign)
+			{
+				V signBit = _mm_set1_pd(-0.0);
+				return _mm_or_pd(_mm_andnot_pd(signBit, magnitude), _mm_and_pd(signBit, sign));
+			}
+
+			static M Eq(V a, V b) { return _mm_cmpeq_pd(a, b); }
+			static M Lt(V a, V b) { return _mm_cmplt_pd(a, b); }
+			static M Ge(V a, V b) { return _mm_cmpge_pd(a, b); }
+			static M IsNaN(V a) { return _mm_cmpunord_pd(a, a); }
+			static M And(M a, M b) { return _mm_and_pd(a, b); }
+			static M Or(M a, M b) { return _mm_or_pd(a, b); }
+			static M AndNot(M a, M b) { return _mm_andnot_pd(a, b); }
+			static V Select(M m, V a, V b) { return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b)); }
+			static unsigned Bits(M m) { return unsigned(_mm_movemask_pd(m)); }
+		};
+#endif
+
+#if defined(VDSI_POSE_KERNELS_AVX2)
+		struct Lanes_AVX2
+		{
+			using V = __m256d;
+			using M = __m256d;
+			static constexpr size_t Width = 4;
+
+			static V Load(const double* p) { return _mm256_loadu_pd(p); }
+			static void Store(double* p, V a) { _mm256_storeu_pd(p, a); }
+			static V Set(double a) { return _mm256_set1_pd(a); }
+
+			static V Add(V a, V b) { return _mm256_add_pd(a, b); }
+			static V Sub(V a, V b) { return _mm256_sub_pd(a, b); }
+			static V Mul(V a, V b) { return _mm256_mul_pd(a, b); }
+			static V Div(V a, V b) { return _mm256_div_pd(a, b); }
+			static V Sqrt(V a) { return _mm256_sqrt_pd(a); }
+			static V Max(V a, V b) { return _mm256_max_pd(a, b); }
+			static V Abs(V a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+			static V CopySign(V magnitude, V sign)
+			{
+				V signBit = _mm256_set1_pd(-0.0);
+				return _mm256_or_pd(_mm256_andnot_pd(signBit, magnitude), _mm256_and_pd(signBit, sign));
+			}
+
+			static M Eq(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+			static M Lt(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+			static M Ge(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_GE_OQ); }
+			static M IsNaN(V a) { return _mm256_cmp_pd(a, a, _CMP_UNORD_Q); }
+			static M And(M a, M b) { return _mm256_and_pd(a, b); }
+			static M Or(M a, M b) { return _mm256_or_pd(a, b); }
+			static M AndNot(M a, M b) { return _mm256_andnot_pd(a, b); }
+			static V Select(M m, V a, V b) { return _mm256_blendv_pd(b, a, m); }
+			static unsigned Bits(M m) { return unsigned(_mm256_movemask_pd(m)); }
+		};
+#endif
+
+		// Widest available at compile time
+#if defined(VDSI_POSE_KERNELS_AVX2)
+		using Lanes_Best = Lanes_AVX2;
+		inline constexpr const char* InstructionSet = "AVX2";
+#elif defined(VDSI_POSE_KERNELS_SSE2)
+		using Lanes_Best = Lanes_SSE2;
+		inline constexpr const char* InstructionSet = "SSE2";
+#else
+		using Lanes_Best = Lanes_Scalar;
+		inline constexpr const char* InstructionSet = "Scalar";
+#endif
+
+		//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+		// Algorithm
+		//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+		// PURPOSE: atan(t) for t in [0, 1]
+		//	Cephes atan: rational approximation after reduction to |t| <= 0.66. Accurate to ~1e-16
+		template<class L>
+		typename L::V AtanUnit(typename L::V t)
+		{
+			using V = typename L::V;
+			auto Poly = [](V z, std::initializer_list<double> c)
+			{
+				V sum = L::Set(*c.begin());
+				for(auto it = c.begin() + 1; it != c.end(); ++it) { sum = L::Add(L::Mul(sum, z), L::Set(*it)); }
+				return sum;
+			};
+
+			// t > 0.66 => atan(t) = pi/4 + atan((t-1)/(t+1))
+			auto IsReduced = L::Lt(L::Set(0.66), t);
+			V x = L::Select(IsReduced, L::Div(L::Sub(t, L::Set(1)), L::Add(t, L::Set(1))), t);
+			V y0 = L::Select(IsReduced, L::Set(0.78539816339744830962 + 0.5 * 6.123233995736765886130E-17), L::Set(0));
+
+			V z = L::Mul(x, x);
+			V p = Poly(z, { -8.750608600031904122785E-1, -1.615753718733365076637E1, -7.500855792314704667340E1, -1.228866684490136173410E2, -6.485021904942025371773E1 });
+			V q = Poly(z, { 1.0, 2.485846490142306297962E1, 1.650270098316988542046E2, 4.328810604912902668951E2, 4.853903996359136964868E2, 1.945506571482613964425E2 });
+			V r = L::Add(x, L::Mul(x, L::Div(L::Mul(z, p), q)));
+			return L::Add(y0, r);
+		}
+
+		// PURPOSE: atan2(y, x), with atan2(0, 0) = 0
+		template<class L>
+		typename L::V Atan2(typename L::V y, typename L::V x)
+		{
+			using V = typename L::V;
+			V ax = L::Abs(x);
+			V ay = L::Abs(y);
+			V big = L::Max(ax, ay);
+			auto IsYBigger = L::Lt(ax, ay);
+			V small = L::Select(IsYBigger, ax, ay);
+
+			// Reduce to [0, 1] (big == 0 => 0)
+			V t = L::Select(L::Eq(big, L::Set(0)), L::Set(0), L::Div(small, big));
+			V a = AtanUnit<L>(t);
+			a = L::Select(IsYBigger, L::Sub(L::Set(1.57079632679489661923), a), a);
+			a = L::Select(L::Lt(x, L::Set(0)), L::Sub(L::Set(3.14159265358979323846), a), a);
+			return L::CopySign(a, y);
+		}
+
+		// PURPOSE:
+		//	Process objects [idx, idx + L::Width)
+		//	R[k], P[k] = component k of each object. Outputs likewise
+		template<class L>
+		void PoseBlock(
+			size_t idx,
+			const std::array<const double*, 9>& R, const std::array<const double*, 3>& P,
+			uint8_t* occluded, const std::array<double*, 4>& q, const std::array<double*, 3>& euler)
+		{
+			using V = typename L::V;
+			V r[9];
+			for(int k = 0; k < 9; ++k) { r[k] = L::Load(R[k] + idx); }
+			V p0 = L::Load(P[0] + idx), p1 = L::Load(P[1] + idx), p2 = L::Load(P[2] + idx);
+			V zero = L::Set(0);
+
+			// Occlusion
+			auto IsRZero = L::Eq(r[0], zero);
+			auto IsNaN = L::IsNaN(r[0]);
+			for(int k = 1; k < 9; ++k)
+			{
+				IsRZero = L::And(IsRZero, L::Eq(r[k], zero));
+				IsNaN = L::Or(IsNaN, L::IsNaN(r[k]));
+			}
+			auto IsPZero = L::And(L::And(L::Eq(p0, zero), L::Eq(p1, zero)), L::Eq(p2, zero));
+			IsNaN = L::Or(IsNaN, L::Or(L::Or(L::IsNaN(p0), L::IsNaN(p1)), L::IsNaN(p2)));
+			auto IsOccluded = L::Or(L::Or(IsRZero, IsPZero), IsNaN);
+			unsigned bits = L::Bits(IsOccluded);
+			for(size_t lane = 0; lane < L::Width; ++lane) { occluded[idx + lane] = uint8_t((bits >> lane) & 1); }
+
+			// Quaternion (Shepperd): find the largest of 4w^2, 4x^2, 4y^2, 4z^2, then the others from the off-diagonal terms
+			V one = L::Set(1);
+			V sw = L::Add(one, L::Add(L::Add(r[0], r[4]), r[8]));
+			V sx = L::Add(one, L::Sub(L::Sub(r[0], r[4]), r[8]));
+			V sy = L::Add(one, L::Sub(L::Sub(r[4], r[0]), r[8]));
+			V sz = L::Add(one, L::Sub(L::Sub(r[8], r[0]), r[4]));
+			auto IsW = L::And(L::And(L::Ge(sw, sx), L::Ge(sw, sy)), L::Ge(sw, sz));
+			auto IsX = L::AndNot(IsW, L::And(L::Ge(sx, sy), L::Ge(sx, sz)));
+			auto IsY = L::AndNot(L::Or(IsW, IsX), L::Ge(sy, sz));
+			V s = L::Select(IsW, sw, L::Select(IsX, sx, L::Select(IsY, sy, sz)));
+
+			V root = L::Sqrt(L::Max(s, L::Set(std::numeric_limits<double>::min())));
+			V largest = L::Mul(L::Set(0.5), root);
+			V scale = L::Div(L::Set(0.25), largest);
+			V d1 = L::Sub(r[7], r[5]); // R21 - R12
+			V d2 = L::Sub(r[2], r[6]); // R02 - R20
+			V d3 = L::Sub(r[3], r[1]); // R10 - R01
+			V s1 = L::Add(r[1], r[3]); // R01 + R10
+			V s2 = L::Add(r[2], r[6]); // R02 + R20
+			V s3 = L::Add(r[5], r[7]); // R12 + R21
+			V qw = L::Select(IsW, largest, L::Mul(scale, L::Select(IsX, d1, L::Select(IsY, d2, d3))));
+			V qx = L::Select(IsX, largest, L::Mul(scale, L::Select(IsW, d1, L::Select(IsY, s1, s2))));
+			V qy = L::Select(IsY, largest, L::Mul(scale, L::Select(IsW, d2, L::Select(IsX, s1, s3))));
+			auto IsZ = L::AndNot(L::Or(L::Or(IsW, IsX), IsY), L::Eq(zero, zero));
+			V qz = L::Select(IsZ, largest, L::Mul(scale, L::Select(IsW, d3, L::Select(IsX, s2, s3))));
+
+			// Unit length (R may be slightly off orthonormal), and w >= 0
+			V norm = L::Sqrt(L::Add(L::Add(L::Mul(qw, qw), L::Mul(qx, qx)), L::Add(L::Mul(qy, qy), L::Mul(qz, qz))));
+			V inv = L::CopySign(L::Div(one, norm), qw);
+
+			// Euler angles (ZYX)
+			V roll = Atan2<L>(r[7], r[8]);
+			V pitch = Atan2<L>(L::Sub(zero, r[6]), L::Sqrt(L::Add(L::Mul(r[0], r[0]), L::Mul(r[3], r[3]))));
+			V yaw = Atan2<L>(r[3], r[0]);
+
+			V nan = L::Set(std::numeric_limits<double>::quiet_NaN());
+			L::Store(q[0] + idx, L::Select(IsOccluded, nan, L::Mul(qx, inv)));
+			L::Store(q[1] + idx, L::Select(IsOccluded, nan, L::Mul(qy, inv)));
+			L::Store(q[2] + idx, L::Select(IsOccluded, nan, L::Mul(qz, inv)));
+			L::Store(q[3] + idx, L::Select(IsOccluded, nan, L::Mul(qw, inv)));
+			L::Store(euler[0] + idx, L::Select(IsOccluded, nan, roll));
+			L::Store(euler[1] + idx, L::Select(IsOccluded, nan, pitch));
+			L::Store(euler[2] + idx, L::Select(IsOccluded, nan, yaw));
+		}
+	}
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Poses of a frame, structure-of-arrays
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Index = index of the object in Points::all
+	// Arrays are padded to a whole number of vectors. Resizing keeps the storage (no allocation once warmed up)
+	class PoseBatch
+	{
+	public:
+		// Inputs: component k of R_rowMajor and P of each object
+		std::array<std::vector<double>, 9> R;
+		std::array<std::vector<double>, 3> P;
+
+		// Outputs: 1 if occluded, quaternion (x,y,z,w), Euler angles (roll,pitch,yaw)
+		std::vector<uint8_t> occluded;
+		std::array<std::vector<double>, 4> quat_xyzw;
+		std::array<std::vector<double>, 3> euler_rpy;
+
+	private:
+		size_t count = 0;
+
+	public:
+		//********************************************************************************
+		// Interface: Set
+		//****************************************
+		// PURPOSE: Set the number of objects (then fill R and P)
+		void Resize(size_t numObjects)
+		{
+			this->count = numObjects;
+			size_t padded = (numObjects + 3) / 4 * 4;
+			for(auto& component : this->R) { component.resize(padded, 0.0); }
+			for(auto& component : this->P) { component.resize(padded, 0.0); }
+			for(auto& component : this->quat_xyzw) { component.resize(padded); }
+			for(auto& component : this->euler_rpy) { component.resize(padded); }
+			this->occluded.resize(padded);
+		}
+
+		// INPUT: Pose of object idx
+		void SetInput(size_t idx, const double* R_rowMajor, const double* P_in)
+		{
+			for(int k = 0; k < 9; ++k) { this->R[k][idx] = R_rowMajor[k]; }
+			for(int k = 0; k < 3; ++k) { this->P[k][idx] = P_in[k]; }
+		}
+
+		// PURPOSE: Compute the outputs from the inputs, with the widest instruction set available
+		void Compute() { this->Compute<vdsi::kernels::Lanes_Best>(); }
+
+		// PURPOSE: Same, with a chosen instruction set (e.g. to compare them)
+		template<class L>
+		void Compute()
+		{
+			std::array<const double*, 9> inR;
+			std::array<const double*, 3> inP;
+			std::array<double*, 4> outQ;
+			std::array<double*, 3> outE;
+			for(int k = 0; k < 9; ++k) { inR[k] = this->R[k].data(); }
+			for(int k = 0; k < 3; ++k) { inP[k] = this->P[k].data(); }
+			for(int k = 0; k < 4; ++k) { outQ[k] = this->quat_xyzw[k].data(); }
+			for(int k = 0; k < 3; ++k) { outE[k] = this->euler_rpy[k].data(); }
+
+			// Padding lanes hold poses too, so whole vectors can run to the end
+			for(size_t idx = 0; idx < this->count; idx += L::Width)
+			{
+				vdsi::kernels::PoseBlock<L>(idx, inR, inP, this->occluded.data(), outQ, outE);
+			}
+		}
+
+		//********************************************************************************
+		// Interface: Get
+		//****************************************
+		size_t Size() const { return this->count; }
+
+		// INPUT: Index of the object
+		bool IsOccluded(size_t idx) const { return this->occluded[idx] != 0; }
+		std::array<double, 4> Quat_xyzw(size_t idx) const { return { this->quat_xyzw[0][idx], this->quat_xyzw[1][idx], this->quat_xyzw[2][idx], this->quat_xyzw[3][idx] }; }
+		std::array<double, 4> Quat_wxyz(size_t idx) const { return { this->quat_xyzw[3][idx], this->quat_xyzw[0][idx], this->quat_xyzw[1][idx], this->quat_xyzw[2][idx] }; }
+		std::array<double, 3> Euler_rpy(size_t idx) const { return { this->euler_rpy[0][idx], this->euler_rpy[1][idx], this->euler_rpy[2][idx] }; }
+	};
+
+	namespace kernels
+	{
+		// PURPOSE: Outputs of a single pose (no SIMD), for the accessors of Point
+		//	Same algorithm as the batch, so single and batch results agree exactly
+		// OUTPUT: occluded, quaternion (x,y,z,w), Euler angles (roll,pitch,yaw)
+		inline void SinglePose(const double* R_rowMajor, const double* P, bool& IsOccluded, std::array<double, 4>& q_xyzw, std::array<double, 3>& rpy)
+		{
+			std::array<const double*, 9> inR;
+			std::array<const double*, 3> inP;
+			for(int k = 0; k < 9; ++k) { inR[k] = R_rowMajor + k; }
+			for(int k = 0; k < 3; ++k) { inP[k] = P + k; }
+			uint8_t occluded = 0;
+			PoseBlock<Lanes_Scalar>(0, inR, inP, &occluded, { &q_xyzw[0], &q_xyzw[1], &q_xyzw[2], &q_xyzw[3] }, { &rpy[0], &rpy[1], &rpy[2] });
+			IsOccluded = occluded != 0;
+		}
+	}
+}
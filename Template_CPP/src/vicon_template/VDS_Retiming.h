@@ -0,0 +1,220 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Poses predicted (or interpolated) to the time they are needed, through the retiming client of the Vicon DataStream SDK
+	For control loops that run faster than Vicon (e.g. 1 kHz controller, 100-200 Hz Vicon)
+		Rather than holding the last frame, each call returns the pose at (now + offset + output latency)
+	Used through VDS_Interface::EnableRetiming() and GetFrame_Retimed()
+
+Class Summary:
+	Retimer
+		Owns a vds::RetimingClient. Thread safe
+		Decodes the retimed poses into vdsi::Points, with the same filtering as VDS_Interface
+		The retiming client does not provide markers => the points have no markers
+
+*/
+#pragma once
+
+// Vicon DataStream SDK
+#include "DataStreamRetimingClient.h"
+namespace vds = ViconDataStreamSDK::CPP;
+
+// Brandon's VDS Interface helpers
+#include "VDS_Points.h"
+#include "VDS_FrameSource.h"
+#include "VDS_FrameSource_SDK.h"
+
+// Standard library
+#include <string>
+#include <mutex>
+#include <chrono>
+#include <vector>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+
+
+namespace vdsi
+{
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Wrapper of the Vicon DataStream SDK retiming client
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// The SDK takes all times in milliseconds
+	class Retimer
+	{
+	private:
+		static constexpr uint32_t NoSubject = std::numeric_limits<uint32_t>::max();
+
+		vds::RetimingClient Client;
+		std::mutex mtx_Client;
+
+		// Resolves names to handles (owned by VDS_Interface)
+		vdsi::NameRegistry& Names;
+
+		// Cached scene layout (same as FrameSource_SDK, without markers)
+		struct SubjectSchema
+		{
+			std::string name;
+			vds::String name_sdk;
+			vds::String segmentName_sdk;
+			vdsi::SubjectHandle handle;
+		};
+		std::vector<SubjectSchema> Schema;
+		std::vector<uint32_t> schemaByHandle;
+
+	public:
+		//********************************************************************************
+		// Interface: Constructor
+		//****************************************
+		// INPUT:
+		//	HostName = IP address of the vicon control computer
+		//	EnableLightweight = (see VDS_Interface::Connect)
+		//	names = resolves names to handles, shared with VDS_Interface so that handles match
+		Retimer(const std::string& HostName, bool EnableLightweight, vdsi::NameRegistry& names) : Names(names)
+		{
+			if(this->Client.Connect(HostName).Result != vds::Result::Success)
+			{
+				throw std::runtime_error("ERROR_VDS: Retiming client failed to connect to " + HostName);
+			}
+			if(EnableLightweight && this->Client.EnableLightweightSegmentData().Result != vds::Result::Success)
+			{
+				throw std::runtime_error("ERROR_VDS: Retiming client failed to initialise");
+			}
+		}
+
+		~Retimer() { this->Client.Disconnect(); }
+
+		//********************************************************************************
+		// Interface: Settings
+		//****************************************
+		// INPUT:
+		//	outputLatency = latency between the pose being returned and it taking effect (e.g. actuation). Poses are predicted forward by this
+		//	maxPrediction = never predict further than this past the newest Vicon sample
+		void SetTiming(std::chrono::nanoseconds outputLatency, std::chrono::nanoseconds maxPrediction)
+		{
+			std::lock_guard<std::mutex> lock(this->mtx_Client);
+			bool wasSuccessful =
+				   this->Client.SetOutputLatency(std::chrono::duration<double, std::milli>(outputLatency).count()).Result == vds::Result::Success
+				&& this->Client.SetMaximumPrediction(std::chrono::duration<double, std::milli>(maxPrediction).count()).Result == vds::Result::Success;
+			if( ! wasSuccessful ) { throw std::runtime_error("ERROR_VDS: Retiming client rejected the timing settings"); }
+		}
+
+		//********************************************************************************
+		// Interface: Get
+		//****************************************
+		// PURPOSE: Poses at (now + offset + output latency)
+		// INPUT:
+		//	offset = time offset of the request
+		//	filter = (see VDS_Interface). With an object filter, only the poses of the listed objects are queried (the others are only probed, to detect a changed layout)
+		//	frameNumber = frame number to label the frame with (the newest Vicon frame)
+		// OUTPUT:
+		//	frame = refilled with the retimed poses. No markers
+		//		Empty if the frame could not be decoded
+		//	return = false if the retiming client has no data yet, or the frame could not be decoded (even with the layout rebuilt)
+		bool GetFrame(vdsi::Points& frame, const vdsi::FrameFilter& filter, std::chrono::nanoseconds offset, unsigned int frameNumber)
+		{
+			std::lock_guard<std::mutex> lock(this->mtx_Client);
+
+			if(this->Client.UpdateFrame(std::chrono::duration<double, std::milli>(offset).count()).Result != vds::Result::Success) { return false; }
+
+			// Same caching as FrameSource_SDK: rebuild when the layout changes
+			unsigned int numS = this->Client.GetSubjectCount().SubjectCount;
+			if(numS != this->Schema.size()) { this->RebuildSchema(); }
+			bool wasSuccessful = this->DecodeSubjects(frame, filter, frameNumber);
+			if( ! wasSuccessful )
+			{
+				this->RebuildSchema();
+				wasSuccessful = this->DecodeSubjects(frame, filter, frameNumber);
+			}
+
+			// Failed again => don't hand out a partial frame
+			if( ! wasSuccessful ) { frame.BeginRefill(frameNumber); }
+			frame.EndRefill();
+			return wasSuccessful;
+		}
+
+	private:
+		// OUTPUT: false if the cached layout no longer matches
+		bool DecodeSubjects(vdsi::Points& frame, const vdsi::FrameFilter& filter, unsigned int frameNumber)
+		{
+			frame.BeginRefill(frameNumber);
+
+			// Object filter: only query the listed objects, in the listed order
+			if(filter.objects)
+			{
+				const auto& objects = *filter.objects;
+
+				// Subjects that are not listed are only probed (as in FrameSource_SDK)
+				//	A subject replaced by a listed object would otherwise leave the cached layout stale, and the object occluded forever
+				for(auto& subject : this->Schema)
+				{
+					bool IsListed = subject.handle.id < objects.isAllowed.size() && objects.isAllowed[subject.handle.id];
+					if( ! IsListed && this->Client.GetSegmentCount(subject.name_sdk).Result != vds::Result::Success ) { return false; }
+				}
+
+				for(size_t idx = 0; idx < objects.order.size(); ++idx)
+				{
+					vdsi::SubjectHandle handle = objects.order[idx];
+					uint32_t idxSubject = (handle.id < this->schemaByHandle.size()) ? this->schemaByHandle[handle.id] : NoSubject;
+					if(idxSubject == NoSubject)
+					{
+						// Objects missing from the frame are saved as occluded
+						if( ! filter.Allows(handle, true) ) { continue; }
+						frame.RefillNext().Reset(objects.names[idx], vdsi::RotationMatrix_NaN, vdsi::Translation_NaN, true, handle);
+						continue;
+					}
+					if( ! this->DecodeSubject(this->Schema[idxSubject], frame, filter) ) { return false; }
+				}
+				return true;
+			}
+
+			for(auto& subject : this->Schema)
+			{
+				if( ! this->DecodeSubject(subject, frame, filter) ) { return false; }
+			}
+			return true;
+		}
+
+		bool DecodeSubject(const SubjectSchema& subject, vdsi::Points& frame, const vdsi::FrameFilter& filter)
+		{
+			vds::Output_GetSegmentGlobalTranslation ret_P = this->Client.GetSegmentGlobalTranslation(subject.name_sdk, subject.segmentName_sdk);
+			if (ret_P.Result != vds::Result::Success) { return false; }
+			vds::Output_GetSegmentGlobalRotationMatrix ret_R = this->Client.GetSegmentGlobalRotationMatrix(subject.name_sdk, subject.segmentName_sdk);
+			if (ret_R.Result != vds::Result::Success) { return false; }
+
+			bool IsOccluded = vdsi::FrameSource_SDK::IsOccludedPose(ret_R.Rotation, ret_P.Translation);
+			if( ! filter.Allows(subject.handle, IsOccluded) ) { return true; }
+
+			vdsi::RotationMatrix R;
+			vdsi::Translation P;
+			std::copy(std::begin(ret_R.Rotation), std::end(ret_R.Rotation), R.begin());
+			std::copy(std::begin(ret_P.Translation), std::end(ret_P.Translation), P.begin());
+			frame.RefillNext().Reset(subject.name, R, P, IsOccluded, subject.handle);
+			return true;
+		}
+
+		void RebuildSchema()
+		{
+			this->Schema.clear();
+			unsigned int numS = this->Client.GetSubjectCount().SubjectCount;
+			for (unsigned int idxSubject = 0; idxSubject < numS; ++idxSubject)
+			{
+				SubjectSchema subject;
+				subject.name = this->Client.GetSubjectName(idxSubject).SubjectName;
+				subject.name_sdk = vds::String(subject.name);
+				subject.handle = this->Names.Intern(subject.name);
+				subject.segmentName_sdk = vds::String(std::string(this->Client.GetSegmentName(subject.name_sdk, 0).SegmentName));
+				this->Schema.push_back(subject);
+			}
+
+			this->schemaByHandle.assign(this->Names.Size(), NoSubject);
+			for(uint32_t idx = 0; idx < this->Schema.size(); ++idx) { this->schemaByHandle[this->Schema[idx].handle.id] = idx; }
+		}
+	};
+}
@@ -0,0 +1,587 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Publish each decoded frame into POSIX shared memory, for other processes on this computer
+		One process holds the Vicon connection (VDS_Interface::EnableSharedMemory)
+		Any number of other processes read the poses (ShmReader), without linking the Vicon DataStream SDK
+		=> they are free of the SDK's -D_GLIBCXX_USE_CXX11_ABI=0 requirement (see vicon_readers)
+
+	Memory layout (namespace vdsi::shm)
+		Only fixed width integers, doubles, and char arrays, with explicit padding
+		=> same layout for any compiler, standard library, or ABI setting (checked by static_assert)
+		Header, then a ring of numSlots frames
+			Each slot: SlotHeader, then maxSubjects Subject records, then maxMarkers Marker records (markers of all subjects)
+
+	Protocol (seqlock, one writer)
+		Writer: slot.seq = odd, write the frame, slot.seq = even, header.written += 1
+		Reader: take the newest slot (header.written - 1), read it, then check that slot.seq is even and unchanged
+			Changed => the writer came round the ring and reused the slot while it was read. Try again on the newest slot
+			The tries are limited: a publisher that died part way through a frame ends the read (see ShmReader::Visit)
+		Neither side ever waits on the other. Readers do not write to the shared memory at all
+
+	Timestamps are std::chrono::steady_clock [ns] (CLOCK_MONOTONIC on Linux, the same clock in every process)
+
+Class Summary:
+	ShmSettings
+		Name and capacity of the shared memory
+
+	ShmPublisher
+		Creates the shared memory and writes frames into it (used by the update thread of VDS_Interface)
+
+	ShmReader
+		Opens the shared memory and reads the latest frame
+		Either copied into a vdsi::Points, or read in place (zero copy) with a visitor
+
+*/
+#pragma once
+
+// Brandon's VDS Interface helpers
+#include "VDS_Points.h"
+
+// Standard library
+#include <iostream>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <new>
+#include <thread>
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+
+// POSIX shared memory
+#if ! defined(_WIN32)
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+
+namespace vdsi
+{
+	namespace shm
+	{
+		//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+		// Memory layout
+		//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+		// Change Version on any change to these structs
+		inline constexpr uint32_t Magic = 0x4D534456; // "VDSM"
+		inline constexpr uint32_t Version = 1;
+		inline constexpr size_t NameBytes = 64; // Including the terminating '\0'. Longer names are cut short
+
+		// Atomics shared between processes must be lock free (then they are plain 8 byte words)
+		static_assert(std::atomic<uint64_t>::is_always_lock_free);
+		static_assert(sizeof(std::atomic<uint64_t>) == 8);
+
+		struct alignas(64) Header
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t headerBytes;
+			uint32_t slotBytes;
+			uint32_t numSlots;
+			uint32_t maxSubjects;
+			uint32_t maxMarkers;
+			uint32_t nameBytes;
+
+			// Cleared when the publisher closes (then reopen to find a new publisher)
+			std::atomic<uint64_t> IsAlive;
+
+			// Frames published so far. The newest is in slot (written - 1) % numSlots
+			// On its own cache line, as readers poll it
+			alignas(64) std::atomic<uint64_t> written;
+		};
+		static_assert(sizeof(Header) == 128);
+		static_assert(offsetof(Header, IsAlive) == 32);
+		static_assert(offsetof(Header, written) == 64);
+
+		struct alignas(64) SlotHeader
+		{
+			// Odd while being written
+			std::atomic<uint64_t> seq;
+			uint64_t frameNumber;
+			int64_t tReceivedNs;
+			int64_t tDecodedNs;
+			double latencySDK;
+			uint32_t numSubjects;
+			uint32_t numMarkers;
+		};
+		static_assert(sizeof(SlotHeader) == 64);
+
+		struct Subject
+		{
+			char name[NameBytes];
+			double R_rowMajor[9];
+			double P[3];
+			uint32_t IsOccluded;
+			uint32_t markerBegin; // Index of the first marker of this subject, in the markers of the slot
+			uint32_t numMarkers;
+			uint32_t padding;
+		};
+		static_assert(sizeof(Subject) == 176);
+
+		struct Marker
+		{
+			char name[NameBytes];
+			double P[3];
+			uint32_t IsOccluded;
+			uint32_t padding;
+		};
+		static_assert(sizeof(Marker) == 96);
+
+		// PURPOSE: Bytes of one slot, rounded up to whole cache lines
+		inline size_t SlotBytes(uint32_t maxSubjects, uint32_t maxMarkers)
+		{
+			size_t bytes = sizeof(SlotHeader) + maxSubjects * sizeof(Subject) + maxMarkers * sizeof(Marker);
+			return (bytes + 63) / 64 * 64;
+		}
+
+		// Read only view of one slot, as given to ShmReader::Visit
+		//	Valid only during the visit. Any value may be torn: the visit is discarded if so
+		struct SlotView
+		{
+			const SlotHeader* header;
+			const Subject* subjects; // [header->numSubjects]
+			const Marker* markers;   // [header->numMarkers]
+		};
+
+		inline void CopyName(char (&dest)[NameBytes], const std::string& source)
+		{
+			size_t length = std::min(source.size(), NameBytes - 1);
+			std::memcpy(dest, source.data(), length);
+			std::memset(dest + length, 0, NameBytes - length);
+		}
+
+		// PURPOSE: Name as written by CopyName (stops at '\0', even if the slot was torn)
+		inline std::string ReadName(const char (&source)[NameBytes])
+		{
+			return std::string(source, ::strnlen(source, NameBytes));
+		}
+
+		inline int64_t ToNs(vdsi::FrameTiming::Clock::time_point t)
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+		}
+
+		inline vdsi::FrameTiming::Clock::time_point FromNs(int64_t ns)
+		{
+			return vdsi::FrameTiming::Clock::time_point(std::chrono::duration_cast<vdsi::FrameTiming::Clock::duration>(std::chrono::nanoseconds(ns)));
+		}
+	}
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Name and capacity of the shared memory
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	struct ShmSettings
+	{
+		// POSIX shared memory name (starts with '/'. On Linux, appears in /dev/shm)
+		std::string name = "/vds_frames";
+
+		// Most subjects per frame, and markers per frame (over all subjects)
+		//	Anything beyond is left out of the shared memory (with a warning)
+		uint32_t maxSubjects = 64;
+		uint32_t maxMarkers = 1024;
+
+		// Frames in the ring. A read is only retried if it takes longer than (numSlots - 1) frame periods
+		uint32_t numSlots = 8;
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Writes frames into shared memory
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// One publisher per name. Publish() is called by one thread only
+	class ShmPublisher
+	{
+	private:
+		vdsi::ShmSettings settings;
+		int fd = -1; // Kept open to recognise our own memory on close
+		size_t slotBytes = 0;
+		size_t totalBytes = 0;
+		unsigned char* base = nullptr;
+		vdsi::shm::Header* header = nullptr;
+		bool HasWarnedCapacity = false;
+
+	public:
+		//********************************************************************************
+		// Interface: Create
+		//****************************************
+		// PURPOSE: Create (or replace) the shared memory
+		ShmPublisher(const vdsi::ShmSettings& settings_in) :
+			settings(settings_in)
+		{
+#if defined(_WIN32)
+			throw std::runtime_error("ERROR_VDS: (ShmPublisher) Shared memory publishing needs POSIX shared memory (Linux, macOS)");
+#else
+			// Validate input
+			if(this->settings.numSlots < 2) { throw std::runtime_error("ERROR_VDS: (ShmPublisher) numSlots must be at least 2"); }
+
+			this->slotBytes = vdsi::shm::SlotBytes(this->settings.maxSubjects, this->settings.maxMarkers);
+			this->totalBytes = sizeof(vdsi::shm::Header) + this->settings.numSlots * this->slotBytes;
+
+			// Replace any leftover of a previous publisher: readers of the old one see IsAlive = 0
+			this->MarkOldPublisherDead();
+			::shm_unlink(this->settings.name.c_str());
+			this->fd = ::shm_open(this->settings.name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+			if(this->fd < 0) { throw std::runtime_error("ERROR_VDS: (ShmPublisher) shm_open failed for " + this->settings.name); }
+			void* mapped = MAP_FAILED;
+			if(::ftruncate(this->fd, off_t(this->totalBytes)) == 0)
+			{
+				mapped = ::mmap(nullptr, this->totalBytes, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+			}
+			if(mapped == MAP_FAILED)
+			{
+				::close(this->fd);
+				::shm_unlink(this->settings.name.c_str());
+				throw std::runtime_error("ERROR_VDS: (ShmPublisher) Could not allocate " + std::to_string(this->totalBytes) + " bytes of shared memory for " + this->settings.name);
+			}
+			this->base = static_cast<unsigned char*>(mapped);
+
+			// New memory is zero filled => every slot seq = 0 (even, never written)
+			this->header = new (this->base) vdsi::shm::Header{};
+			this->header->magic = vdsi::shm::Magic;
+			this->header->version = vdsi::shm::Version;
+			this->header->headerBytes = uint32_t(sizeof(vdsi::shm::Header));
+			this->header->slotBytes = uint32_t(this->slotBytes);
+			this->header->numSlots = this->settings.numSlots;
+			this->header->maxSubjects = this->settings.maxSubjects;
+			this->header->maxMarkers = this->settings.maxMarkers;
+			this->header->nameBytes = uint32_t(vdsi::shm::NameBytes);
+			for(uint32_t idx = 0; idx < this->settings.numSlots; ++idx) { new (this->Slot(idx)) vdsi::shm::SlotHeader{}; }
+			this->header->written.store(0, std::memory_order_relaxed);
+			this->header->IsAlive.store(1, std::memory_order_release);
+#endif
+		}
+
+		ShmPublisher(const ShmPublisher&) = delete;
+		ShmPublisher& operator=(const ShmPublisher&) = delete;
+
+		// PURPOSE: Remove the shared memory. Readers that still have it mapped see IsAlive = 0
+		~ShmPublisher()
+		{
+#if ! defined(_WIN32)
+			if( ! this->base ) { return; }
+			this->header->IsAlive.store(0, std::memory_order_release);
+			::munmap(this->base, this->totalBytes);
+
+			// Unlink the name only if it is still ours (a newer publisher may have replaced it)
+			struct stat ours, named;
+			int fdNamed = ::shm_open(this->settings.name.c_str(), O_RDONLY, 0);
+			if(fdNamed >= 0)
+			{
+				if(::fstat(this->fd, &ours) == 0 && ::fstat(fdNamed, &named) == 0 && ours.st_ino == named.st_ino && ours.st_dev == named.st_dev)
+				{
+					::shm_unlink(this->settings.name.c_str());
+				}
+				::close(fdNamed);
+			}
+			::close(this->fd);
+#endif
+		}
+
+		//********************************************************************************
+		// Interface: Publish
+		//****************************************
+		// PURPOSE: Write frame into the next slot of the ring. Never waits on readers
+		void Publish(const vdsi::Points& frame)
+		{
+			uint64_t written = this->header->written.load(std::memory_order_relaxed);
+			auto slot = this->Slot(uint32_t(written % this->settings.numSlots));
+			auto subjects = reinterpret_cast<vdsi::shm::Subject*>(slot + 1);
+			auto markers = reinterpret_cast<vdsi::shm::Marker*>(subjects + this->settings.maxSubjects);
+
+			// Begin write: odd seq
+			//	The release fence keeps the writes below from being seen before the odd seq
+			uint64_t seq = slot->seq.load(std::memory_order_relaxed);
+			slot->seq.store(seq + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+
+			uint32_t numSubjects = 0;
+			uint32_t numMarkers = 0;
+			bool IsTruncated = false;
+			for(auto& point : frame.all)
+			{
+				if(numSubjects == this->settings.maxSubjects) { IsTruncated = true; break; }
+				auto& subject = subjects[numSubjects++];
+				vdsi::shm::CopyName(subject.name, point.viconObjectName);
+				std::memcpy(subject.R_rowMajor, point.R_rowMajor.data(), sizeof(subject.R_rowMajor));
+				std::memcpy(subject.P, point.P.data(), sizeof(subject.P));
+				subject.IsOccluded = point.IsOccluded ? 1 : 0;
+				subject.markerBegin = numMarkers;
+
+				for(auto& marker_in : point.markers)
+				{
+					if(numMarkers == this->settings.maxMarkers) { IsTruncated = true; break; }
+					auto& marker = markers[numMarkers++];
+					vdsi::shm::CopyName(marker.name, marker_in.viconObjectName);
+					std::memcpy(marker.P, marker_in.P.data(), sizeof(marker.P));
+					marker.IsOccluded = marker_in.IsOccluded ? 1 : 0;
+				}
+				subject.numMarkers = numMarkers - subject.markerBegin;
+			}
+			slot->frameNumber = frame.frameNumber;
+			slot->tReceivedNs = vdsi::shm::ToNs(frame.timing.tReceived);
+			slot->tDecodedNs = vdsi::shm::ToNs(frame.timing.tDecoded);
+			slot->latencySDK = frame.timing.latencySDK;
+			slot->numSubjects = numSubjects;
+			slot->numMarkers = numMarkers;
+
+			// End write: even seq, then announce the slot
+			slot->seq.store(seq + 2, std::memory_order_release);
+			this->header->written.store(written + 1, std::memory_order_release);
+
+			if(IsTruncated && ! this->HasWarnedCapacity)
+			{
+				this->HasWarnedCapacity = true;
+				std::cout << "WARNING_VDS: (ShmPublisher) Frame exceeds maxSubjects or maxMarkers of " << this->settings.name << ". The extra objects are not published" << std::endl;
+			}
+		}
+
+		//********************************************************************************
+		// Interface: Get
+		//****************************************
+		const vdsi::ShmSettings& Settings() const { return this->settings; }
+
+	private:
+		vdsi::shm::SlotHeader* Slot(uint32_t idx)
+		{
+			return reinterpret_cast<vdsi::shm::SlotHeader*>(this->base + sizeof(vdsi::shm::Header) + idx * this->slotBytes);
+		}
+
+		// PURPOSE: If a publisher that crashed left the memory behind, tell its readers
+		void MarkOldPublisherDead()
+		{
+#if ! defined(_WIN32)
+			int fd = ::shm_open(this->settings.name.c_str(), O_RDWR, 0);
+			if(fd < 0) { return; }
+			struct stat info;
+			if(::fstat(fd, &info) == 0 && size_t(info.st_size) >= sizeof(vdsi::shm::Header))
+			{
+				void* mapped = ::mmap(nullptr, sizeof(vdsi::shm::Header), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+				if(mapped != MAP_FAILED)
+				{
+					static_cast<vdsi::shm::Header*>(mapped)->IsAlive.store(0, std::memory_order_release);
+					::munmap(mapped, sizeof(vdsi::shm::Header));
+				}
+			}
+			::close(fd);
+#endif
+		}
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Reads frames from shared memory
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Needs only this header and VDS_Points.h (not the Vicon DataStream SDK)
+	// One reader per thread
+	class ShmReader
+	{
+	private:
+		std::string name;
+		size_t totalBytes = 0;
+		const unsigned char* base = nullptr;
+		const vdsi::shm::Header* header = nullptr;
+
+		// Frames published when this reader last took one
+		uint64_t lastRead = 0;
+
+		// Tries of Visit() (each yields when the slot is being written)
+		static constexpr unsigned int MaxAttempts_Newest = 100;
+		static constexpr unsigned int MaxAttempts = 200;
+
+		// Frame being read by TryGetFrame(). Swapped into the caller's frame once the read is known not torn
+		vdsi::Points scratch;
+
+	public:
+		//********************************************************************************
+		// Interface: Create
+		//****************************************
+		// INPUT: name = ShmSettings::name of the publisher
+		ShmReader(std::string name_in = vdsi::ShmSettings().name) :
+			name(name_in)
+		{
+			// Nothing to do
+		}
+
+		ShmReader(const ShmReader&) = delete;
+		ShmReader& operator=(const ShmReader&) = delete;
+
+		~ShmReader() { this->Close(); }
+
+		// PURPOSE: Map the shared memory
+		// OUTPUT: false if there is no publisher (yet)
+		bool Open()
+		{
+#if defined(_WIN32)
+			throw std::runtime_error("ERROR_VDS: (ShmReader) Shared memory needs POSIX shared memory (Linux, macOS)");
+#else
+			this->Close();
+			int fd = ::shm_open(this->name.c_str(), O_RDONLY, 0);
+			if(fd < 0) { return false; }
+			struct stat info;
+			if(::fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(vdsi::shm::Header)) { ::close(fd); return false; }
+			void* mapped = ::mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+			::close(fd);
+			if(mapped == MAP_FAILED) { return false; }
+			this->base = static_cast<const unsigned char*>(mapped);
+			this->header = reinterpret_cast<const vdsi::shm::Header*>(this->base);
+			this->totalBytes = size_t(info.st_size);
+
+			// Validate layout (the publisher may still be initialising it => not alive yet)
+			if(this->header->IsAlive.load(std::memory_order_acquire) == 0) { this->Close(); return false; }
+			auto& h = *this->header;
+			if(h.magic != vdsi::shm::Magic || h.version != vdsi::shm::Version)
+			{
+				this->Close();
+				throw std::runtime_error("ERROR_VDS: (ShmReader) " + this->name + " was written by a different version of VDS_SharedMemory.h");
+			}
+			if(h.headerBytes != sizeof(vdsi::shm::Header) || h.nameBytes != vdsi::shm::NameBytes || h.numSlots < 2
+				|| h.slotBytes != vdsi::shm::SlotBytes(h.maxSubjects, h.maxMarkers)
+				|| this->totalBytes < sizeof(vdsi::shm::Header) + size_t(h.numSlots) * h.slotBytes)
+			{
+				this->Close();
+				throw std::runtime_error("ERROR_VDS: (ShmReader) Invalid layout of " + this->name);
+			}
+			this->lastRead = 0;
+			return true;
+#endif
+		}
+
+		// PURPOSE: Unmap the shared memory
+		void Close()
+		{
+#if ! defined(_WIN32)
+			if(this->base) { ::munmap(const_cast<unsigned char*>(this->base), this->totalBytes); }
+#endif
+			this->base = nullptr;
+			this->header = nullptr;
+		}
+
+		//********************************************************************************
+		// Interface: Get
+		//****************************************
+		// OUTPUT: true while open, and the publisher has not closed
+		//	After the publisher restarts, Open() again to find the new one
+		bool IsAlive() const
+		{
+			return this->header && this->header->IsAlive.load(std::memory_order_acquire) != 0;
+		}
+
+		// OUTPUT: true if a frame was published since the last read
+		bool HasNewFrame() const
+		{
+			return this->header && this->header->written.load(std::memory_order_acquire) != this->lastRead;
+		}
+
+		// PURPOSE:
+		//	Read the latest frame in place (zero copy)
+		//	visit(const vdsi::shm::SlotView&) is called on the slot, which the writer may overwrite meanwhile
+		//	The read is then validated. If torn, visit is called again on the new latest frame
+		//		=> visit must only read, and must not act on what it read until this returns true (e.g. copy into locals)
+		//	A publisher that stops part way through a frame (e.g. crashed) leaves that slot odd for good
+		//		=> after MaxAttempts_Newest tries, the frame before it is read instead. After MaxAttempts, the read ends (false)
+		// OUTPUT: false if no frame has been published, the publisher has closed, or no frame could be read
+		template<class Visitor>
+		bool Visit(Visitor&& visit)
+		{
+			for(unsigned int attempt = 0; attempt < MaxAttempts; ++attempt)
+			{
+				if( ! this->IsAlive() ) { return false; }
+				uint64_t written = this->header->written.load(std::memory_order_acquire);
+				if(written == 0) { return false; }
+				uint64_t idxFrame = (attempt < MaxAttempts_Newest || written < 2) ? written - 1 : written - 2;
+				auto slot = this->Slot(uint32_t(idxFrame % this->header->numSlots));
+
+				uint64_t seq0 = slot->seq.load(std::memory_order_acquire);
+				if(seq0 & 1) { std::this_thread::yield(); continue; } // Lapped: being rewritten
+
+				vdsi::shm::SlotView view;
+				view.header = slot;
+				view.subjects = reinterpret_cast<const vdsi::shm::Subject*>(slot + 1);
+				view.markers = reinterpret_cast<const vdsi::shm::Marker*>(view.subjects + this->header->maxSubjects);
+				if(slot->numSubjects > this->header->maxSubjects || slot->numMarkers > this->header->maxMarkers) { std::this_thread::yield(); continue; } // Torn
+				visit(static_cast<const vdsi::shm::SlotView&>(view));
+
+				// The acquire fence keeps the reads above from moving after the check of seq
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if(slot->seq.load(std::memory_order_relaxed) == seq0)
+				{
+					this->lastRead = written;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// PURPOSE: Copy the latest frame into frame (reusing its storage, as VDS_Interface::GetFrame(frame) does)
+		// OUTPUT:
+		//	frame = latest frame. Objects have no handle (handles are local to the publishing process)
+		//	return = false if no frame has been published, the publisher has closed, or the frame could not be read without tearing (see Visit). frame is then unchanged
+		bool TryGetFrame(vdsi::Points& frame)
+		{
+			// The visitor may run on a slot being overwritten => read into scratch, as the caller's frame must stay unchanged on failure
+			//	Swapping keeps the storage of both, so neither allocates after the first few frames
+			vdsi::Points& read = this->scratch;
+			bool wasSuccessful = this->Visit([&](const vdsi::shm::SlotView& view) {
+				read.BeginRefill(unsigned(view.header->frameNumber));
+				uint32_t numMarkers = view.header->numMarkers;
+				for(uint32_t idxS = 0; idxS < view.header->numSubjects; ++idxS)
+				{
+					auto& subject = view.subjects[idxS];
+					vdsi::RotationMatrix R;
+					vdsi::Translation P;
+					std::memcpy(R.data(), subject.R_rowMajor, sizeof(subject.R_rowMajor));
+					std::memcpy(P.data(), subject.P, sizeof(subject.P));
+					auto& point = read.RefillNext();
+					point.Reset(vdsi::shm::ReadName(subject.name), R, P, subject.IsOccluded != 0);
+
+					// Bounds are checked, as a torn read may hold anything
+					uint32_t markerEnd = std::min(numMarkers, subject.markerBegin + std::min(subject.numMarkers, numMarkers));
+					for(uint32_t idxM = subject.markerBegin; idxM < markerEnd; ++idxM)
+					{
+						auto& marker = view.markers[idxM];
+						vdsi::Translation markerP;
+						std::memcpy(markerP.data(), marker.P, sizeof(marker.P));
+						point.AddMarker(vdsi::Point_Marker(vdsi::shm::ReadName(marker.name), markerP, marker.IsOccluded != 0));
+					}
+				}
+				read.EndRefill();
+				read.timing.latencySDK = view.header->latencySDK;
+				read.timing.tReceived = vdsi::shm::FromNs(view.header->tReceivedNs);
+				read.timing.tDecoded = vdsi::shm::FromNs(view.header->tDecodedNs);
+				read.timing.tPickup = vdsi::FrameTiming::Clock::now();
+			});
+			if(wasSuccessful) { std::swap(frame, this->scratch); }
+			return wasSuccessful;
+		}
+
+		// PURPOSE: Same as TryGetFrame(), but waits (spin then yield) for a frame newer than the last read
+		// INPUT: timeout = longest wait
+		// OUTPUT: false on timeout, if the publisher has closed, or if the frame could not be read (see Visit)
+		bool GetFrame_WaitForNew(vdsi::Points& frame, std::chrono::nanoseconds timeout = std::chrono::seconds(1))
+		{
+			auto tEnd = vdsi::FrameTiming::Clock::now() + timeout;
+			for(unsigned int spins = 0; ! this->HasNewFrame(); ++spins)
+			{
+				if( ! this->IsAlive() || vdsi::FrameTiming::Clock::now() > tEnd ) { return false; }
+				if(spins > 1000) { std::this_thread::yield(); }
+			}
+			return this->TryGetFrame(frame);
+		}
+
+	private:
+		const vdsi::shm::SlotHeader* Slot(uint32_t idx) const
+		{
+			return reinterpret_cast<const vdsi::shm::SlotHeader*>(this->base + sizeof(vdsi::shm::Header) + size_t(idx) * this->header->slotBytes);
+		}
+	};
+}
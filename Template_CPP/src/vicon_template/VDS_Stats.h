@@ -0,0 +1,191 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Cheap latency statistics that can be left on in production
+
+Class Summary:
+	Histogram
+		Log-linear histogram of durations in nanoseconds (~12% resolution, 1 ns to ~584 years)
+		Add() is a few relaxed atomic operations => safe and cheap from any thread
+
+	RollingHistogram
+		Two Histograms used alternately, so that statistics cover the most recent 1-2 windows of samples
+
+	HistogramSummary
+		Count, p50, p99, max of a histogram
+
+*/
+#pragma once
+
+// Standard library
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <bit>
+#include <cmath>
+
+
+namespace vdsi
+{
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Summary of a histogram [ns]
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	struct HistogramSummary
+	{
+		uint64_t count = 0;
+		double p50 = std::numeric_limits<double>::quiet_NaN();
+		double p99 = std::numeric_limits<double>::quiet_NaN();
+		double max = std::numeric_limits<double>::quiet_NaN();
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Log-linear histogram of durations
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Buckets: values < 8 get their own bucket
+	//	Each power of 2 above that is split into 8 linear sub-buckets
+	class Histogram
+	{
+	public:
+		static constexpr int SubBucketBits = 3;
+		static constexpr int SubBuckets = 1 << SubBucketBits;
+		static constexpr int NumBuckets = (64 - SubBucketBits + 1) * SubBuckets;
+
+	private:
+		std::array<std::atomic<uint32_t>, NumBuckets> buckets{};
+		std::atomic<uint64_t> count = 0;
+		std::atomic<uint64_t> maxValue = 0;
+
+		static int BucketOf(uint64_t value)
+		{
+			if(value < SubBuckets) { return int(value); }
+			int msb = 63 - std::countl_zero(value);
+			int shift = msb - SubBucketBits;
+			return (shift + 1) * SubBuckets + int((value >> shift) & (SubBuckets - 1));
+		}
+
+		// OUTPUT: Middle of the range of values that fall in the bucket
+		static double BucketMiddle(int bucket)
+		{
+			if(bucket < SubBuckets) { return double(bucket); }
+			int shift = bucket / SubBuckets - 1;
+			uint64_t lower = uint64_t(SubBuckets + bucket % SubBuckets) << shift;
+			return double(lower) + double(uint64_t(1) << shift) / 2.0;
+		}
+
+	public:
+		//********************************************************************************
+		// Interface: Set
+		//****************************************
+		// INPUT: Duration [ns]. Negative values are counted as 0
+		void Add(double ns)
+		{
+			uint64_t value = ns > 0 ? uint64_t(ns) : 0;
+			this->buckets[BucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+			this->count.fetch_add(1, std::memory_order_relaxed);
+
+			uint64_t previousMax = this->maxValue.load(std::memory_order_relaxed);
+			while(value > previousMax && ! this->maxValue.compare_exchange_weak(previousMax, value, std::memory_order_relaxed)) { }
+		}
+
+		void Clear()
+		{
+			for(auto& bucket : this->buckets) { bucket.store(0, std::memory_order_relaxed); }
+			this->count.store(0, std::memory_order_relaxed);
+			this->maxValue.store(0, std::memory_order_relaxed);
+		}
+
+		//********************************************************************************
+		// Interface: Get
+		//****************************************
+		uint64_t Count() const { return this->count.load(std::memory_order_relaxed); }
+		uint64_t Max() const { return this->maxValue.load(std::memory_order_relaxed); }
+
+		// OUTPUT: Number of samples in the bucket
+		uint32_t BucketCount(int bucket) const { return this->buckets[bucket].load(std::memory_order_relaxed); }
+
+		// PURPOSE: Summarise one or more histograms (merged)
+		template<size_t N>
+		static vdsi::HistogramSummary Summarise(const std::array<const Histogram*, N>& histograms)
+		{
+			vdsi::HistogramSummary summary;
+			uint64_t maxValue = 0;
+			for(auto histogram : histograms)
+			{
+				for(int bucket = 0; bucket < NumBuckets; ++bucket) { summary.count += histogram->BucketCount(bucket); }
+				if(histogram->Count() > 0 && histogram->Max() > maxValue) { maxValue = histogram->Max(); }
+			}
+			if(summary.count == 0) { return summary; }
+
+			// Walk the buckets until reaching each percentile
+			uint64_t rank50 = (summary.count * 50 + 99) / 100;
+			uint64_t rank99 = (summary.count * 99 + 99) / 100;
+			uint64_t seen = 0;
+			for(int bucket = 0; bucket < NumBuckets; ++bucket)
+			{
+				uint64_t inBucket = 0;
+				for(auto histogram : histograms) { inBucket += histogram->BucketCount(bucket); }
+				if(inBucket == 0) { continue; }
+
+				seen += inBucket;
+				if(std::isnan(summary.p50) && seen >= rank50) { summary.p50 = BucketMiddle(bucket); }
+				if(std::isnan(summary.p99) && seen >= rank99) { summary.p99 = BucketMiddle(bucket); break; }
+			}
+
+			// Bucket middles can exceed the true maximum
+			summary.max = double(maxValue);
+			if(summary.p50 > summary.max) { summary.p50 = summary.max; }
+			if(summary.p99 > summary.max) { summary.p99 = summary.max; }
+			return summary;
+		}
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Histogram of the most recent samples
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// When the active histogram has windowSize samples, the older one is cleared and becomes active
+	//	=> Summary covers the last windowSize to 2*windowSize samples
+	class RollingHistogram
+	{
+	private:
+		std::array<vdsi::Histogram, 2> histograms;
+		std::atomic<int> active = 0;
+		std::atomic<bool> IsRotating = false;
+		uint64_t windowSize;
+
+	public:
+		// INPUT: windowSize = number of samples per window
+		explicit RollingHistogram(uint64_t windowSize_in = 1000) : windowSize(windowSize_in) { }
+
+		// INPUT: Duration [ns]
+		void Add(double ns)
+		{
+			int idx = this->active.load(std::memory_order_relaxed);
+			this->histograms[idx].Add(ns);
+			if(this->histograms[idx].Count() >= this->windowSize && ! this->IsRotating.exchange(true))
+			{
+				// Only one thread rotates. Samples added to the old window by other threads meanwhile are harmless
+				this->histograms[1 - idx].Clear();
+				this->active.store(1 - idx, std::memory_order_relaxed);
+				this->IsRotating = false;
+			}
+		}
+
+		void Clear()
+		{
+			this->histograms[0].Clear();
+			this->histograms[1].Clear();
+		}
+
+		vdsi::HistogramSummary Summary() const
+		{
+			return vdsi::Histogram::Summarise(std::array<const vdsi::Histogram*, 2>{ &this->histograms[0], &this->histograms[1] });
+		}
+	};
+}
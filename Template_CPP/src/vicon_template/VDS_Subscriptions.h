@@ -0,0 +1,409 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Push frames to callbacks, rather than each consumer polling GetFrame() for its own copy
+	Used through VDS_Interface::Subscribe()
+
+Class Summary:
+	FrameDispatcher
+		Holds the subscribers, and calls them for each new frame
+		Inline subscribers are called on the update thread, with the frame being published (no copy)
+			Fastest, but a slow callback delays every frame
+		Dispatched subscribers are called on a small pool of worker threads
+			Each frame is copied once into a shared read-only snapshot, however many subscribers there are
+			Each subscriber has its own bounded backlog: when full, its oldest frame is dropped and counted
+			=> a slow subscriber falls behind on its own, and cannot delay the update thread or the other subscribers
+			Frames reach each subscriber in order, one callback at a time
+
+*/
+#pragma once
+
+// Brandon's VDS Interface helpers
+#include "VDS_Points.h"
+#include "VDS_Stats.h"
+#include "VDS_FrameHandoff.h"
+
+// Program output
+#include <iostream>
+
+// Standard library
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+
+namespace vdsi
+{
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Subscription types
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Callbacks receive a read-only view of the frame, valid only until the callback returns
+	//	Copy what is needed to keep it longer
+	using FrameCallback = std::function<void(const vdsi::Points& frame)>;
+	using SubjectCallback = std::function<void(const vdsi::Points& frame, const vdsi::Point_Object& point)>;
+	using SubscriptionId = uint64_t;
+
+	enum class CallbackMode
+	{
+		Inline,    // On the update thread, before the frame is published to GetFrame()
+		Dispatched // On the dispatcher worker threads
+	};
+
+	struct SubscriptionSettings
+	{
+		// Where the callback runs
+		// Dispatched only: most frames waiting for this subscriber. When full, the oldest is dropped
+		vdsi::CallbackMode mode = vdsi::CallbackMode::Dispatched;
+		size_t backlogMax = 4;
+	};
+
+	// Statistics of one subscriber (see VDS_Interface::GetSubscriberStats)
+	struct SubscriberStats
+	{
+		// Frames passed to the callback
+		// Frames dropped because the backlog was full (Dispatched only)
+		// Largest number of frames waiting at once (Dispatched only)
+		// Exceptions thrown by the callback (caught and counted)
+		uint64_t framesDelivered = 0;
+		uint64_t framesDropped = 0;
+		uint64_t maxBacklog = 0;
+		uint64_t exceptions = 0;
+
+		// Time [ns] spent in the callback, and from the frame being decoded until the callback started
+		vdsi::HistogramSummary callback;
+		vdsi::HistogramSummary delay;
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Calls the subscribers for each new frame
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Publish() is called by one thread (the update thread). Everything else is thread safe
+	class FrameDispatcher
+	{
+	private:
+		struct Subscriber
+		{
+			vdsi::SubscriptionId id = 0;
+			vdsi::SubscriptionSettings settings;
+
+			// Either all frames, or only frames with these subjects
+			vdsi::FrameCallback onFrame;
+			vdsi::SubjectCallback onSubject;
+			std::vector<vdsi::SubjectHandle> subjects;
+
+			// Frames waiting for this subscriber, and whether it is in the ready queue (guarded by mtx_Queue)
+			std::deque<std::shared_ptr<const vdsi::Points>> pending;
+			bool IsScheduled = false;
+
+			// Held while the callback runs, so that Unsubscribe() can wait for it to finish
+			std::mutex mtx_Callback;
+			bool IsActive = true;
+
+			// Statistics
+			std::atomic<uint64_t> framesDelivered = 0;
+			std::atomic<uint64_t> framesDropped = 0;
+			std::atomic<uint64_t> maxBacklog = 0;
+			std::atomic<uint64_t> exceptions = 0;
+			vdsi::RollingHistogram stats_Callback;
+			vdsi::RollingHistogram stats_Delay;
+		};
+		using SubscriberList = std::vector<std::shared_ptr<Subscriber>>;
+
+		// Subscribers, swapped as a whole when one is added or removed
+		//	=> Publish() reads the list without taking a lock
+		std::atomic<std::shared_ptr<const SubscriberList>> Subscribers;
+		std::mutex mtx_Subscribers;
+		vdsi::SubscriptionId NextId = 1;
+
+		// Worker threads, started by the first Dispatched subscription
+		//	Subscribers with pending frames wait in Ready. Each takes one frame per turn, so all subscribers get a fair share
+		std::vector<std::thread> Workers;
+		size_t NumWorkers = 2;
+		std::mutex mtx_Queue;
+		std::condition_variable cv_Queue;
+		std::deque<std::shared_ptr<Subscriber>> Ready;
+		bool IsStopping = false;
+
+		// Snapshots of recent frames for Dispatched subscribers (only accessed by Publish)
+		vdsi::SnapshotPool<vdsi::Points> Snapshots;
+
+	public:
+		//********************************************************************************
+		// Interface: Constructor / Destructor
+		//****************************************
+		FrameDispatcher() = default;
+		FrameDispatcher(const FrameDispatcher&) = delete;
+		FrameDispatcher& operator=(const FrameDispatcher&) = delete;
+
+		~FrameDispatcher()
+		{
+			{
+				std::lock_guard<std::mutex> lock(this->mtx_Queue);
+				this->IsStopping = true;
+			}
+			this->cv_Queue.notify_all();
+			for(auto& worker : this->Workers) { worker.join(); }
+		}
+
+		//********************************************************************************
+		// Interface: Settings
+		//****************************************
+		// INPUT: numWorkers = threads that run Dispatched callbacks. Set before the first Dispatched subscription
+		void SetNumWorkers(size_t numWorkers)
+		{
+			std::lock_guard<std::mutex> lock(this->mtx_Subscribers);
+			if( ! this->Workers.empty() ) { throw std::runtime_error("ERROR_VDS: Set the dispatcher threads before the first subscription"); }
+			if(numWorkers == 0) { throw std::runtime_error("ERROR_VDS: The dispatcher needs at least 1 thread"); }
+			this->NumWorkers = numWorkers;
+		}
+
+		//********************************************************************************
+		// Interface: Subscribe
+		//****************************************
+		// INPUT:
+		//	onFrame = called with every frame
+		//	subjects + onSubject = called once per listed subject in the frame. Frames without any of the subjects are skipped
+		// OUTPUT: Id to pass to Unsubscribe()
+		vdsi::SubscriptionId Subscribe(vdsi::FrameCallback onFrame, const vdsi::SubscriptionSettings& settings)
+		{
+			auto subscriber = std::make_shared<Subscriber>();
+			subscriber->onFrame = std::move(onFrame);
+			return this->Add(subscriber, settings);
+		}
+
+		vdsi::SubscriptionId Subscribe(std::vector<vdsi::SubjectHandle> subjects, vdsi::SubjectCallback onSubject, const vdsi::SubscriptionSettings& settings)
+		{
+			auto subscriber = std::make_shared<Subscriber>();
+			subscriber->subjects = std::move(subjects);
+			subscriber->onSubject = std::move(onSubject);
+			return this->Add(subscriber, settings);
+		}
+
+		// PURPOSE:
+		//	Stop calling the subscriber. Frames waiting for it are discarded
+		//	Waits for a callback in progress to finish => Don't call from within the subscriber's own callback
+		// OUTPUT: false if there was no such subscription
+		bool Unsubscribe(vdsi::SubscriptionId id)
+		{
+			std::shared_ptr<Subscriber> removed;
+			{
+				std::lock_guard<std::mutex> lock(this->mtx_Subscribers);
+				auto subscribers = this->Subscribers.load();
+				if( ! subscribers ) { return false; }
+
+				auto next = std::make_shared<SubscriberList>();
+				for(auto& subscriber : *subscribers)
+				{
+					if(subscriber->id == id) { removed = subscriber; }
+					else { next->push_back(subscriber); }
+				}
+				if( ! removed ) { return false; }
+				this->Subscribers = std::shared_ptr<const SubscriberList>(std::move(next));
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(this->mtx_Queue);
+				removed->pending.clear();
+			}
+			std::lock_guard<std::mutex> lock(removed->mtx_Callback);
+			removed->IsActive = false;
+			return true;
+		}
+
+		//********************************************************************************
+		// Interface: Get
+		//****************************************
+		// OUTPUT: Statistics of the subscriber (all zero if there is no such subscription)
+		vdsi::SubscriberStats Stats(vdsi::SubscriptionId id) const
+		{
+			vdsi::SubscriberStats stats;
+			auto subscribers = this->Subscribers.load();
+			if( ! subscribers ) { return stats; }
+			for(auto& subscriber : *subscribers)
+			{
+				if(subscriber->id != id) { continue; }
+				stats.framesDelivered = subscriber->framesDelivered;
+				stats.framesDropped = subscriber->framesDropped;
+				stats.maxBacklog = subscriber->maxBacklog;
+				stats.exceptions = subscriber->exceptions;
+				stats.callback = subscriber->stats_Callback.Summary();
+				stats.delay = subscriber->stats_Delay.Summary();
+			}
+			return stats;
+		}
+
+		//********************************************************************************
+		// Interface: Publish (update thread)
+		//****************************************
+		// PURPOSE: Call the Inline subscribers, and hand the frame to the Dispatched subscribers
+		void Publish(const vdsi::Points& frame)
+		{
+			auto subscribers = this->Subscribers.load();
+			if( ! subscribers || subscribers->empty() ) { return; }
+
+			std::shared_ptr<const vdsi::Points> snapshot;
+			for(auto& subscriber : *subscribers)
+			{
+				if( ! IsWanted(*subscriber, frame) ) { continue; }
+				if(subscriber->settings.mode == vdsi::CallbackMode::Inline)
+				{
+					Invoke(*subscriber, frame);
+					continue;
+				}
+
+				// One snapshot per frame, shared by all Dispatched subscribers
+				if( ! snapshot ) { snapshot = this->Snapshots.Take(frame); }
+				this->Post(subscriber, snapshot);
+			}
+		}
+
+	private:
+		//********************************************************************************
+		// Helper functions
+		//****************************************
+		vdsi::SubscriptionId Add(std::shared_ptr<Subscriber> subscriber, const vdsi::SubscriptionSettings& settings)
+		{
+			if(settings.mode == vdsi::CallbackMode::Dispatched && settings.backlogMax == 0) { throw std::runtime_error("ERROR_VDS: Subscription backlogMax must be > 0"); }
+
+			std::lock_guard<std::mutex> lock(this->mtx_Subscribers);
+			subscriber->id = this->NextId++;
+			subscriber->settings = settings;
+
+			if(settings.mode == vdsi::CallbackMode::Dispatched && this->Workers.empty())
+			{
+				for(size_t idx = 0; idx < this->NumWorkers; ++idx) { this->Workers.emplace_back([this] { this->WorkerLoop(); }); }
+			}
+
+			auto subscribers = this->Subscribers.load();
+			auto next = subscribers ? std::make_shared<SubscriberList>(*subscribers) : std::make_shared<SubscriberList>();
+			next->push_back(subscriber);
+			this->Subscribers = std::shared_ptr<const SubscriberList>(std::move(next));
+			return subscriber->id;
+		}
+
+		static bool IsWanted(const Subscriber& subscriber, const vdsi::Points& frame)
+		{
+			if(subscriber.onFrame) { return true; }
+			for(auto& handle : subscriber.subjects)
+			{
+				if(frame.Find(handle)) { return true; }
+			}
+			return false;
+		}
+
+		static void Invoke(Subscriber& subscriber, const vdsi::Points& frame)
+		{
+			std::lock_guard<std::mutex> lock(subscriber.mtx_Callback);
+			if( ! subscriber.IsActive ) { return; }
+
+			auto t0 = vdsi::FrameTiming::Clock::now();
+			try
+			{
+				if(subscriber.onFrame) { subscriber.onFrame(frame); }
+				else
+				{
+					for(auto& handle : subscriber.subjects)
+					{
+						const vdsi::Point_Object* point = frame.Find(handle);
+						if(point) { subscriber.onSubject(frame, *point); }
+					}
+				}
+			}
+			catch(const std::exception& e)
+			{
+				if(subscriber.exceptions++ == 0) { std::cout << "WARNING_VDS: (Subscriber " << subscriber.id << ") Callback threw: " << e.what() << std::endl; }
+			}
+			catch(...)
+			{
+				if(subscriber.exceptions++ == 0) { std::cout << "WARNING_VDS: (Subscriber " << subscriber.id << ") Callback threw" << std::endl; }
+			}
+
+			// Statistics
+			subscriber.framesDelivered++;
+			subscriber.stats_Callback.Add(std::chrono::duration<double, std::nano>(vdsi::FrameTiming::Clock::now() - t0).count());
+			subscriber.stats_Delay.Add(std::chrono::duration<double, std::nano>(t0 - frame.timing.tDecoded).count());
+		}
+
+		void Post(const std::shared_ptr<Subscriber>& subscriber, const std::shared_ptr<const vdsi::Points>& snapshot)
+		{
+			bool IsNewlyReady = false;
+			{
+				std::lock_guard<std::mutex> lock(this->mtx_Queue);
+
+				// Full => this subscriber loses its oldest frame. Nobody else waits
+				if(subscriber->pending.size() >= subscriber->settings.backlogMax)
+				{
+					subscriber->pending.pop_front();
+					subscriber->framesDropped++;
+				}
+				subscriber->pending.push_back(snapshot);
+				if(subscriber->pending.size() > subscriber->maxBacklog) { subscriber->maxBacklog = subscriber->pending.size(); }
+
+				if( ! subscriber->IsScheduled )
+				{
+					subscriber->IsScheduled = true;
+					this->Ready.push_back(subscriber);
+					IsNewlyReady = true;
+				}
+			}
+			if(IsNewlyReady) { this->cv_Queue.notify_one(); }
+		}
+
+		void WorkerLoop()
+		{
+			while(true)
+			{
+				// Take the next subscriber in line, and its oldest frame
+				std::shared_ptr<Subscriber> subscriber;
+				std::shared_ptr<const vdsi::Points> frame;
+				{
+					std::unique_lock<std::mutex> lock(this->mtx_Queue);
+					this->cv_Queue.wait(lock, [this] { return this->IsStopping || ! this->Ready.empty(); });
+					if(this->IsStopping) { return; }
+
+					subscriber = std::move(this->Ready.front());
+					this->Ready.pop_front();
+					if(subscriber->pending.empty())
+					{
+						// Unsubscribed meanwhile
+						subscriber->IsScheduled = false;
+						continue;
+					}
+					frame = std::move(subscriber->pending.front());
+					subscriber->pending.pop_front();
+				}
+
+				Invoke(*subscriber, *frame);
+				frame.reset();
+
+				// More frames => back of the line, so that the other subscribers get a turn
+				bool IsStillReady = false;
+				{
+					std::lock_guard<std::mutex> lock(this->mtx_Queue);
+					if(subscriber->pending.empty()) { subscriber->IsScheduled = false; }
+					else
+					{
+						this->Ready.push_back(subscriber);
+						IsStillReady = true;
+					}
+				}
+				if(IsStillReady) { this->cv_Queue.notify_one(); }
+			}
+		}
+	};
+}
@@ -0,0 +1,737 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Re-broadcast decoded frames over UDP (multicast or unicast), so that other computers need no connection to the Vicon PC
+		One computer holds the Vicon connection (VDS_Interface::EnableUdpRelay)
+		Any number of computers receive the frames (UdpReceiver), without the Vicon DataStream SDK
+		=> the load on the Vicon PC does not grow with the number of computers
+
+	Frames are sent after the filters, as GetFrame() returns them
+	A frame is split into as many datagrams as needed to stay under maxDatagramBytes (no IP fragmentation)
+		Whole subjects per datagram. The receiver rebuilds the frame once all its datagrams have arrived
+		A subject too large for one datagram on its own (many markers) is sent with only the markers that fit
+			=> warned once, and the markers left out are counted (UdpRelayStats::markersDropped)
+	The sender never waits: if the socket buffer is full, the datagram is dropped and counted
+
+Datagram format (little endian, version 1):
+	Header (48 bytes)
+		uint32		magic "VDSU"
+		uint16		version
+		uint16		flags: 1 = double precision, 2 = has markers
+		uint64		sequence number (of datagrams, +1 per datagram sent) => the receiver counts lost datagrams
+		uint64		frame number
+		int64		capture time, sender's system clock [ns since 1970] (estimated: see FrameTiming::tCaptured)
+		int64		send time, sender's system clock [ns since 1970]
+		uint16		index of this datagram in the frame
+		uint16		number of datagrams of the frame
+		uint16		number of subjects in this datagram
+		uint16		(zero)
+	Subjects, repeated
+		uint8		name length, then the name (up to 255 characters)
+		uint8		1 = occluded (then no pose follows)
+		pose		float:  P[3], quaternion (x,y,z,w) [4]		=  28 bytes
+					double: R_rowMajor[9], P[3]					=  96 bytes
+		(has markers only)
+		uint16		number of markers, then for each marker
+			uint8		name length, then the name
+			uint8		1 = occluded (then no position follows)
+			float or double		P[3]
+
+	Float precision: ~0.001 mm at 10 m, ~1e-7 in the rotation (finer than Vicon's own noise)
+
+Class Summary:
+	UdpRelaySettings, UdpRelay
+		Sender (used by the update thread of VDS_Interface)
+
+	UdpReceiverSettings, UdpReceiver
+		Receiver. Needs only this header and VDS_Points.h (not the Vicon DataStream SDK)
+
+*/
+#pragma once
+
+// Brandon's VDS Interface helpers
+#include "VDS_Points.h"
+#include "VDS_PoseKernels.h"
+
+// Standard library
+#include <iostream>
+#include <string>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+
+// Sockets
+#if defined(_WIN32)
+	#include <winsock2.h>
+	#include <ws2tcpip.h>
+#else
+	#include <sys/socket.h>
+	#include <sys/select.h>
+	#include <netinet/in.h>
+	#include <arpa/inet.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <cerrno>
+#endif
+
+
+namespace vdsi
+{
+	namespace udp
+	{
+		inline constexpr uint32_t Magic = 0x55534456; // "VDSU"
+		inline constexpr uint16_t Version = 1;
+		inline constexpr uint16_t Flag_DoublePrecision = 1;
+		inline constexpr uint16_t Flag_HasMarkers = 2;
+		inline constexpr size_t HeaderBytes = 48;
+		inline constexpr size_t MaxDatagramBytes = 65507; // Largest UDP payload over IPv4
+
+		// Largest subject without markers: name, occluded flag, double pose, marker count
+		//	=> any subject fits in one datagram once its markers are left out
+		inline constexpr size_t MaxSubjectBytes_NoMarkers = 256 + 1 + 96 + 2;
+
+		//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+		// Little endian encoding
+		//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+		class Writer
+		{
+		public:
+			std::vector<unsigned char>& bytes;
+
+			explicit Writer(std::vector<unsigned char>& bytes_in) : bytes(bytes_in) { }
+
+			template<class UInt>
+			void PutUInt(UInt value)
+			{
+				for(size_t idx = 0; idx < sizeof(UInt); ++idx) { this->bytes.push_back((unsigned char)(value >> (8 * idx))); }
+			}
+			void PutInt64(int64_t value) { this->PutUInt(uint64_t(value)); }
+			void PutFloat(double value) { this->PutUInt(std::bit_cast<uint32_t>(float(value))); }
+			void PutDouble(double value) { this->PutUInt(std::bit_cast<uint64_t>(value)); }
+			void PutName(const std::string& name)
+			{
+				size_t length = std::min<size_t>(name.size(), 255);
+				this->PutUInt(uint8_t(length));
+				this->bytes.insert(this->bytes.end(), name.begin(), name.begin() + length);
+			}
+		};
+
+		// Reads past the end set IsValid = false and return 0
+		class Reader
+		{
+		public:
+			const unsigned char* data;
+			size_t size;
+			size_t pos = 0;
+			bool IsValid = true;
+
+			Reader(const unsigned char* data_in, size_t size_in) : data(data_in), size(size_in) { }
+
+			template<class UInt>
+			UInt GetUInt()
+			{
+				if(this->pos + sizeof(UInt) > this->size) { this->IsValid = false; return 0; }
+				UInt value = 0;
+				for(size_t idx = 0; idx < sizeof(UInt); ++idx) { value |= UInt(this->data[this->pos + idx]) << (8 * idx); }
+				this->pos += sizeof(UInt);
+				return value;
+			}
+			int64_t GetInt64() { return int64_t(this->GetUInt<uint64_t>()); }
+			double GetFloat() { return double(std::bit_cast<float>(this->GetUInt<uint32_t>())); }
+			double GetDouble() { return std::bit_cast<double>(this->GetUInt<uint64_t>()); }
+			void GetName(std::string& name)
+			{
+				size_t length = this->GetUInt<uint8_t>();
+				if(this->pos + length > this->size) { this->IsValid = false; name.clear(); return; }
+				name.assign(reinterpret_cast<const char*>(this->data + this->pos), length);
+				this->pos += length;
+			}
+		};
+
+		//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+		// Non-blocking UDP socket (POSIX or Winsock)
+		//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+		class Socket
+		{
+		private:
+#if defined(_WIN32)
+			using Handle = SOCKET;
+			static constexpr Handle Invalid = INVALID_SOCKET;
+#else
+			using Handle = int;
+			static constexpr Handle Invalid = -1;
+#endif
+			Handle handle = Invalid;
+
+		public:
+			// PURPOSE: Open a non-blocking IPv4 UDP socket
+			Socket()
+			{
+#if defined(_WIN32)
+				WSADATA wsaData;
+				if(WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) { throw std::runtime_error("ERROR_VDS: (udp::Socket) WSAStartup failed"); }
+#endif
+				this->handle = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+				if(this->handle == Invalid) { throw std::runtime_error("ERROR_VDS: (udp::Socket) Could not open a UDP socket"); }
+#if defined(_WIN32)
+				u_long IsNonBlocking = 1;
+				::ioctlsocket(this->handle, FIONBIO, &IsNonBlocking);
+#else
+				::fcntl(this->handle, F_SETFL, ::fcntl(this->handle, F_GETFL, 0) | O_NONBLOCK);
+#endif
+			}
+
+			Socket(const Socket&) = delete;
+			Socket& operator=(const Socket&) = delete;
+
+			~Socket()
+			{
+#if defined(_WIN32)
+				::closesocket(this->handle);
+				WSACleanup();
+#else
+				::close(this->handle);
+#endif
+			}
+
+			template<class T>
+			void SetOption(int level, int name, const T& value, const char* what)
+			{
+				if(::setsockopt(this->handle, level, name, reinterpret_cast<const char*>(&value), sizeof(value)) != 0)
+				{
+					throw std::runtime_error(std::string("ERROR_VDS: (udp::Socket) Could not set ") + what);
+				}
+			}
+
+			void Bind(uint16_t port)
+			{
+				sockaddr_in address = {};
+				address.sin_family = AF_INET;
+				address.sin_addr.s_addr = htonl(INADDR_ANY);
+				address.sin_port = htons(port);
+				if(::bind(this->handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+				{
+					throw std::runtime_error("ERROR_VDS: (udp::Socket) Could not bind to port " + std::to_string(port));
+				}
+			}
+
+			// OUTPUT: false if the datagram was not sent (e.g. socket buffer full)
+			bool SendTo(const std::vector<unsigned char>& bytes, const sockaddr_in& address)
+			{
+				auto sent = ::sendto(this->handle, reinterpret_cast<const char*>(bytes.data()), int(bytes.size()), 0, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+				return sent == decltype(sent)(bytes.size());
+			}
+
+			// OUTPUT: bytes received, or -1 if none waiting
+			long Receive(unsigned char* buffer, size_t size)
+			{
+				auto received = ::recv(this->handle, reinterpret_cast<char*>(buffer), int(size), 0);
+				return received < 0 ? -1 : long(received);
+			}
+
+			// PURPOSE: Wait until a datagram can be read
+			// OUTPUT: false on timeout
+			bool WaitReadable(std::chrono::nanoseconds timeout)
+			{
+				fd_set readable;
+				FD_ZERO(&readable);
+				FD_SET(this->handle, &readable);
+				auto us = std::chrono::duration_cast<std::chrono::microseconds>(timeout).count();
+				timeval tv;
+				tv.tv_sec = long(us / 1000000);
+				tv.tv_usec = long(us % 1000000);
+				return ::select(int(this->handle + 1), &readable, nullptr, nullptr, &tv) > 0;
+			}
+		};
+
+		// PURPOSE: IPv4 address and port
+		inline sockaddr_in ToAddress(const std::string& address, uint16_t port)
+		{
+			sockaddr_in result = {};
+			result.sin_family = AF_INET;
+			result.sin_port = htons(port);
+			if(::inet_pton(AF_INET, address.c_str(), &result.sin_addr) != 1)
+			{
+				throw std::runtime_error("ERROR_VDS: (udp) Not an IPv4 address: " + address);
+			}
+			return result;
+		}
+
+		inline bool IsMulticast(const sockaddr_in& address) { return (ntohl(address.sin_addr.s_addr) >> 28) == 0xE; }
+
+		// PURPOSE: Convert a steady_clock time to the system clock [ns since 1970]
+		inline int64_t ToSystemNs(vdsi::FrameTiming::Clock::time_point t)
+		{
+			auto nowSteady = vdsi::FrameTiming::Clock::now();
+			auto nowSystem = std::chrono::system_clock::now();
+			auto tSystem = nowSystem + std::chrono::duration_cast<std::chrono::system_clock::duration>(t - nowSteady);
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(tSystem.time_since_epoch()).count();
+		}
+	}
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Sender
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	struct UdpRelaySettings
+	{
+		// Destination: a multicast group (224.0.0.0 to 239.255.255.255) or one computer
+		//	239.255.x.x is for use within an organisation
+		std::string address = "239.255.80.1";
+		uint16_t port = 51001;
+
+		// Multicast only
+		//	ttl = number of routers the datagrams may cross (1 = this subnet only)
+		//	interfaceAddress = IPv4 address of the network card to send from ("" = chosen by the OS)
+		int ttl = 1;
+		std::string interfaceAddress;
+
+		// Largest datagram [bytes]. 1400 fits in the usual Ethernet MTU of 1500
+		size_t maxDatagramBytes = 1400;
+
+		// Send markers too
+		// Send double precision R and P (96 bytes per subject) instead of float P and quaternion (28 bytes)
+		bool IncludeMarkers = false;
+		bool IsDoublePrecision = false;
+	};
+
+	struct UdpRelayStats
+	{
+		uint64_t framesSent = 0;
+		uint64_t datagramsSent = 0;
+		uint64_t datagramsDropped = 0; // Socket buffer full, or other send error
+		uint64_t markersDropped = 0;   // Left out of subjects too large for one datagram
+	};
+
+	// Frames are sent by one thread only. Stats() from any thread
+	class UdpRelay
+	{
+	private:
+		vdsi::UdpRelaySettings settings;
+		vdsi::udp::Socket socket;
+		sockaddr_in destination;
+		uint64_t sequence = 0;
+
+		// Reused every frame
+		std::vector<std::vector<unsigned char>> datagrams;
+		std::vector<uint16_t> numSubjects;
+		std::vector<unsigned char> subjectBytes;
+		std::vector<unsigned char> headerBytes;
+
+		std::atomic<uint64_t> stats_FramesSent = 0;
+		std::atomic<uint64_t> stats_DatagramsSent = 0;
+		std::atomic<uint64_t> stats_DatagramsDropped = 0;
+		std::atomic<uint64_t> stats_MarkersDropped = 0;
+		bool HasWarnedMarkersDropped = false;
+
+	public:
+		//********************************************************************************
+		// Interface: Create
+		//****************************************
+		UdpRelay(const vdsi::UdpRelaySettings& settings_in) :
+			settings(settings_in),
+			destination(vdsi::udp::ToAddress(settings_in.address, settings_in.port))
+		{
+			// Validate input
+			if(this->settings.maxDatagramBytes < vdsi::udp::HeaderBytes + vdsi::udp::MaxSubjectBytes_NoMarkers || this->settings.maxDatagramBytes > vdsi::udp::MaxDatagramBytes)
+			{
+				throw std::runtime_error("ERROR_VDS: (UdpRelay) maxDatagramBytes must be in [403, 65507]");
+			}
+
+			if(vdsi::udp::IsMulticast(this->destination))
+			{
+				int ttl = std::clamp(this->settings.ttl, 0, 255);
+				int IsLoop = 1; // Receivers on this computer (and loopback tests) get the datagrams too
+				this->socket.SetOption(IPPROTO_IP, IP_MULTICAST_TTL, ttl, "IP_MULTICAST_TTL");
+				this->socket.SetOption(IPPROTO_IP, IP_MULTICAST_LOOP, IsLoop, "IP_MULTICAST_LOOP");
+				if( ! this->settings.interfaceAddress.empty() )
+				{
+					in_addr interfaceAddress = vdsi::udp::ToAddress(this->settings.interfaceAddress, 0).sin_addr;
+					this->socket.SetOption(IPPROTO_IP, IP_MULTICAST_IF, interfaceAddress, "IP_MULTICAST_IF");
+				}
+			}
+		}
+
+		//********************************************************************************
+		// Interface: Send
+		//****************************************
+		// PURPOSE: Send one frame, in as many datagrams as needed. Never waits
+		void Send(const vdsi::Points& frame)
+		{
+			uint16_t flags = (this->settings.IsDoublePrecision ? vdsi::udp::Flag_DoublePrecision : 0) | (this->settings.IncludeMarkers ? vdsi::udp::Flag_HasMarkers : 0);
+			int64_t tCapturedNs = vdsi::udp::ToSystemNs(std::isnan(frame.timing.latencySDK) ? frame.timing.tReceived : frame.timing.tCaptured());
+
+			// Pack whole subjects into datagrams
+			size_t numDatagrams = 0;
+			auto& numSubjects = this->numSubjects;
+			numSubjects.clear();
+			auto StartDatagram = [&] {
+				if(numDatagrams == this->datagrams.size()) { this->datagrams.emplace_back(); }
+				auto& datagram = this->datagrams[numDatagrams++];
+				datagram.clear();
+				datagram.resize(vdsi::udp::HeaderBytes); // Filled in once the number of datagrams is known
+				numSubjects.push_back(0);
+			};
+			StartDatagram();
+			for(auto& point : frame.all)
+			{
+				this->subjectBytes.clear();
+				this->EncodeSubject(point);
+				auto* datagram = &this->datagrams[numDatagrams - 1];
+				if(numSubjects.back() > 0 && (datagram->size() + this->subjectBytes.size() > this->settings.maxDatagramBytes || numSubjects.back() == UINT16_MAX))
+				{
+					StartDatagram();
+					datagram = &this->datagrams[numDatagrams - 1];
+				}
+				datagram->insert(datagram->end(), this->subjectBytes.begin(), this->subjectBytes.end());
+				++numSubjects.back();
+			}
+
+			// Headers, then send
+			int64_t tSentNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+			for(size_t idx = 0; idx < numDatagrams; ++idx)
+			{
+				auto& header = this->headerBytes;
+				header.clear();
+				vdsi::udp::Writer writer(header);
+				writer.PutUInt(vdsi::udp::Magic);
+				writer.PutUInt(vdsi::udp::Version);
+				writer.PutUInt(flags);
+				writer.PutUInt(this->sequence++);
+				writer.PutUInt(uint64_t(frame.frameNumber));
+				writer.PutInt64(tCapturedNs);
+				writer.PutInt64(tSentNs);
+				writer.PutUInt(uint16_t(idx));
+				writer.PutUInt(uint16_t(numDatagrams));
+				writer.PutUInt(numSubjects[idx]);
+				writer.PutUInt(uint16_t(0));
+				std::copy(header.begin(), header.end(), this->datagrams[idx].begin());
+
+				if(this->socket.SendTo(this->datagrams[idx], this->destination)) { ++this->stats_DatagramsSent; }
+				else { ++this->stats_DatagramsDropped; }
+			}
+			++this->stats_FramesSent;
+		}
+
+		//********************************************************************************
+		// Interface: Get
+		//****************************************
+		vdsi::UdpRelayStats Stats() const
+		{
+			vdsi::UdpRelayStats stats;
+			stats.framesSent = this->stats_FramesSent;
+			stats.datagramsSent = this->stats_DatagramsSent;
+			stats.datagramsDropped = this->stats_DatagramsDropped;
+			stats.markersDropped = this->stats_MarkersDropped;
+			return stats;
+		}
+
+	private:
+		void EncodeSubject(const vdsi::Point_Object& point)
+		{
+			vdsi::udp::Writer writer(this->subjectBytes);
+			writer.PutName(point.viconObjectName);
+			writer.PutUInt(uint8_t(point.IsOccluded ? 1 : 0));
+			if( ! point.IsOccluded )
+			{
+				if(this->settings.IsDoublePrecision)
+				{
+					for(double value : point.R_rowMajor) { writer.PutDouble(value); }
+					for(double value : point.P) { writer.PutDouble(value); }
+				}
+				else
+				{
+					for(double value : point.P) { writer.PutFloat(value); }
+					for(double value : point.quat_xyzw()) { writer.PutFloat(value); }
+				}
+			}
+
+			if( ! this->settings.IncludeMarkers ) { return; }
+
+			// Markers, as many as fit in a datagram on their own (the count is filled in after)
+			size_t maxSubjectBytes = this->settings.maxDatagramBytes - vdsi::udp::HeaderBytes;
+			size_t countPosition = this->subjectBytes.size();
+			writer.PutUInt(uint16_t(0));
+			size_t numMarkers = 0;
+			for(; numMarkers < point.markers.size() && numMarkers < UINT16_MAX; ++numMarkers)
+			{
+				size_t markerPosition = this->subjectBytes.size();
+				auto& marker = point.markers[numMarkers];
+				writer.PutName(marker.viconObjectName);
+				writer.PutUInt(uint8_t(marker.IsOccluded ? 1 : 0));
+				if( ! marker.IsOccluded )
+				{
+					for(double value : marker.P)
+					{
+						if(this->settings.IsDoublePrecision) { writer.PutDouble(value); }
+						else { writer.PutFloat(value); }
+					}
+				}
+				if(this->subjectBytes.size() > maxSubjectBytes)
+				{
+					this->subjectBytes.resize(markerPosition);
+					break;
+				}
+			}
+			this->subjectBytes[countPosition] = (unsigned char)(numMarkers);
+			this->subjectBytes[countPosition + 1] = (unsigned char)(numMarkers >> 8);
+
+			if(numMarkers < point.markers.size())
+			{
+				this->stats_MarkersDropped += point.markers.size() - numMarkers;
+				if( ! this->HasWarnedMarkersDropped )
+				{
+					this->HasWarnedMarkersDropped = true;
+					std::cout << "WARNING_VDS: (UdpRelay) " << point.viconObjectName << " has too many markers for maxDatagramBytes. Markers left out are counted in UdpRelayStats::markersDropped" << std::endl;
+				}
+			}
+		}
+	};
+
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	// Receiver
+	//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+	struct UdpReceiverSettings
+	{
+		// Same address and port as UdpRelaySettings
+		//	Multicast: join this group. Unicast: receive anything sent to this port
+		std::string address = "239.255.80.1";
+		uint16_t port = 51001;
+
+		// Multicast only: IPv4 address of the network card to receive on ("" = chosen by the OS)
+		std::string interfaceAddress;
+	};
+
+	struct UdpReceiverStats
+	{
+		uint64_t framesReceived = 0;
+		uint64_t framesIncomplete = 0; // Dropped because a datagram of the frame never arrived
+		uint64_t datagramsReceived = 0;
+		uint64_t datagramsLost = 0;    // Gaps in the sequence numbers
+		uint64_t datagramsInvalid = 0; // Not of this format, or malformed
+	};
+
+	// One receiver per thread
+	class UdpReceiver
+	{
+	private:
+		vdsi::UdpReceiverSettings settings;
+		vdsi::udp::Socket socket;
+		vdsi::UdpReceiverStats stats;
+
+		bool HasSequence = false;
+		uint64_t nextSequence = 0;
+
+		// Frame being reassembled: its datagrams by index
+		bool HasPending = false;
+		uint64_t pendingFrameNumber = 0;
+		size_t pendingReceived = 0;
+		std::vector<std::vector<unsigned char>> pending;
+		std::vector<bool> IsPendingReceived;
+
+		// Last frame handed out (its late or duplicated datagrams are ignored)
+		bool HasDelivered = false;
+		uint64_t deliveredFrameNumber = 0;
+
+		std::vector<unsigned char> buffer = std::vector<unsigned char>(vdsi::udp::MaxDatagramBytes);
+
+	public:
+		//********************************************************************************
+		// Interface: Create
+		//****************************************
+		UdpReceiver(const vdsi::UdpReceiverSettings& settings_in = vdsi::UdpReceiverSettings()) :
+			settings(settings_in)
+		{
+			sockaddr_in group = vdsi::udp::ToAddress(this->settings.address, this->settings.port);
+
+			// Several receivers on one computer may share the port
+			int IsReuse = 1;
+			this->socket.SetOption(SOL_SOCKET, SO_REUSEADDR, IsReuse, "SO_REUSEADDR");
+			int receiveBufferBytes = 4 << 20;
+			try { this->socket.SetOption(SOL_SOCKET, SO_RCVBUF, receiveBufferBytes, "SO_RCVBUF"); }
+			catch(const std::runtime_error&) { } // Keep the OS default
+			this->socket.Bind(this->settings.port);
+
+			if(vdsi::udp::IsMulticast(group))
+			{
+				ip_mreq membership = {};
+				membership.imr_multiaddr = group.sin_addr;
+				membership.imr_interface.s_addr = this->settings.interfaceAddress.empty() ? htonl(INADDR_ANY) : vdsi::udp::ToAddress(this->settings.interfaceAddress, 0).sin_addr.s_addr;
+				this->socket.SetOption(IPPROTO_IP, IP_ADD_MEMBERSHIP, membership, "IP_ADD_MEMBERSHIP (join multicast group)");
+			}
+		}
+
+		//********************************************************************************
+		// Interface: Get
+		//****************************************
+		// PURPOSE: Wait for the next complete frame
+		// INPUT: timeout = longest wait
+		// OUTPUT:
+		//	frame = refilled with the frame (reusing its storage). Objects have no handle (handles are local to the sending process)
+		//		timing.tReceived = arrival of its last datagram (this computer's steady_clock)
+		//		timing.latencySDK = capture to send on the sender [s] (tCaptured() then excludes only the network delay)
+		//	return = false on timeout
+		bool Receive(vdsi::Points& frame, std::chrono::nanoseconds timeout = std::chrono::seconds(1))
+		{
+			auto tEnd = vdsi::FrameTiming::Clock::now() + timeout;
+			while(true)
+			{
+				long size = this->socket.Receive(this->buffer.data(), this->buffer.size());
+				if(size < 0)
+				{
+					auto remaining = tEnd - vdsi::FrameTiming::Clock::now();
+					if(remaining <= decltype(remaining)::zero()) { return false; }
+					this->socket.WaitReadable(remaining);
+					continue;
+				}
+				if(this->Accept(size_t(size)) && this->Assemble(frame)) { return true; }
+			}
+		}
+
+		vdsi::UdpReceiverStats Stats() const { return this->stats; }
+
+	private:
+		// PURPOSE: Check a datagram and file it with its frame
+		// OUTPUT: true if it completed the pending frame
+		bool Accept(size_t size)
+		{
+			vdsi::udp::Reader reader(this->buffer.data(), size);
+			uint32_t magic = reader.GetUInt<uint32_t>();
+			uint16_t version = reader.GetUInt<uint16_t>();
+			reader.GetUInt<uint16_t>(); // flags
+			uint64_t sequence = reader.GetUInt<uint64_t>();
+			uint64_t frameNumber = reader.GetUInt<uint64_t>();
+			reader.GetInt64();
+			reader.GetInt64();
+			uint16_t index = reader.GetUInt<uint16_t>();
+			uint16_t count = reader.GetUInt<uint16_t>();
+			if( ! reader.IsValid || magic != vdsi::udp::Magic || version != vdsi::udp::Version || count == 0 || index >= count)
+			{
+				++this->stats.datagramsInvalid;
+				return false;
+			}
+			++this->stats.datagramsReceived;
+
+			// Lost datagrams. A large step back => the sender restarted
+			if(this->HasSequence && sequence > this->nextSequence) { this->stats.datagramsLost += sequence - this->nextSequence; }
+			bool IsRestart = this->HasSequence && sequence + 1000 < this->nextSequence;
+			if( ! this->HasSequence || sequence >= this->nextSequence || IsRestart ) { this->nextSequence = sequence + 1; }
+			this->HasSequence = true;
+
+			// Late or duplicated datagrams of frames already handed out are ignored
+			//	Unless the sender restarted, or the frame numbers stepped far back (the Vicon system restarted)
+			if(IsRestart || (this->HasDelivered && frameNumber + 1000 < this->deliveredFrameNumber)) { this->HasDelivered = false; }
+			if(this->HasDelivered && frameNumber <= this->deliveredFrameNumber) { return false; }
+
+			// A newer frame abandons the pending one. Late datagrams of older frames are ignored
+			if( ! this->HasPending || frameNumber != this->pendingFrameNumber )
+			{
+				if(this->HasPending && frameNumber < this->pendingFrameNumber && ! IsRestart) { return false; }
+				if(this->HasPending && this->pendingReceived < this->pending.size()) { ++this->stats.framesIncomplete; }
+				this->HasPending = true;
+				this->pendingFrameNumber = frameNumber;
+				this->pendingReceived = 0;
+				this->pending.resize(count);
+				this->IsPendingReceived.assign(count, false);
+			}
+			if(count != this->pending.size() || this->IsPendingReceived[index]) { ++this->stats.datagramsInvalid; return false; }
+
+			this->pending[index].assign(this->buffer.begin(), this->buffer.begin() + size);
+			this->IsPendingReceived[index] = true;
+			return ++this->pendingReceived == count;
+		}
+
+		// PURPOSE: Decode the pending frame (all its datagrams have arrived)
+		// OUTPUT: false if malformed
+		bool Assemble(vdsi::Points& frame)
+		{
+			auto tReceived = vdsi::FrameTiming::Clock::now();
+			int64_t tCapturedNs = 0;
+			int64_t tSentNs = 0;
+			bool IsValid = true;
+
+			frame.BeginRefill(unsigned(this->pendingFrameNumber));
+			std::string name;
+			for(auto& datagram : this->pending)
+			{
+				vdsi::udp::Reader reader(datagram.data(), datagram.size());
+				reader.GetUInt<uint32_t>();
+				reader.GetUInt<uint16_t>();
+				uint16_t flags = reader.GetUInt<uint16_t>();
+				reader.GetUInt<uint64_t>();
+				reader.GetUInt<uint64_t>();
+				tCapturedNs = reader.GetInt64();
+				tSentNs = reader.GetInt64();
+				reader.GetUInt<uint16_t>();
+				reader.GetUInt<uint16_t>();
+				uint16_t numSubjects = reader.GetUInt<uint16_t>();
+				reader.GetUInt<uint16_t>();
+
+				bool IsDouble = (flags & vdsi::udp::Flag_DoublePrecision) != 0;
+				auto GetValue = [&] { return IsDouble ? reader.GetDouble() : reader.GetFloat(); };
+				for(uint16_t idxS = 0; idxS < numSubjects && reader.IsValid; ++idxS)
+				{
+					reader.GetName(name);
+					bool IsOccluded = reader.GetUInt<uint8_t>() != 0;
+					vdsi::RotationMatrix R = vdsi::RotationMatrix_NaN;
+					vdsi::Translation P = vdsi::Translation_NaN;
+					if( ! IsOccluded )
+					{
+						if(IsDouble)
+						{
+							for(auto& value : R) { value = reader.GetDouble(); }
+							for(auto& value : P) { value = reader.GetDouble(); }
+						}
+						else
+						{
+							for(auto& value : P) { value = reader.GetFloat(); }
+							double x = reader.GetFloat(), y = reader.GetFloat(), z = reader.GetFloat(), w = reader.GetFloat();
+							R = {
+								1 - 2*(y*y + z*z),	2*(x*y - z*w),		2*(x*z + y*w),
+								2*(x*y + z*w),		1 - 2*(x*x + z*z),	2*(y*z - x*w),
+								2*(x*z - y*w),		2*(y*z + x*w),		1 - 2*(x*x + y*y) };
+						}
+					}
+					auto& point = frame.RefillNext();
+					point.Reset(name, R, P, IsOccluded);
+
+					if( ! (flags & vdsi::udp::Flag_HasMarkers) ) { continue; }
+					uint16_t numMarkers = reader.GetUInt<uint16_t>();
+					for(uint16_t idxM = 0; idxM < numMarkers && reader.IsValid; ++idxM)
+					{
+						reader.GetName(name);
+						bool IsMarkerOccluded = reader.GetUInt<uint8_t>() != 0;
+						vdsi::Translation markerP = vdsi::Translation_NaN;
+						if( ! IsMarkerOccluded ) { for(auto& value : markerP) { value = GetValue(); } }
+						point.AddMarker(vdsi::Point_Marker(name, markerP, IsMarkerOccluded));
+					}
+				}
+				IsValid = IsValid && reader.IsValid;
+			}
+			frame.EndRefill();
+			this->HasPending = false;
+			this->HasDelivered = true;
+			this->deliveredFrameNumber = this->pendingFrameNumber;
+
+			if( ! IsValid ) { ++this->stats.datagramsInvalid; return false; }
+			++this->stats.framesReceived;
+			frame.timing.tReceived = tReceived;
+			frame.timing.tDecoded = vdsi::FrameTiming::Clock::now();
+			frame.timing.tPickup = frame.timing.tDecoded;
+			frame.timing.latencySDK = 1e-9 * double(tSentNs - tCapturedNs);
+			return true;
+		}
+	};
+}
@@ -0,0 +1,111 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Template for merging several Vicon systems into one frame (see VDS_Aggregator.h)
+	e.g. two Tracker PCs, each covering half of a long corridor
+
+	Once per second, prints:
+		Merged frames, and for each system: frames received, merges that used an old frame, skew to the reference time
+		Each object of the merged frame, and the system that saw it
+
+Sample call:
+	Without a Vicon system: two synthetic systems at 100 Hz and 200 Hz, the second placed 5 m along x
+		synthetic_subject_0 to 3 are seen by both (printed from the first), 4 and 5 by the second only
+		./vds_aggregate
+	Two Vicon systems: the second placed 5 m along x of the first
+		./vds_aggregate 192.168.11.3 192.168.12.3
+
+Inputs:
+	arg1, arg2 = host names of the Vicon systems (default: synthetic systems)
+	arg3 = duration [s] (default 10)
+
+*/
+// Program output
+#include <iostream>
+#include <iomanip>
+
+// Other
+#include <chrono> // Time keeping
+#include <string>
+#include <vector>
+
+// Brandon's VDS Interface
+#include "VDS_Aggregator.h"
+
+
+int main( int argc, char* argv[] )
+{
+	//************************************************************
+	// User Settings
+	//******************************
+	bool IsSynthetic = argc < 3;
+	double durationSeconds = (argc > 3) ? std::stod(argv[3]) : 10;
+
+	std::vector<vdsi::AggregatorSource> sources(2);
+	sources[0].label = "first";
+	sources[1].label = "second";
+	if(IsSynthetic)
+	{
+		vdsi::SyntheticSettings settings;
+		settings.numSubjects = 4;
+		sources[0].source = std::make_unique<vdsi::FrameSource_Synthetic>(settings);
+		settings.numSubjects = 6;
+		settings.frameRateHz = 200;
+		settings.seed = 2;
+		sources[1].source = std::make_unique<vdsi::FrameSource_Synthetic>(settings);
+	}
+	else
+	{
+		sources[0].hostName = argv[1];
+		sources[1].hostName = argv[2];
+	}
+
+	// Origin of the second system: 5 m along x of the first, same orientation [mm]
+	sources[1].HasTransform = true;
+	sources[1].P0 = { 5000, 0, 0 };
+
+	//************************************************************
+	// Initialise
+	//******************************
+	std::cout << "BJ: Connecting to VDS" << std::endl;
+	vdsi::VDS_Aggregator VDS;
+	VDS.Connect(std::move(sources));
+
+	//************************************************************
+	// Run
+	//******************************
+	vdsi::Points frame;
+	auto tEnd = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(durationSeconds));
+	auto tReport = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+	while(std::chrono::steady_clock::now() < tEnd)
+	{
+		VDS.GetFrame_WaitForNew(frame);
+		if(std::chrono::steady_clock::now() < tReport) { continue; }
+		tReport += std::chrono::seconds(1);
+
+		auto stats = VDS.GetStats();
+		std::cout << std::fixed << std::setprecision(1) << "merged " << stats.framesMerged << std::endl;
+		for(auto& source : stats.sources)
+		{
+			std::cout << "\t" << source.label
+				<< ": received " << source.framesReceived << ", old frame used " << source.staleMerges
+				<< ", skew p50 " << source.skew.p50 * 1e-3 << " us, p99 " << source.skew.p99 * 1e-3 << " us" << std::endl;
+		}
+		for(auto& point : frame.all)
+		{
+			std::cout << "\t\t" << point.viconObjectName << " (" << VDS.GetLabel(point.source) << ")";
+			if(point.IsOccluded) { std::cout << " occluded" << std::endl; }
+			else { std::cout << " P = " << point.x() << " " << point.y() << " " << point.z() << std::endl; }
+		}
+	}
+
+	VDS.Disconnect();
+	return 0;
+}
@@ -0,0 +1,79 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Offline tool: convert a binary recording (from vds_template_4 --Binary) to CSV
+	The CSV has the same layout as if vds_template_4 had written the CSV directly
+
+Inputs:
+	vds_bin2csv <input.vdsbin> [output.csv]
+		output defaults to the input with the extension replaced by .csv
+	vds_bin2csv <input.vdsbin> --Info
+		print the header (frame rate, objects, columns, number of rows) then exit
+
+*/
+// Program output
+#include <iostream>
+#include <fstream> // read/write to files
+
+// Other
+#include <string>
+#include <vector>
+
+// Brandon's VDS Interface
+#include "CSV_Exporter.h"
+#include "Binary_Exporter.h"
+
+
+int main( int argc, char* argv[] )
+{
+	if (argc < 2 || argc > 3)
+	{
+		std::cout << "Usage: vds_bin2csv <input.vdsbin> [output.csv | --Info]" << std::endl;
+		return 1;
+	}
+	std::string inFileName = argv[1];
+	std::string outFileName = (argc == 3) ? argv[2] : inFileName.substr(0, inFileName.find_last_of('.')) + ".csv";
+
+	binary_exporter::ImportBinary ImportBinary(inFileName);
+
+	if (outFileName == "--Info")
+	{
+		std::cout << "Frame rate [Hz]: " << ImportBinary.FrameRate() << "\n";
+		std::cout << "Objects:";
+		for (auto& name : ImportBinary.ObjectNames()) { std::cout << " " << name; }
+		std::cout << "\n";
+		std::cout << "Columns: " << ImportBinary.ColumnNames().size() << "\n";
+		std::cout << "Rows: " << ImportBinary.NumRows() << std::endl;
+		return 0;
+	}
+
+	std::ofstream outData(outFileName);
+	if (!outData)
+	{
+		std::cout << "ERROR: Could not open " << outFileName << std::endl;
+		return 1;
+	}
+
+	// Convert in blocks, to bound memory use for long recordings
+	constexpr uint64_t rowsPerBlock = 10000;
+	csv_exporter::ExportCSV ExportCSV(rowsPerBlock);
+	ExportCSV.AddHeader(ImportBinary.ColumnNames());
+
+	std::vector<double> row;
+	for (uint64_t idxRow = 0; idxRow < ImportBinary.NumRows(); idxRow++)
+	{
+		ImportBinary.ReadRow(idxRow, row);
+		ExportCSV.AddRow(row);
+		if ((idxRow+1) % rowsPerBlock == 0) { ExportCSV.PrintAll_clear(outData); }
+	}
+	ExportCSV.PrintAll_clear(outData);
+
+	std::cout << "Wrote " << ImportBinary.NumRows() << " rows to " << outFileName << std::endl;
+	return 0;
+}
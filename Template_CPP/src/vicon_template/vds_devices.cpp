@@ -0,0 +1,152 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Template for recording device channels (force plates, analog inputs) and unlabeled markers (see VDS_Devices.h)
+	Every frame is taken from the queue (GetDeviceFrames) and written as binary:
+		<prefix>_<device name>.vdsbin = one row per subsample: frameNumber, subsample, each channel
+		<prefix>_unlabeled.vdsbin = one row per marker: frameNumber, id, x, y, z
+	Convert to CSV with vds_bin2csv
+
+	Once per second, prints: frames recorded, rows written, frames dropped by the queue
+
+Sample call:
+	Without a Vicon system: 4 synthetic force plates (6 channels, 10 subsamples per frame) and 200 unlabeled markers at 100 Hz
+		./vds_devices
+	Vicon system
+		./vds_devices 192.168.11.3 tmp 60
+
+Inputs:
+	arg1 = host name of the Vicon system (default: synthetic devices)
+	arg2 = prefix of the output files (default "tmp")
+	arg3 = duration [s] (default 10)
+
+*/
+// Program output
+#include <iostream>
+
+// Other
+#include <chrono> // Time keeping
+#include <memory>
+#include <string>
+#include <vector>
+
+// Brandon's VDS Interface
+#include "VDS_Interface.h"
+#include "Binary_Exporter.h"
+
+
+int main( int argc, char* argv[] )
+{
+	//************************************************************
+	// User Settings
+	//******************************
+	bool IsSynthetic = argc < 2;
+	std::string prefix = (argc > 2) ? argv[2] : "tmp";
+	double durationSeconds = (argc > 3) ? std::stod(argv[3]) : 10;
+
+	//************************************************************
+	// Initialise
+	//******************************
+	std::cout << "BJ: Connecting to VDS" << std::endl;
+	vdsi::VDS_Interface VDS;
+	VDS.SetWaitPolicy(vdsi::WaitPolicy::Block, std::chrono::seconds(1));
+	VDS.EnableDeviceData();
+	if(IsSynthetic)
+	{
+		vdsi::SyntheticSettings synthetic;
+		synthetic.numSubjects = 1;
+		synthetic.numDevices = 4;
+		synthetic.deviceChannels = 6;
+		synthetic.deviceSubsamples = 10;
+		synthetic.numUnlabeled = 200;
+		VDS.Connect(std::make_unique<vdsi::FrameSource_Synthetic>(synthetic));
+	}
+	else { VDS.Connect(argv[1]); }
+
+	// Files are opened on the first frame with devices, once the devices are known
+	//	The Vicon PC only sends the devices a few frames after they are enabled
+	std::shared_ptr<const vdsi::DeviceLayout> layout;
+	std::vector<std::unique_ptr<binary_exporter::ExportBinary>> deviceFiles;
+	binary_exporter::ExportBinary unlabeledFile(prefix + "_unlabeled.vdsbin");
+	unlabeledFile.AddHeader(vdsi::DeviceRowWriter::UnlabeledColumnNames(), VDS.GetFrameRate(), {});
+
+	//************************************************************
+	// Run
+	//******************************
+	std::vector<vdsi::DeviceFrame> frames;
+	std::vector<double> rows;
+	uint64_t framesRecorded = 0;
+	uint64_t rowsWritten = 0;
+	unsigned int frameNumberStart = 0;
+	bool IsFirstFrame = true;
+
+	auto tEnd = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(durationSeconds));
+	auto tReport = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+	// No devices by then => record the unlabeled markers only
+	auto tDeviceWait = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+	while(std::chrono::steady_clock::now() < tEnd)
+	{
+		size_t numFrames = VDS.GetDeviceFrames(frames);
+		for(size_t idxFrame = 0; idxFrame < numFrames; ++idxFrame)
+		{
+			const vdsi::DeviceFrame& frame = frames[idxFrame];
+			if(IsFirstFrame)
+			{
+				if(frame.NumDevices() == 0 && std::chrono::steady_clock::now() < tDeviceWait) { continue; }
+				if(frame.NumDevices() == 0) { std::cout << "WARNING_VDS: No devices. Recording unlabeled markers only" << std::endl; }
+				IsFirstFrame = false;
+				frameNumberStart = frame.frameNumber;
+				layout = frame.layout;
+				for(size_t idxDevice = 0; idxDevice < frame.NumDevices(); ++idxDevice)
+				{
+					auto& device = frame.Device(idxDevice);
+					deviceFiles.push_back(std::make_unique<binary_exporter::ExportBinary>(prefix + "_" + device.name + ".vdsbin"));
+					deviceFiles.back()->AddHeader(vdsi::DeviceRowWriter::DeviceColumnNames(device), VDS.GetFrameRate(), { device.name });
+				}
+			}
+			double frameNumber = double(frame.frameNumber - frameNumberStart + 1);
+
+			// Devices: a block of rows per device, written at once
+			//	The files have the columns of the first frame => stop recording devices if they change
+			if(frame.layout == layout)
+			{
+				for(size_t idxDevice = 0; idxDevice < frame.NumDevices(); ++idxDevice)
+				{
+					size_t numRows = vdsi::DeviceRowWriter::WriteDevice(frame, idxDevice, frameNumber, rows);
+					deviceFiles[idxDevice]->AddRows(rows.data(), numRows, 2 + frame.Device(idxDevice).NumChannels());
+					rowsWritten += numRows;
+				}
+			}
+			else if(layout)
+			{
+				std::cout << "WARNING_VDS: Devices changed. Recording of devices stopped" << std::endl;
+				layout.reset();
+			}
+
+			// Unlabeled markers
+			size_t numRows = vdsi::DeviceRowWriter::WriteUnlabeled(frame, frameNumber, rows);
+			unlabeledFile.AddRows(rows.data(), numRows, 5);
+			rowsWritten += numRows;
+			framesRecorded++;
+		}
+
+		if(std::chrono::steady_clock::now() < tReport) { continue; }
+		tReport += std::chrono::seconds(1);
+		auto stats = VDS.GetDeviceQueueStats();
+		std::cout << "frames " << framesRecorded << ", rows " << rowsWritten << ", dropped " << stats.overruns << ", max queued " << stats.maxOccupancy << std::endl;
+	}
+
+	VDS.Disconnect();
+
+	// Close explicitly, to stop with an error if the end of a recording could not be written
+	for(auto& deviceFile : deviceFiles) { deviceFile->Close(); }
+	unlabeledFile.Close();
+	return 0;
+}
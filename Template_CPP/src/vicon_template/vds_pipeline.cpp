@@ -0,0 +1,137 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Template for processing each frame in pipeline mode (see VDS_Interface::EnablePipeline, VDS_Pipeline.h)
+	Two stages, each on its own thread:
+		smooth = exponential smoothing of the position of each object (per object work, split over worker threads)
+		lab = move the positions into another frame (here: the lab origin is 1 m above the Vicon origin)
+
+	Once per second, prints:
+		For each stage: frames processed and dropped, time queued and time in the stage
+		Pose of the first object
+
+Sample call:
+	Without a Vicon system: 500 synthetic objects at 200 Hz, 2 worker threads
+		./vds_pipeline
+	Vicon system
+		./vds_pipeline 192.168.11.3 2
+
+Inputs:
+	arg1 = host name of the Vicon system (default: synthetic objects)
+	arg2 = number of worker threads (default 2)
+	arg3 = duration [s] (default 10)
+
+*/
+// Program output
+#include <iostream>
+#include <iomanip>
+
+// Other
+#include <chrono> // Time keeping
+#include <string>
+#include <vector>
+
+// Brandon's VDS Interface
+#include "VDS_Interface.h"
+
+
+int main( int argc, char* argv[] )
+{
+	//************************************************************
+	// User Settings
+	//******************************
+	bool IsSynthetic = argc < 2;
+	size_t numWorkers = (argc > 2) ? std::stoul(argv[2]) : 2;
+	double durationSeconds = (argc > 3) ? std::stod(argv[3]) : 10;
+
+	// Weight of the newest position in the smoothed position
+	constexpr double alpha = 0.2;
+
+	//************************************************************
+	// Stages
+	//******************************
+	// Smoothed position of each object, indexed by handle id
+	//	Resized by perFrame (one thread), then each perSubject call touches only its own object
+	std::vector<vdsi::Translation> smoothed;
+
+	vdsi::PipelineStage smooth;
+	smooth.name = "smooth";
+	smooth.perFrame = [&smoothed](vdsi::Points& frame) {
+		for(auto& point : frame.all)
+		{
+			if(point.handle.id >= smoothed.size()) { smoothed.resize(point.handle.id + 1, vdsi::Translation_NaN); }
+		}
+	};
+	smooth.perSubject = [&smoothed](vdsi::Point_Object& point) {
+		if(point.IsOccluded) { return; }
+		auto& P = smoothed[point.handle.id];
+		for(int idx = 0; idx < 3; ++idx)
+		{
+			P[idx] = std::isnan(P[idx]) ? point.P[idx] : alpha*point.P[idx] + (1 - alpha)*P[idx];
+			point.P[idx] = P[idx];
+		}
+	};
+
+	vdsi::PipelineStage lab;
+	lab.name = "lab";
+	lab.perSubject = [](vdsi::Point_Object& point) {
+		point.P[2] -= 1000;
+		for(auto& marker : point.markers) { marker.P[2] -= 1000; }
+	};
+
+	vdsi::PipelineSettings settings;
+	settings.numWorkers = numWorkers;
+
+	//************************************************************
+	// Initialise
+	//******************************
+	std::cout << "BJ: Connecting to VDS" << std::endl;
+	vdsi::VDS_Interface VDS;
+	VDS.EnablePipeline({ smooth, lab }, settings);
+	VDS.SetWaitPolicy(vdsi::WaitPolicy::Block, std::chrono::seconds(1));
+	if(IsSynthetic)
+	{
+		vdsi::SyntheticSettings synthetic;
+		synthetic.numSubjects = 500;
+		synthetic.frameRateHz = 200;
+		VDS.Connect(std::make_unique<vdsi::FrameSource_Synthetic>(synthetic));
+	}
+	else { VDS.Connect(argv[1]); }
+
+	//************************************************************
+	// Run
+	//******************************
+	vdsi::Points frame;
+	auto tEnd = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(durationSeconds));
+	auto tReport = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+	while(std::chrono::steady_clock::now() < tEnd)
+	{
+		VDS.GetFrame_WaitForNew(frame);
+		if(std::chrono::steady_clock::now() < tReport) { continue; }
+		tReport += std::chrono::seconds(1);
+
+		std::cout << std::fixed << std::setprecision(1) << "frame " << frame.frameNumber << ", decode p50 " << VDS.GetStats().decode.p50 * 1e-3 << " us" << std::endl;
+		for(auto& stage : VDS.GetPipelineStats())
+		{
+			std::cout << "\t" << std::setw(8) << std::left << stage.name << std::right
+				<< " processed " << stage.framesProcessed << ", dropped " << stage.framesDropped
+				<< ", queued p50 " << stage.wait.p50 * 1e-3 << " us"
+				<< ", stage p50 " << stage.process.p50 * 1e-3 << " us, p99 " << stage.process.p99 * 1e-3 << " us" << std::endl;
+		}
+		if( ! frame.all.empty() )
+		{
+			auto& point = frame.all.front();
+			std::cout << "\t" << point.viconObjectName << " P = " << point.x() << " " << point.y() << " " << point.z() << std::endl;
+		}
+	}
+
+	VDS.Disconnect();
+	return 0;
+}
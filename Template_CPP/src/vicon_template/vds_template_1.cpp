@@ -74,6 +74,7 @@ int main( int argc, char* argv[] )
 	VDS.EnableObjectFilter(AllowedObjectsList);
 	// VDS.DisableObjectFilter();
 	VDS.EnableOccludedFilter();
+	// VDS.SetWaitPolicy(vdsi::WaitPolicy::Block); // Wait without using CPU (See vds_benchmark_wait)
 
 	//************************************************************
 	// Run
@@ -1,7 +1,7 @@
 /*
 Written by:			Brandon Johns
 Version created:	2022-07-26
-Last edited:		2022-07-26
+Last edited:		2026-10-17
 
 Version changes:
 	NA
@@ -11,9 +11,14 @@ Purpose:
 	This version is intended to be run from command line with arguments to specify run conditions
 
 	Features:
-		prints data to command line or CSV
+		prints data to command line or CSV (from a background thread, so slow disk writes do not stall collection)
 		stores marker data
 		variable duration & can be terminated at will
+		records every frame (lossless queue), and reports if any were missed
+		optional binary output for long recordings (convert to CSV with vds_bin2csv)
+		can run without a Vicon system, on synthetic frames or a replayed recording
+		can share the frames with other local processes (read them with vds_shm_reader)
+		can re-broadcast the frames to other computers over UDP (receive them with vds_udp_receiver)
 
 Inputs:
 	Run with command line argument --Help
@@ -23,6 +28,11 @@ Sample call:
 	.\vds_template_4 --Objects Jackal bj_ctrl --SaveMarkerLocations
 	.\vds_template_4 --Objects Jackal bj_ctrl --DurationSeconds 10
 	.\vds_template_4 --FileName tmp --Objects Jackal bj_ctrl --DurationSeconds 10  --SaveMarkerLocations
+	.\vds_template_4 --FileName tmp --Binary --Objects Jackal bj_ctrl --DurationSeconds $(60*60)
+	.\vds_template_4 --FileName tmp2 --Replay tmp.vdsbin 10 --DurationSeconds 60
+	.\vds_template_4 --FileName tmp --Binary --Synthetic 500 4 2000 0.01 --DurationSeconds 10
+	./vds_template_4 --Objects Jackal bj_ctrl --SharedMemory /vds_frames --DurationSeconds 60
+	.\vds_template_4 --Objects Jackal bj_ctrl --UdpRelay 239.255.80.1 51001 --DurationSeconds 600
 
 	Using arithmetic in powershell to specify time in min
 		.\vds_template_4 --Objects Jackal bj_ctrl --DurationSeconds $(10*60)
@@ -36,6 +46,7 @@ Sample call:
 #include <chrono> // Time keeping
 #include <thread> // For sleep
 #include <vector>
+#include <memory>
 
 // Interrupt handling for program termination
 #include <cstdlib>
@@ -44,6 +55,7 @@ Sample call:
 // Brandon's VDS Interface
 #include "VDS_Interface.h"
 #include "CSV_Exporter.h"
+#include "Binary_Exporter.h"
 
 
 namespace Kill
@@ -121,16 +133,24 @@ int main( int argc, char* argv[] )
 	// Output destination
 	std::ostream* outData;
 	outData = &std::cout; // (Default) Print to terminal
+	std::string fileName;
+	bool saveBinary = false;
 
 	// Network addresses of the computer running Vicon Tracker 3
 	std::string vds_HostName = "192.168.11.3";
 
+	// Stand-in for the Vicon system (see --Synthetic, --Replay)
+	std::unique_ptr<vdsi::FrameSource> frameSource;
+	std::vector<std::string> sourceObjectsList;
+
 	// List all the objects to be allowed through filtering
 	// Prevents ghosts of other peoples objects from interfering with the output
 	std::vector<std::string> AllowedObjectsList;
 
 	// (See description in arguments)
 	bool saveMarkerLocations = false;
+	std::string sharedMemoryName;
+	std::unique_ptr<vdsi::UdpRelaySettings> udpRelaySettings;
 
 	//************************************************************
 	// Parse Command Line Arguments
@@ -150,12 +170,30 @@ int main( int argc, char* argv[] )
 				"--FileName\n"
 				"    Filename to direct to output to. Without extension or path\n"
 				"    Default: Print to terminal\n"
+				"--Binary\n"
+				"    Write FileName.vdsbin instead of a CSV. Requires --FileName\n"
+				"    Faster and smaller for long recordings. Convert to CSV with vds_bin2csv\n"
+				"    Default: (CSV)\n"
 				"--HostName\n"
 				"    IP address or hostname of computer running Vicon Tracker\n"
 				"    Default: "+vds_HostName+"\n"
 				"--Objects\n"
 				"    Space separated list of vicon objects\n"
-				"    Default: (empty)\n"
+				"    Default: (empty), or all objects of --Synthetic or --Replay\n"
+				"--Synthetic <subjects> <markers> <rateHz> <occlusionRate>\n"
+				"    Use generated frames instead of a Vicon system (e.g. load tests)\n"
+				"    Objects are named synthetic_subject_0, synthetic_subject_1, ...\n"
+				"--Replay <fileName.vdsbin> <speed>\n"
+				"    Use a binary recording instead of a Vicon system\n"
+				"    speed: 1 = real time, 10 = ten times faster, 0 = as fast as possible\n"
+				"--SharedMemory <name>\n"
+				"    Also publish each frame to POSIX shared memory (e.g. /vds_frames), for other processes\n"
+				"    Read it with vds_shm_reader <name>\n"
+				"    Default: (not published)\n"
+				"--UdpRelay <address> <port>\n"
+				"    Also re-broadcast each frame over UDP, to a multicast group (e.g. 239.255.80.1) or one computer\n"
+				"    Receive with vds_udp_receiver <address> <port>\n"
+				"    Default: (not sent)\n"
 				"--SaveMarkerLocations\n"
 				"    Marker positions are exported in addition to object pose\n"
 				"    Default: (does no save marker locations)\n"
@@ -172,8 +210,15 @@ int main( int argc, char* argv[] )
 			auto parsedArgsOfFlag = ParseArgsOfFlag(argsOfFlag, [&](size_t numArgs) {return numArgs == 1; });
 			argsOfFlag.clear();
 
-			// Print to this File
-			outData = new std::ofstream(parsedArgsOfFlag.front() + ".csv" );
+			// Print to this File (opened after all arguments are parsed)
+			fileName = parsedArgsOfFlag.front();
+		}
+		else if (IsFlag(argsOfFlag, "--Binary"))
+		{
+			auto parsedArgsOfFlag = ParseArgsOfFlag(argsOfFlag, [&](size_t numArgs) {return numArgs == 0; });
+			argsOfFlag.clear();
+
+			saveBinary = true;
 		}
 		else if ( IsFlag(argsOfFlag, "--HostName") )
 		{
@@ -182,6 +227,29 @@ int main( int argc, char* argv[] )
 
 			vds_HostName = parsedArgsOfFlag.front();
 		}
+		else if (IsFlag(argsOfFlag, "--Synthetic"))
+		{
+			auto parsedArgsOfFlag = ParseArgsOfFlag(argsOfFlag, [&](size_t numArgs) {return numArgs == 4; });
+			argsOfFlag.clear();
+
+			vdsi::SyntheticSettings settings;
+			settings.numSubjects = std::stoul(parsedArgsOfFlag[0]);
+			settings.numMarkers = std::stoul(parsedArgsOfFlag[1]);
+			settings.frameRateHz = std::stod(parsedArgsOfFlag[2]);
+			settings.occlusionRate = std::stod(parsedArgsOfFlag[3]);
+			frameSource = std::make_unique<vdsi::FrameSource_Synthetic>(settings);
+
+			sourceObjectsList.clear();
+			for (unsigned int idx = 0; idx < settings.numSubjects; idx++) { sourceObjectsList.push_back("synthetic_subject_" + std::to_string(idx)); }
+		}
+		else if (IsFlag(argsOfFlag, "--Replay"))
+		{
+			auto parsedArgsOfFlag = ParseArgsOfFlag(argsOfFlag, [&](size_t numArgs) {return numArgs == 2; });
+			argsOfFlag.clear();
+
+			frameSource = std::make_unique<vdsi::FrameSource_Replay>(parsedArgsOfFlag[0], std::stod(parsedArgsOfFlag[1]));
+			sourceObjectsList = binary_exporter::ImportBinary(parsedArgsOfFlag[0]).ObjectNames();
+		}
 		else if (IsFlag(argsOfFlag, "--Objects"))
 		{
 			auto parsedArgsOfFlag = ParseArgsOfFlag(argsOfFlag, [&](size_t numArgs) {return numArgs > 0; });
@@ -189,6 +257,22 @@ int main( int argc, char* argv[] )
 
 			AllowedObjectsList = parsedArgsOfFlag;
 		}
+		else if (IsFlag(argsOfFlag, "--SharedMemory"))
+		{
+			auto parsedArgsOfFlag = ParseArgsOfFlag(argsOfFlag, [&](size_t numArgs) {return numArgs == 1; });
+			argsOfFlag.clear();
+
+			sharedMemoryName = parsedArgsOfFlag.front();
+		}
+		else if (IsFlag(argsOfFlag, "--UdpRelay"))
+		{
+			auto parsedArgsOfFlag = ParseArgsOfFlag(argsOfFlag, [&](size_t numArgs) {return numArgs == 2; });
+			argsOfFlag.clear();
+
+			udpRelaySettings = std::make_unique<vdsi::UdpRelaySettings>();
+			udpRelaySettings->address = parsedArgsOfFlag[0];
+			udpRelaySettings->port = uint16_t(std::stoul(parsedArgsOfFlag[1]));
+		}
 		else if (IsFlag(argsOfFlag, "--SaveMarkerLocations"))
 		{
 			auto parsedArgsOfFlag = ParseArgsOfFlag(argsOfFlag, [&](size_t numArgs) {return numArgs == 0; });
@@ -216,18 +300,52 @@ int main( int argc, char* argv[] )
 		}
 	}
 
+	if (saveBinary && fileName.empty())
+	{
+		std::cout << "ERROR: (Bad Input) --Binary requires --FileName" << std::endl;
+		throw(std::invalid_argument("ERROR: (Bad Input) --Binary requires --FileName"));
+	}
+	if (!saveBinary && !fileName.empty())
+	{
+		outData = new std::ofstream(fileName + ".csv");
+	}
+
 	//************************************************************
 	// Initialise
 	//******************************
 	// Start to VDS
 	std::cout << "BJ: Connecting to VDS" << std::endl;
 	vdsi::VDS_Interface VDS;
-	VDS.Connect(vds_HostName);
+	if (frameSource && AllowedObjectsList.empty()) { AllowedObjectsList = sourceObjectsList; }
 
 	// For exporting to CSV, it is important to always have the same number of objects captured
 	//	=> Must use the filter & must print occluded objects
+	// Set before connecting, so that every queued frame has the same columns
 	VDS.EnableObjectFilter(AllowedObjectsList);
 	VDS.DisableOccludedFilter();
+
+	// Lossless mode: queue every frame
+	//	Writing to the file can occasionally take longer than one Vicon frame
+	//	Without the queue, frames arriving during that time would be missing from the CSV
+	//	Enabled before connecting, so that the first frames of --Replay are kept
+	//	Capacity: the consumer may fall behind by this many frames before frames are dropped
+	VDS.EnableFrameQueue(1000);
+
+	if (frameSource) { VDS.Connect(std::move(frameSource)); }
+	else             { VDS.Connect(vds_HostName); }
+
+	if (!sharedMemoryName.empty())
+	{
+		vdsi::ShmSettings shmSettings;
+		shmSettings.name = sharedMemoryName;
+		shmSettings.maxSubjects = std::max(shmSettings.maxSubjects, uint32_t(AllowedObjectsList.size()));
+		VDS.EnableSharedMemory(shmSettings);
+	}
+	if (udpRelaySettings)
+	{
+		udpRelaySettings->IncludeMarkers = saveMarkerLocations;
+		VDS.EnableUdpRelay(*udpRelaySettings);
+	}
 	auto points = VDS.GetFrame();
 
 	// The input estimate number of rows is not strict, you can go over, but performance will suffer
@@ -260,7 +378,25 @@ int main( int argc, char* argv[] )
 			}
 		}
 	}
-	ExportCSV.AddHeader(HeaderBuilder.Row);
+	// Binary output: rows are written straight to the file as they are added
+	std::unique_ptr<binary_exporter::ExportBinary> ExportBinary;
+	if (saveBinary)
+	{
+		ExportBinary = std::make_unique<binary_exporter::ExportBinary>(fileName + ".vdsbin");
+		ExportBinary->AddHeader(HeaderBuilder.Row, VDS.GetFrameRate(), AllowedObjectsList);
+	}
+	else
+	{
+		ExportCSV.AddHeader(HeaderBuilder.Row);
+
+		// Print to the file from a background thread
+		//	A slow write to disk then does not hold up collecting frames
+		//	Block: if the writer falls far behind, wait rather than lose rows (the frame queue absorbs the wait)
+		csv_exporter::AsyncWriterSettings writerSettings;
+		writerSettings.flushPolicy = csv_exporter::FlushPolicy::Interval;
+		writerSettings.backlogPolicy = csv_exporter::BacklogPolicy::Block;
+		ExportCSV.EnableAsyncWriter(*outData, writerSettings);
+	}
 
 	// Duration of trial, in frame count
 	uint32_t durationFrames = uint32_t( durationSeconds * VDS.GetFrameRate() );
@@ -271,46 +407,95 @@ int main( int argc, char* argv[] )
 	unsigned int frameNumberStart = 0;
 	bool IsFirstLoop = true;
 
+	std::vector<vdsi::Points> frames;
+
+	// Sleep while waiting for frames (the queue holds any that arrive meanwhile, so nothing is lost to the wake-up latency)
+	// Wait at most 1 s, so that CTRL+C is checked even if frames stop
+	VDS.SetWaitPolicy(vdsi::WaitPolicy::Block, std::chrono::seconds(1));
+
 	Kill::ProgramTerminationEnable();
-	for( uint32_t idx=0; idx<durationFrames; idx++ )
+	uint32_t idx = 0;
+	while( idx<durationFrames )
 	{
 		// Safely terminate program if CTRL+C
 		if (Kill::Flag_TerminateProgramCalled) { break; }
 
-		// Get new data frame from VDS
+		// Get all new data frames from VDS since the last loop
 		// Re-encode data into Brandon's custom Points object
-		auto points = VDS.GetFrame_GetUnread();
+		size_t numFrames = VDS.GetFrames(frames, durationFrames - idx);
 
-		// Encode the next row of the CSV
-		//	The order will match the order in AllowedObjectsList
-		csv_exporter::Export_CSV_RowBuilder<double> RowBuilder;
+		// End of --Replay (all queued frames taken)
+		if (numFrames == 0 && VDS.IsEndOfStream()) { break; }
 
-		// Offset frameNumber to start at 1
-		if (IsFirstLoop) { IsFirstLoop=false; frameNumberStart = points.frameNumber; }
-		RowBuilder.AddData( double(points.frameNumber - frameNumberStart + 1) );
-
-		// Write data
-		for(auto& point : points.all)
+		for( size_t idxFrame=0; idxFrame<numFrames; idxFrame++, idx++ )
 		{
-			RowBuilder.AddData(point.R_rowMajor);
-			RowBuilder.AddData(point.P);
+			auto& points = frames[idxFrame];
+
+			// Encode the next row of the CSV
+			//	The order will match the order in AllowedObjectsList
+			csv_exporter::Export_CSV_RowBuilder<double> RowBuilder;
+
+			// Offset frameNumber to start at 1
+			if (IsFirstLoop) { IsFirstLoop=false; frameNumberStart = points.frameNumber; }
+			RowBuilder.AddData( double(points.frameNumber - frameNumberStart + 1) );
 
-			if (saveMarkerLocations) {
-				for (auto& marker : point.markers)
-				{
-					RowBuilder.AddData(marker.P);
+			// Write data
+			for(auto& point : points.all)
+			{
+				RowBuilder.AddData(point.R_rowMajor);
+				RowBuilder.AddData(point.P);
+
+				if (saveMarkerLocations) {
+					for (auto& marker : point.markers)
+					{
+						RowBuilder.AddData(marker.P);
+					}
 				}
 			}
+			// Printed to the file incrementally, by the writer thread
+			if (ExportBinary) { ExportBinary->AddRow(RowBuilder.Row); }
+			else              { ExportCSV.AddRow(RowBuilder.Row); }
 		}
-		ExportCSV.AddRow(RowBuilder.Row);
+	}
+	if (ExportBinary) { ExportBinary->Close(); }
+	else              { ExportCSV.DisableAsyncWriter(); } // Prints remaining rows and flushes
 
-		// Print data into a file
-		// Print incrementally, during the loop
-		ExportCSV.PrintAll_clear(*outData);
+	// Report if the CSV has gaps
+	auto writerStats = ExportCSV.GetAsyncWriterStats();
+	if (writerStats.timesBlocked > 0)
+	{
+		std::cout << "WARNING: Writing to the file fell behind " << writerStats.timesBlocked << " times" << std::endl;
+	}
+	auto queueStats = VDS.GetQueueStats();
+	if (queueStats.overruns > 0 || queueStats.frameNumberGaps > 0)
+	{
+		std::cout
+			<< "WARNING: The CSV is missing frames."
+			<< " Dropped by full queue: " << queueStats.overruns
+			<< ", never received from Vicon: " << queueStats.frameNumberGaps
+			<< std::endl;
 	}
 
 	std::cout << "Finished" << std::endl;
 
+	// Check that the cached scene layout was rarely rebuilt
+	auto decodeStats = VDS.GetDecodeStats();
+	std::cout
+		<< "Frames decoded: " << decodeStats.framesDecoded
+		<< ", scene layout rebuilds: " << decodeStats.schemaRebuilds
+		<< ", decode time saved per frame [ns]: " << decodeStats.savedNsPerFrame
+		<< std::endl;
+
+	// Where the time went between the cameras and this program (recent frames)
+	auto frameStats = VDS.GetStats();
+	std::cout
+		<< "Latency [ms] (p50/p99/max):"
+		<< " Vicon " << frameStats.latencySDK.p50/1e6 << "/" << frameStats.latencySDK.p99/1e6 << "/" << frameStats.latencySDK.max/1e6
+		<< ", decode " << frameStats.decode.p50/1e6 << "/" << frameStats.decode.p99/1e6 << "/" << frameStats.decode.max/1e6
+		<< ", camera to program " << frameStats.endToEnd.p50/1e6 << "/" << frameStats.endToEnd.p99/1e6 << "/" << frameStats.endToEnd.max/1e6
+		<< ", frame rate jitter " << frameStats.jitter/1e6
+		<< std::endl;
+
 	VDS.Disconnect();
 	return 0;
 }
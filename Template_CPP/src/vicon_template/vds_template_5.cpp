@@ -0,0 +1,97 @@
+/*
+Written by:			Brandon Johns
+Version created:	2026-10-17
+Last edited:		2026-10-17
+
+Version changes:
+	NA
+
+Purpose:
+	Template for using Vicon DataStream (VDS)
+	This version lists the objects when compiling (see VDS_Fixed.h)
+		Objects are accessed by frame.get<"name">(): an array index, checked by the compiler
+		The CSV row has a fixed number of columns, filled without looking up any names
+
+	Saves 10 frames into a CSV, printed to the terminal, and prints the position of one object
+
+*/
+// Program output
+#include <iostream>
+#include <fstream> // read/write to files
+
+// Other
+#include <chrono> // Time keeping
+#include <thread> // For sleep
+
+// Brandon's VDS Interface
+#include "VDS_Fixed.h"
+#include "CSV_Exporter.h"
+
+
+namespace
+{
+	// Vicon object names
+	// (add all your objects)
+	using MyVDS = vdsi::VDS_Fixed<"Jackal", "bj_ctrl", "someOtherObject">;
+	using MyRowWriter = vdsi::FixedRowWriter<MyVDS::Frame>;
+}
+
+
+int main( int argc, char* argv[] )
+{
+	//************************************************************
+	// User Settings - General
+	//******************************
+	// Output destination
+	std::ostream* outData;
+	outData = &std::cout; // Print to terminal
+	//outData = new std::ofstream("out.txt"); // Print to File
+
+	//************************************************************
+	// User Settings - VDS
+	//******************************
+	// Network addresses of the computer running Vicon Tracker 3
+	constexpr auto vds_HostName = "192.168.11.3";
+
+	//************************************************************
+	// Initialise
+	//******************************
+	// Start to VDS
+	//	Only the listed objects are decoded. Occluded objects are kept (every frame has all of them)
+	std::cout << "BJ: Connecting to VDS" << std::endl;
+	MyVDS VDS;
+	VDS.Connect(vds_HostName);
+
+	// The column count is known when compiling
+	csv_exporter::ExportCSV ExportCSV(10);
+	ExportCSV.AddHeader(MyRowWriter::ColumnNames());
+
+	//************************************************************
+	// Run
+	//******************************
+	MyVDS::Frame frame;
+	MyRowWriter::Row row;
+	unsigned int frameNumberStart = 0;
+	bool IsFirstLoop = true;
+
+	for( uint64_t idx=0; idx<10; idx++ )
+	{
+		// Get new data frame from VDS
+		VDS.GetFrame_WaitForNew(frame);
+
+		// Offset frameNumber to start at 1
+		if (IsFirstLoop) { IsFirstLoop=false; frameNumberStart = frame.frameNumber; }
+		MyRowWriter::Write(frame, double(frame.frameNumber - frameNumberStart + 1), row);
+		ExportCSV.AddRow(row);
+
+		// A misspelt name here would not compile
+		auto& jackal = frame.get<"Jackal">();
+		std::cout << "Jackal " << ( jackal.IsOccluded ? "occluded" : "at" ) << " (" << jackal.x() << "," << jackal.y() << "," << jackal.z() << ")" << std::endl;
+	}
+
+	// Print data into a file
+	ExportCSV.PrintAll(*outData);
+
+	VDS.Disconnect();
+	return 0;
+}